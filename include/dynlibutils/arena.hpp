@@ -0,0 +1,93 @@
+//
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+//
+
+#ifndef DYNLIBUTILS_ARENA_HPP
+#define DYNLIBUTILS_ARENA_HPP
+#pragma once
+
+#include "memaddr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DynLibUtils {
+
+class CModule;
+
+// A block of executable memory.
+struct CodeBlock_t
+{
+	CMemory m_pCode;          // Executable view.
+	CMemory m_pWritable;      // Writable view (the executable one unless the chunk is double-mapped).
+	std::size_t m_nSize = 0;
+
+	bool IsValid() const noexcept { return m_pCode.IsValid(); }
+	bool IsDoubleMapped() const noexcept { return m_pWritable != m_pCode; }
+};
+
+// An allocator of small executable blocks (trampolines, thunks, relocated code).
+//
+// Memory is reserved in 64 KiB chunks placed in free gaps of the address space within ±2 GB of
+// the requested code (found through /proc/self/maps on Linux, VirtualQuery on Windows and
+// mach_vm_region on macOS), so the blocks can be reached with a `rel32` jump. Blocks are
+// cache-line aligned and recycled through a per-chunk free list.
+//
+// With double mapping (Linux), a chunk is a memfd mapped twice: read-execute where the code runs
+// and read-write elsewhere, so no page is ever writable and executable at once (W^X). Without it,
+// the chunk is read-execute and Write() briefly unprotects the written pages.
+class CCodeArena final
+{
+public:
+	static constexpr std::size_t sm_nBlockAlign = 64;
+	static constexpr std::size_t sm_nChunkSize = 64 * 1024;
+
+	explicit CCodeArena(bool bDoubleMapping = true) : m_bDoubleMapping(bDoubleMapping) {}
+	~CCodeArena();
+
+	CCodeArena(const CCodeArena&) = delete;
+	CCodeArena& operator=(const CCodeArena&) = delete;
+
+	// The process-wide arena. It is never destroyed: hooks may still run and be removed by static destructors.
+	static CCodeArena& Get() { static CCodeArena* s_pArena = new CCodeArena(); return *s_pArena; }
+
+	// Allocates a block within rel32 reach of pNear (anywhere if pNear is null).
+	// Returns an invalid block if there is no room near it.
+	CodeBlock_t Allocate(std::size_t nSize, CMemory pNear = nullptr);
+
+	// Allocates a block within rel32 reach of the whole module.
+	CodeBlock_t Allocate(std::size_t nSize, const CModule& module);
+
+	// Copies code into a block and flushes the instruction cache.
+	void Write(const CodeBlock_t& block, const void* pData, std::size_t nLength, std::size_t nOffset = 0);
+
+	void Free(const CodeBlock_t& block);
+
+private:
+	struct Chunk_t
+	{
+		std::uintptr_t m_pCode;
+		std::uintptr_t m_pWritable;
+		std::size_t m_nSize;
+		std::map<std::size_t, std::size_t> m_mapFree; // Offset -> size of free ranges.
+	};
+
+	CodeBlock_t Allocate(std::size_t nSize, std::uintptr_t pLow, std::uintptr_t pHigh);
+	static bool AllocateFrom(Chunk_t& chunk, std::size_t nSize, CodeBlock_t& block);
+	std::unique_ptr<Chunk_t> MapChunk(std::size_t nSize, std::uintptr_t pLow, std::uintptr_t pHigh) const;
+	static void UnmapChunk(const Chunk_t& chunk);
+
+	std::mutex m_mutex;
+	std::vector<std::unique_ptr<Chunk_t>> m_vecChunks;
+	bool m_bDoubleMapping;
+}; // class CCodeArena
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_ARENA_HPP
@@ -0,0 +1,519 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_DECODER_HPP
+#define DYNLIBUTILS_DECODER_HPP
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace DynLibUtils {
+
+//=============================================================================
+// x86-64 instruction length decoder
+//
+// Decodes the layout of one 64-bit mode instruction: prefixes (legacy, REX,
+// VEX, EVEX and XOP), opcode, ModRM, SIB, displacement and immediate. Operands are not interpreted beyond what
+// is needed to relocate code: the position of a RIP-relative displacement and
+// of a relative branch offset.
+//
+// Each opcode map is described by a 256-entry table of operand flags, so a
+// decode is a handful of table lookups without branches on opcode ranges.
+//=============================================================================
+
+// Operand layout flags of an opcode table entry.
+enum OpcodeFlags_t : std::uint16_t
+{
+	OPCODE_NONE    = 0,
+	OPCODE_MODRM   = 1 << 0,  // Has a ModRM byte.
+	OPCODE_IMM8    = 1 << 1,  // 1-byte immediate.
+	OPCODE_IMM16   = 1 << 2,  // 2-byte immediate (adds up with OPCODE_IMM8 for ENTER).
+	OPCODE_IMMZ    = 1 << 3,  // 2 or 4-byte immediate (operand size).
+	OPCODE_IMMV    = 1 << 4,  // 2, 4 or 8-byte immediate (MOV r64, imm64).
+	OPCODE_REL8    = 1 << 5,  // 1-byte relative branch offset.
+	OPCODE_REL32   = 1 << 6,  // 4-byte relative branch offset.
+	OPCODE_MOFFS   = 1 << 7,  // 8-byte absolute address (4 with an address size override).
+	OPCODE_GROUP3  = 1 << 8,  // TEST of the group 3 (F6/F7 /0 and /1) has an immediate.
+	OPCODE_ESCAPE  = 1 << 9,  // Switches to the next opcode map.
+	OPCODE_PREFIX  = 1 << 10, // Legacy or REX prefix.
+	OPCODE_INVALID = 1 << 11, // Invalid in 64-bit mode or not supported by the decoder.
+	OPCODE_VEX     = 1 << 12, // VEX (C4, C5) or EVEX (62) prefix.
+};
+
+// Opcode maps.
+enum OpcodeMap_t : std::uint8_t
+{
+	OPCODE_MAP_PRIMARY = 0, // xx
+	OPCODE_MAP_0F,          // 0F xx
+	OPCODE_MAP_0F38,        // 0F 38 xx
+	OPCODE_MAP_0F3A,        // 0F 3A xx
+	OPCODE_MAP_5 = 5,       // EVEX map 5 (AVX512-FP16)
+	OPCODE_MAP_6,           // EVEX map 6 (AVX512-FP16)
+	OPCODE_MAP_XOP8 = 8,    // XOP map 8
+	OPCODE_MAP_XOP9,        // XOP map 9
+	OPCODE_MAP_XOPA,        // XOP map A
+};
+
+// Instruction encodings.
+enum OpcodeEncoding_t : std::uint8_t
+{
+	OPCODE_ENCODING_LEGACY = 0,
+	OPCODE_ENCODING_VEX,
+	OPCODE_ENCODING_EVEX,
+	OPCODE_ENCODING_XOP,
+};
+
+struct Instruction_t
+{
+	std::uint8_t m_nLength = 0;       // Total length in bytes (0 if the decoding failed).
+	std::uint8_t m_nPrefixes = 0;     // Number of prefix bytes (including a VEX, EVEX or XOP one).
+	std::uint8_t m_nOpcodeOffset = 0; // Offset of the first opcode byte.
+	std::uint8_t m_nOpcode = 0;       // Last opcode byte.
+	std::uint8_t m_nMap = OPCODE_MAP_PRIMARY;
+	std::uint8_t m_nEncoding = OPCODE_ENCODING_LEGACY;
+	std::uint8_t m_nModRM = 0;
+	std::uint8_t m_nRex = 0;          // REX prefix (0 if none).
+	std::uint8_t m_nDispOffset = 0;   // Offset of the displacement.
+	std::uint8_t m_nDispSize = 0;     // 0, 1 or 4.
+	std::uint8_t m_nImmOffset = 0;    // Offset of the immediate (or of the relative branch offset).
+	std::uint8_t m_nImmSize = 0;      // Total size of the immediates.
+	bool m_bOperandSize = false;      // 66 prefix.
+	bool m_bAddressSize = false;      // 67 prefix.
+	std::uint16_t m_nFlags = OPCODE_NONE;
+
+	bool IsValid() const noexcept { return m_nLength != 0; }
+	bool HasModRM() const noexcept { return m_nFlags & OPCODE_MODRM; }
+	bool IsRipRelative() const noexcept { return HasModRM() && (m_nModRM & 0xC7) == 0x05; } // mod = 00, r/m = 101.
+	bool IsRelativeBranch() const noexcept { return m_nFlags & (OPCODE_REL8 | OPCODE_REL32); }
+
+	// Returns the signed displacement or relative branch offset stored in the instruction.
+	static std::int64_t ReadSigned(const std::uint8_t* pCode, std::size_t nSize) noexcept
+	{
+		switch (nSize)
+		{
+			case 1: return static_cast<std::int8_t>(pCode[0]);
+			case 2: { std::int16_t n; std::memcpy(&n, pCode, sizeof(n)); return n; }
+			case 4: { std::int32_t n; std::memcpy(&n, pCode, sizeof(n)); return n; }
+			case 8: { std::int64_t n; std::memcpy(&n, pCode, sizeof(n)); return n; }
+			default: return 0;
+		}
+	}
+
+	// Returns the absolute address a RIP-relative operand or a relative branch refers to (0 if none).
+	std::uintptr_t GetTarget(const void* pInstruction) const noexcept
+	{
+		const auto* pCode = static_cast<const std::uint8_t*>(pInstruction);
+		const auto pNext = reinterpret_cast<std::uintptr_t>(pCode) + m_nLength;
+
+		if (IsRelativeBranch())
+			return pNext + static_cast<std::uintptr_t>(ReadSigned(pCode + m_nImmOffset, m_nImmSize));
+
+		if (IsRipRelative())
+			return pNext + static_cast<std::uintptr_t>(ReadSigned(pCode + m_nDispOffset, m_nDispSize));
+
+		return 0;
+	}
+};
+
+namespace Detail {
+
+using OpcodeTable_t = std::array<std::uint16_t, 256>;
+
+constexpr void SetOpcodes(OpcodeTable_t& table, std::size_t nFirst, std::size_t nLast, std::uint16_t nFlags)
+{
+	for (std::size_t n = nFirst; n <= nLast; ++n)
+		table[n] = nFlags;
+}
+
+constexpr OpcodeTable_t MakePrimaryTable()
+{
+	OpcodeTable_t table {};
+
+	// ALU ops: 00-3F in blocks of 8 (r/m forms, AL/eAX immediates, segment ops).
+	for (std::size_t n = 0x00; n < 0x40; n += 8)
+	{
+		SetOpcodes(table, n, n + 3, OPCODE_MODRM);
+		table[n + 4] = OPCODE_IMM8;
+		table[n + 5] = OPCODE_IMMZ;
+		table[n + 6] = OPCODE_INVALID;
+		table[n + 7] = OPCODE_INVALID;
+	}
+
+	table[0x0F] = OPCODE_ESCAPE;
+	table[0x26] = table[0x2E] = table[0x36] = table[0x3E] = OPCODE_PREFIX;
+	SetOpcodes(table, 0x40, 0x4F, OPCODE_PREFIX); // REX.
+	SetOpcodes(table, 0x50, 0x5F, OPCODE_NONE);
+	SetOpcodes(table, 0x60, 0x61, OPCODE_INVALID);
+	table[0x62] = OPCODE_VEX; // EVEX (BOUND in 32-bit mode).
+	table[0x63] = OPCODE_MODRM;
+	SetOpcodes(table, 0x64, 0x67, OPCODE_PREFIX);
+	table[0x68] = OPCODE_IMMZ;
+	table[0x69] = OPCODE_MODRM | OPCODE_IMMZ;
+	table[0x6A] = OPCODE_IMM8;
+	table[0x6B] = OPCODE_MODRM | OPCODE_IMM8;
+	SetOpcodes(table, 0x6C, 0x6F, OPCODE_NONE);
+	SetOpcodes(table, 0x70, 0x7F, OPCODE_REL8);
+	table[0x80] = OPCODE_MODRM | OPCODE_IMM8;
+	table[0x81] = OPCODE_MODRM | OPCODE_IMMZ;
+	table[0x82] = OPCODE_INVALID;
+	table[0x83] = OPCODE_MODRM | OPCODE_IMM8;
+	SetOpcodes(table, 0x84, 0x8F, OPCODE_MODRM);
+	SetOpcodes(table, 0x90, 0x9F, OPCODE_NONE);
+	table[0x9A] = OPCODE_INVALID;
+	SetOpcodes(table, 0xA0, 0xA3, OPCODE_MOFFS);
+	SetOpcodes(table, 0xA4, 0xAF, OPCODE_NONE);
+	table[0xA8] = OPCODE_IMM8;
+	table[0xA9] = OPCODE_IMMZ;
+	SetOpcodes(table, 0xB0, 0xB7, OPCODE_IMM8);
+	SetOpcodes(table, 0xB8, 0xBF, OPCODE_IMMV);
+	table[0xC0] = table[0xC1] = OPCODE_MODRM | OPCODE_IMM8;
+	table[0xC2] = OPCODE_IMM16;
+	table[0xC3] = OPCODE_NONE;
+	table[0xC4] = table[0xC5] = OPCODE_VEX; // LES, LDS in 32-bit mode.
+	table[0xC6] = OPCODE_MODRM | OPCODE_IMM8;
+	table[0xC7] = OPCODE_MODRM | OPCODE_IMMZ;
+	table[0xC8] = OPCODE_IMM16 | OPCODE_IMM8;
+	table[0xC9] = OPCODE_NONE;
+	table[0xCA] = OPCODE_IMM16;
+	table[0xCB] = table[0xCC] = OPCODE_NONE;
+	table[0xCD] = OPCODE_IMM8;
+	table[0xCE] = OPCODE_INVALID;
+	table[0xCF] = OPCODE_NONE;
+	SetOpcodes(table, 0xD0, 0xD3, OPCODE_MODRM);
+	SetOpcodes(table, 0xD4, 0xD6, OPCODE_INVALID);
+	table[0xD7] = OPCODE_NONE;
+	SetOpcodes(table, 0xD8, 0xDF, OPCODE_MODRM); // x87.
+	SetOpcodes(table, 0xE0, 0xE3, OPCODE_REL8); // LOOPcc, JrCXZ.
+	SetOpcodes(table, 0xE4, 0xE7, OPCODE_IMM8);
+	table[0xE8] = table[0xE9] = OPCODE_REL32;
+	table[0xEA] = OPCODE_INVALID;
+	table[0xEB] = OPCODE_REL8;
+	SetOpcodes(table, 0xEC, 0xEF, OPCODE_NONE);
+	table[0xF0] = table[0xF2] = table[0xF3] = OPCODE_PREFIX;
+	table[0xF1] = table[0xF4] = table[0xF5] = OPCODE_NONE;
+	table[0xF6] = table[0xF7] = OPCODE_MODRM | OPCODE_GROUP3;
+	SetOpcodes(table, 0xF8, 0xFD, OPCODE_NONE);
+	table[0xFE] = table[0xFF] = OPCODE_MODRM;
+
+	return table;
+}
+
+constexpr OpcodeTable_t Make0FTable()
+{
+	OpcodeTable_t table {};
+
+	SetOpcodes(table, 0x00, 0xFF, OPCODE_MODRM); // Most of the map.
+
+	table[0x04] = table[0x0A] = table[0x0C] = OPCODE_INVALID;
+	table[0x05] = table[0x06] = table[0x07] = table[0x08] = table[0x09] = table[0x0B] = table[0x0E] = OPCODE_NONE;
+	table[0x0F] = OPCODE_MODRM | OPCODE_IMM8; // 3DNow! (the immediate is the opcode suffix).
+	SetOpcodes(table, 0x24, 0x27, OPCODE_INVALID);
+	SetOpcodes(table, 0x30, 0x37, OPCODE_NONE);
+	table[0x36] = OPCODE_INVALID;
+	table[0x38] = table[0x3A] = OPCODE_ESCAPE;
+	table[0x39] = OPCODE_INVALID;
+	SetOpcodes(table, 0x3B, 0x3F, OPCODE_INVALID);
+	SetOpcodes(table, 0x70, 0x73, OPCODE_MODRM | OPCODE_IMM8);
+	table[0x77] = OPCODE_NONE;
+	table[0x7A] = table[0x7B] = OPCODE_INVALID;
+	SetOpcodes(table, 0x80, 0x8F, OPCODE_REL32); // Jcc rel32.
+	SetOpcodes(table, 0xA0, 0xA2, OPCODE_NONE);
+	table[0xA4] = table[0xAC] = OPCODE_MODRM | OPCODE_IMM8;
+	table[0xA6] = table[0xA7] = OPCODE_INVALID;
+	SetOpcodes(table, 0xA8, 0xAA, OPCODE_NONE);
+	table[0xBA] = OPCODE_MODRM | OPCODE_IMM8;
+	table[0xC2] = OPCODE_MODRM | OPCODE_IMM8;
+	SetOpcodes(table, 0xC4, 0xC6, OPCODE_MODRM | OPCODE_IMM8);
+	SetOpcodes(table, 0xC8, 0xCF, OPCODE_NONE); // BSWAP.
+
+	return table;
+}
+
+constexpr OpcodeTable_t Make0F3ATable()
+{
+	OpcodeTable_t table {};
+
+	SetOpcodes(table, 0x00, 0xFF, OPCODE_MODRM | OPCODE_IMM8);
+
+	return table;
+}
+
+constexpr OpcodeTable_t Make0F38Table()
+{
+	OpcodeTable_t table {};
+
+	SetOpcodes(table, 0x00, 0xFF, OPCODE_MODRM);
+
+	return table;
+}
+
+inline constexpr OpcodeTable_t s_aPrimaryTable = MakePrimaryTable();
+inline constexpr OpcodeTable_t s_a0FTable = Make0FTable();
+inline constexpr OpcodeTable_t s_a0F38Table = Make0F38Table();
+inline constexpr OpcodeTable_t s_a0F3ATable = Make0F3ATable();
+
+// Returns the flags of an opcode in a VEX, EVEX or XOP map. Every such opcode has a ModRM byte
+// but VZEROUPPER/VZEROALL; the immediates of map 0F match the legacy ones.
+inline std::uint16_t GetVexOpcodeFlags(std::uint8_t nMap, std::uint8_t nOpcode) noexcept
+{
+	switch (nMap)
+	{
+		case OPCODE_MAP_0F:
+		{
+			const std::uint16_t nFlags = s_a0FTable[nOpcode];
+
+			if (nOpcode == 0x77)
+				return OPCODE_NONE;
+
+			return (nFlags & OPCODE_MODRM) ? nFlags & (OPCODE_MODRM | OPCODE_IMM8) : OPCODE_INVALID;
+		}
+
+		case OPCODE_MAP_0F38:
+		case OPCODE_MAP_5:
+		case OPCODE_MAP_6:
+		case OPCODE_MAP_XOP9:
+			return OPCODE_MODRM;
+
+		case OPCODE_MAP_0F3A:
+		case OPCODE_MAP_XOP8:
+			return OPCODE_MODRM | OPCODE_IMM8;
+
+		case OPCODE_MAP_XOPA:
+			return OPCODE_MODRM | OPCODE_IMMZ; // BEXTR, LWPINS, LWPVAL take an imm32.
+
+		default:
+			return OPCODE_INVALID;
+	}
+}
+
+// Decodes the ModRM, SIB and displacement starting at pCode[n]. Returns the new offset.
+inline std::size_t DecodeModRM(const std::uint8_t* pCode, std::size_t n, Instruction_t& instr) noexcept
+{
+	const std::uint8_t nModRM = pCode[n++];
+	const std::uint8_t nMod = nModRM >> 6;
+	const std::uint8_t nRM = nModRM & 7;
+
+	instr.m_nModRM = nModRM;
+
+	if (nMod == 3)
+		return n;
+
+	std::uint8_t nDispSize = nMod == 1 ? 1 : nMod == 2 ? 4 : 0;
+
+	if (nRM == 4)
+	{
+		const std::uint8_t nSIB = pCode[n++];
+
+		if (nMod == 0 && (nSIB & 7) == 5)
+			nDispSize = 4; // No base register.
+	}
+	else if (nMod == 0 && nRM == 5)
+	{
+		nDispSize = 4; // RIP-relative.
+	}
+
+	if (nDispSize)
+	{
+		instr.m_nDispOffset = static_cast<std::uint8_t>(n);
+		instr.m_nDispSize = nDispSize;
+	}
+
+	return n + nDispSize;
+}
+
+// Returns the total immediate size of an opcode.
+inline std::uint8_t GetImmediateSize(const Instruction_t& instr, std::uint16_t nFlags) noexcept
+{
+	std::uint8_t nSize = 0;
+
+	if (nFlags & (OPCODE_IMM8 | OPCODE_REL8))
+		nSize += 1;
+
+	if (nFlags & OPCODE_IMM16)
+		nSize += 2;
+
+	if (nFlags & OPCODE_REL32)
+		nSize += 4; // Intel ignores the operand size override for near branches in 64-bit mode.
+
+	// REX.W takes precedence over the operand size override (an imm32 sign-extended to 64 bits).
+	if (nFlags & OPCODE_IMMZ)
+		nSize += (instr.m_nRex & 0x08) ? 4 : instr.m_bOperandSize ? 2 : 4;
+
+	if (nFlags & OPCODE_IMMV)
+		nSize += (instr.m_nRex & 0x08) ? 8 : instr.m_bOperandSize ? 2 : 4;
+
+	if (nFlags & OPCODE_MOFFS)
+		nSize += instr.m_bAddressSize ? 4 : 8;
+
+	if ((nFlags & OPCODE_GROUP3) && ((instr.m_nModRM >> 3) & 7) < 2)
+		nSize += instr.m_nOpcode == 0xF6 ? 1 : (instr.m_nRex & 0x08) ? 4 : instr.m_bOperandSize ? 2 : 4;
+
+	return nSize;
+}
+
+} // namespace Detail
+
+//-----------------------------------------------------------------------------
+// Purpose: Decodes the length and operand layout of an instruction
+// Input  : pCode - the instruction (at most 15 bytes are read)
+//          instr - receives the layout
+// Output : std::size_t (the instruction length; 0 if it is invalid or uses
+//          an encoding the decoder does not support)
+//-----------------------------------------------------------------------------
+inline std::size_t DecodeInstruction(const void* pCode, Instruction_t& instr) noexcept
+{
+	constexpr std::size_t kMaxLength = 15;
+
+	const auto* pBytes = static_cast<const std::uint8_t*>(pCode);
+
+	instr = Instruction_t {};
+
+	std::size_t n = 0;
+	std::uint16_t nFlags;
+
+	// Legacy prefixes. A REX prefix counts only when it immediately precedes the opcode.
+	for (;; ++n)
+	{
+		if (n >= kMaxLength)
+			return 0;
+
+		const std::uint8_t nByte = pBytes[n];
+
+		nFlags = Detail::s_aPrimaryTable[nByte];
+
+		if (!(nFlags & OPCODE_PREFIX))
+			break;
+
+		if ((nByte & 0xF0) == 0x40)
+		{
+			instr.m_nRex = nByte;
+
+			continue;
+		}
+
+		instr.m_nRex = 0;
+
+		if (nByte == 0x66)
+			instr.m_bOperandSize = true;
+		else if (nByte == 0x67)
+			instr.m_bAddressSize = true;
+	}
+
+	std::uint8_t nOpcode = pBytes[n];
+
+	// XOP shares 8F with POP r/m, whose ModRM reg field is 0 (the map select is 8 and above).
+	if ((nFlags & OPCODE_VEX) || (nOpcode == 0x8F && (pBytes[n + 1] & 0x1F) >= OPCODE_MAP_XOP8))
+	{
+		// A VEX-like prefix cannot follow REX or an operand size override.
+		if (instr.m_nRex || instr.m_bOperandSize)
+			return 0;
+
+		std::uint8_t nMap;
+
+		switch (nOpcode)
+		{
+			case 0xC5:
+				nMap = OPCODE_MAP_0F;
+				instr.m_nEncoding = OPCODE_ENCODING_VEX;
+				n += 2;
+				break;
+
+			case 0xC4:
+				nMap = pBytes[n + 1] & 0x1F;
+				instr.m_nEncoding = OPCODE_ENCODING_VEX;
+				n += 3;
+				break;
+
+			case 0x62:
+				nMap = pBytes[n + 1] & 0x07;
+				instr.m_nEncoding = OPCODE_ENCODING_EVEX;
+
+				if (pBytes[n + 1] & 0x08 || !(pBytes[n + 2] & 0x04))
+					return 0; // Reserved bits, or an APX extended EVEX.
+
+				n += 4;
+				break;
+
+			default:
+				nMap = pBytes[n + 1] & 0x1F;
+				instr.m_nEncoding = OPCODE_ENCODING_XOP;
+				n += 3;
+				break;
+		}
+
+		if (instr.m_nEncoding == OPCODE_ENCODING_XOP ? nMap > OPCODE_MAP_XOPA : (nMap == OPCODE_MAP_PRIMARY || nMap > OPCODE_MAP_6 || nMap == 4))
+			return 0;
+
+		instr.m_nPrefixes = static_cast<std::uint8_t>(n);
+		instr.m_nOpcodeOffset = static_cast<std::uint8_t>(n);
+
+		nOpcode = pBytes[n++];
+		nFlags = Detail::GetVexOpcodeFlags(nMap, nOpcode);
+		instr.m_nMap = nMap;
+	}
+	else
+	{
+		instr.m_nPrefixes = static_cast<std::uint8_t>(n);
+		instr.m_nOpcodeOffset = static_cast<std::uint8_t>(n);
+
+		n++;
+	}
+
+	if (nFlags & OPCODE_ESCAPE)
+	{
+		nOpcode = pBytes[n++];
+		nFlags = Detail::s_a0FTable[nOpcode];
+		instr.m_nMap = OPCODE_MAP_0F;
+
+		if (nFlags & OPCODE_ESCAPE)
+		{
+			const bool b38 = nOpcode == 0x38;
+
+			nOpcode = pBytes[n++];
+			nFlags = b38 ? Detail::s_a0F38Table[nOpcode] : Detail::s_a0F3ATable[nOpcode];
+			instr.m_nMap = b38 ? OPCODE_MAP_0F38 : OPCODE_MAP_0F3A;
+		}
+	}
+
+	if (nFlags & OPCODE_INVALID)
+		return 0;
+
+	instr.m_nOpcode = nOpcode;
+	instr.m_nFlags = nFlags;
+
+	if (nFlags & OPCODE_MODRM)
+		n = Detail::DecodeModRM(pBytes, n, instr);
+
+	const std::uint8_t nImmSize = Detail::GetImmediateSize(instr, nFlags);
+
+	if (nImmSize)
+	{
+		instr.m_nImmOffset = static_cast<std::uint8_t>(n);
+		instr.m_nImmSize = nImmSize;
+		n += nImmSize;
+	}
+
+	if (n > kMaxLength)
+		return 0;
+
+	instr.m_nLength = static_cast<std::uint8_t>(n);
+
+	return n;
+}
+
+// Returns the length of the instruction at pCode (0 if it cannot be decoded).
+inline std::size_t GetInstructionLength(const void* pCode) noexcept
+{
+	Instruction_t instr;
+
+	return DecodeInstruction(pCode, instr);
+}
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_DECODER_HPP
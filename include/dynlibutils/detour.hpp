@@ -0,0 +1,221 @@
+//
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+//
+
+#ifndef DYNLIBUTILS_DETOUR_HPP
+#define DYNLIBUTILS_DETOUR_HPP
+#pragma once
+
+#include "arena.hpp"
+#include "decoder.hpp"
+#include "epoch.hpp"
+#include "memaddr.hpp"
+#include "vthook.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace DynLibUtils {
+
+// An x86-64 inline hook of a function entry, for non-virtual and static functions.
+//
+// Hooking overwrites the first instructions of the target with a jump to the detour. The
+// overwritten instructions are relocated into a trampoline (RIP-relative operands and relative
+// branches are fixed up) followed by a jump back into the target, so calling the trampoline
+// runs the original function.
+//
+// The trampoline is a CCodeArena block within ±2 GB of the target when possible, then the patch
+// is a 5-byte `jmp rel32` (through a relay jump when the detour itself is far away). Otherwise it
+// is a 14-byte `jmp [rip+0]; dq detour`. A patch which fits into an aligned 8-byte word is
+// published with one atomic store, others through an int3 (see WriteCodeBytesThroughBreakpoint),
+// so another thread which starts running the function meanwhile sees either the old or the new
+// entry. The threads are not suspended, though: a thread which was stopped inside the overwritten
+// bytes (past their first instruction) resumes in the middle of the jump and crashes, so only hook
+// functions which no thread is executing past their entry, e.g. before their first call or while the
+// threads which call them are blocked elsewhere. Unhooking is safe: the jump is one instruction.
+//
+// Relocation fails (Hook() returns false) for a function whose overwritten bytes contain a
+// LOOPcc/JrCXZ, a branch back into themselves or a RIP-relative operand which cannot reach its
+// target from the trampoline, for a function shorter than the patch, and for a patch across a
+// word if the trap handler of the int3 can't be installed.
+//
+// Thread safety: like CVTHook, Unhook() and the destructor wait for a CEpoch grace period before
+// the trampoline is freed, so a detour which wraps its body into a CEpoch::CGuard may safely call
+// the original while another thread unhooks it.
+class CDetour
+{
+public:
+	static constexpr std::size_t sm_nNearJumpSize = 5;  // E9 rel32
+	static constexpr std::size_t sm_nFarJumpSize = 14;  // FF 25 00000000 abs64
+
+	CDetour() = default;
+	~CDetour();
+
+	CDetour(const CDetour&) = delete;
+	CDetour& operator=(const CDetour&) = delete;
+
+	bool IsHooked() const noexcept { return m_bHooked; }
+
+	// Builds the trampoline and writes the patch. Returns false if the target cannot be relocated.
+	bool Hook(CMemory pTarget, void* pDetour);
+
+	// Restores the original bytes and frees the trampoline after a grace period (see CVTHook::Unhook).
+	bool Unhook(bool bWait = true);
+
+	CMemory GetTarget() const noexcept { return m_pTarget; } // Returns the hooked function.
+	CMemory GetTrampoline() const noexcept { return m_pTrampoline; } // Returns the entry of the relocated original function.
+	std::size_t GetPatchSize() const noexcept { return m_nPatchSize; } // Returns the number of overwritten bytes (5 or 14).
+
+protected:
+	friend class CDetourTransaction;
+
+	bool Prepare(CMemory pTarget, void* pDetour); // Builds the trampoline and the patch without writing the target.
+	void Apply(); // Writes the prepared patch.
+	void Release(bool bWait); // Frees the trampoline.
+
+	CodePatch_t GetHookPatch() const noexcept { return {m_pTarget, m_aPatch.data(), m_nPatchSize}; }
+	CodePatch_t GetUnhookPatch() const noexcept { return {m_pTarget, m_aOriginal.data(), m_nPatchSize}; }
+
+	bool m_bKeepTrampoline = false; // Never free the trampoline (code may run from it out of any guard).
+
+private:
+	CMemory m_pTarget;
+	CMemory m_pTrampoline;
+
+	CodeBlock_t m_block;
+
+	std::array<std::uint8_t, sm_nFarJumpSize> m_aPatch {};
+	std::array<std::uint8_t, sm_nFarJumpSize> m_aOriginal {};
+	std::size_t m_nPatchSize = 0;
+
+	bool m_bHooked = false;
+}; // class CDetour
+
+// A typed inline hook.
+// Template Parameters:
+//   R    - The return type of the hooked function.
+//   Args - Argument types of the hooked function.
+template<typename R, typename ...Args>
+class CDetourHook : public CDetour
+{
+public:
+	using Function_t = R (*)(Args...);
+
+	bool Hook(CMemory pTarget, Function_t pFn) { return CDetour::Hook(pTarget, reinterpret_cast<void *>(pFn)); }
+
+	template<typename T = Function_t> T GetOrigin() const noexcept { return GetTrampoline().template RCast<T>(); } // Returns the trampoline.
+
+	// Must be invoked from within your detour if you wish to run the original function
+	// (as CVTHook::Call() does).
+	R CallOriginal(Args... args) const { return GetOrigin<Function_t>()(args...); }
+}; // class CDetourHook<R, Args...>
+
+// Registers at a mid-function hook point, as saved by the CMidHook stub. Changes made by the
+// callback are written back, except for RSP which is read-only.
+struct RegisterContext_t
+{
+	struct Xmm_t
+	{
+		std::uint64_t m_nLow;
+		std::uint64_t m_nHigh;
+	};
+
+	Xmm_t m_aXmm[16]; // Only valid if the hook saves vector registers.
+
+	std::uint64_t m_nRax, m_nRcx, m_nRdx, m_nRbx, m_nRsp, m_nRbp, m_nRsi, m_nRdi;
+	std::uint64_t m_nR8, m_nR9, m_nR10, m_nR11, m_nR12, m_nR13, m_nR14, m_nR15;
+	std::uint64_t m_nRflags;
+
+	// Reads or writes the low lanes of an XMM register as T (e.g. float, double, __m128).
+	template<typename T> T GetXmm(std::size_t n) const noexcept { static_assert(sizeof(T) <= sizeof(Xmm_t)); T value; std::memcpy(&value, &m_aXmm[n], sizeof(T)); return value; }
+	template<typename T> void SetXmm(std::size_t n, const T& value) noexcept { static_assert(sizeof(T) <= sizeof(Xmm_t)); std::memcpy(&m_aXmm[n], &value, sizeof(T)); }
+};
+
+// A hook at any instruction boundary inside a function, for values which only live in registers
+// (e.g. right after a call returns).
+//
+// The instructions at the hook point are relocated as by CDetour; the patch jumps to a stub which
+// pushes the general-purpose registers, RFLAGS and (optionally) XMM0-15 into a RegisterContext_t,
+// calls the callback on an aligned stack, restores the (possibly modified) registers and resumes
+// through the trampoline. The stub steps over the System V red zone. As for CDetour, no thread may
+// be stopped inside the overwritten instructions (past the hook point) while it hooks.
+//
+// Skipping the XMM saves makes the stub cheaper, but the callback must then not touch vector
+// registers, which compilers use for floating point and for copying memory.
+//
+// Only the callback runs inside a CEpoch::CGuard: a thread may be preempted in the stub before or
+// after it, or in the relocated instructions, where no grace period can see it. So the stub and the
+// trampoline are never freed nor reused (a Hook() keeps about 640 bytes of CCodeArena for the life
+// of the process), and the stub reads the callback from a slot which is never freed either;
+// Unhook() empties it and frees the callback after a grace period.
+class CMidHook : public CDetour
+{
+public:
+	using Callback_t = std::function<void (RegisterContext_t& context)>;
+
+	CMidHook() = default;
+	~CMidHook();
+
+	// pAddress must be an instruction boundary (e.g. from DecodeInstruction()).
+	bool Hook(CMemory pAddress, Callback_t func, bool bSaveXmm = true);
+	bool Unhook(bool bWait = true);
+
+private:
+	using Slot_t = std::atomic<const Callback_t*>;
+
+	static void Invoke(RegisterContext_t* pContext, const Slot_t* pSlot);
+
+	void Detach(bool bWait); // Frees the callback, leaves the stub.
+
+	Slot_t* m_pSlot = nullptr; // Read by the stub.
+	CodeBlock_t m_stub;
+}; // class CMidHook
+
+// Installs and removes many inline hooks at once: the code pages are unprotected once per
+// contiguous run of touched pages.
+//
+// Example:
+//   CDetourTransaction transaction;
+//   transaction.Hook(hookA, pfnA, &DetourA);
+//   transaction.Hook(hookB, pfnB, &DetourB);
+//   transaction.Commit();
+class CDetourTransaction
+{
+public:
+	CDetourTransaction() = default;
+	~CDetourTransaction() { Abort(); }
+
+	CDetourTransaction(const CDetourTransaction&) = delete;
+	CDetourTransaction& operator=(const CDetourTransaction&) = delete;
+
+	// Queues a hook. Returns false (queuing nothing) if the target cannot be relocated.
+	bool Hook(CDetour& detour, CMemory pTarget, void* pDetour);
+	template<typename R, typename ...Args>
+	bool Hook(CDetourHook<R, Args...>& detour, CMemory pTarget, R (*pFn)(Args...)) { return Hook(static_cast<CDetour&>(detour), pTarget, reinterpret_cast<void *>(pFn)); }
+
+	// Queues an unhook.
+	void Unhook(CDetour& detour);
+
+	// Writes the queued patches. Unhooked trampolines are freed after a grace period.
+	// Returns the number of applied operations.
+	std::size_t Commit(bool bWait = true);
+
+	// Drops the queued operations.
+	void Abort();
+
+private:
+	std::vector<CDetour*> m_vecHooks;
+	std::vector<CDetour*> m_vecUnhooks;
+}; // class CDetourTransaction
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_DETOUR_HPP
@@ -0,0 +1,268 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_EPOCH_HPP
+#define DYNLIBUTILS_EPOCH_HPP
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace DynLibUtils {
+
+//=============================================================================
+// CEpoch
+//
+// Process-wide epoch-based reclamation, used to make hook removal safe while
+// other threads are calling through the hook.
+//
+// Readers (hook trampolines) wrap their critical section into a CEpoch::CGuard.
+// Entering publishes the current global epoch into a per-thread record; leaving
+// resets it. Both are plain stores into a thread-owned cache line, so readers
+// never wait and never contend with each other.
+//
+// Writers first unpublish a shared object (restore a vtable slot, swap a
+// pointer), then either:
+//   * Synchronize() - wait until every thread that was inside a critical
+//                     section at that moment has left it, or
+//   * Retire(func)  - defer func (usually a delete) until that has happened.
+// Only threads that are currently inside a guard are waited for; new readers
+// are never blocked, so there are no stop-the-world pauses.
+//
+// Guards nest. A thread inside a guard cannot wait for itself: Synchronize()
+// returns false there and the caller has to Retire() instead.
+//=============================================================================
+class CEpoch final
+{
+public:
+	// RAII critical section.
+	class CGuard final
+	{
+	public:
+		CGuard() noexcept { Enter(); }
+		~CGuard() { Leave(); }
+
+		CGuard(const CGuard&) = delete;
+		CGuard& operator=(const CGuard&) = delete;
+	}; // class CGuard
+
+	static void Enter() noexcept
+	{
+		ThreadState_t& state = sm_thread;
+
+		if (state.m_nDepth++)
+			return;
+
+		Record_t* pRecord = state.m_pRecord ? state.m_pRecord : (state.m_pRecord = AcquireRecord());
+
+		// Sequentially consistent: the announcement must be visible before any shared pointer is read.
+		pRecord->m_nEpoch.store(sm_nGlobalEpoch.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+	}
+
+	static void Leave() noexcept
+	{
+		ThreadState_t& state = sm_thread;
+
+		assert(state.m_nDepth > 0);
+
+		if (--state.m_nDepth)
+			return;
+
+		state.m_pRecord->m_nEpoch.store(sm_nQuiescent, std::memory_order_release);
+	}
+
+	// Returns true if the calling thread is inside a critical section.
+	static bool IsInside() noexcept { return sm_thread.m_nDepth != 0; }
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Waits for a grace period: every critical section which was active
+	//          on entry has finished
+	// Output : false if the calling thread is inside a critical section (nothing
+	//          was waited for)
+	//-----------------------------------------------------------------------------
+	static bool Synchronize()
+	{
+		if (IsInside())
+			return false;
+
+		WaitFor(Advance());
+		Collect();
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Defers a reclamation until a grace period has elapsed
+	// Input  : func - callable to run once no reader can observe the retired object
+	//-----------------------------------------------------------------------------
+	static void Retire(std::function<void()> func)
+	{
+		const std::uint64_t nEpoch = Advance();
+
+		{
+			std::lock_guard<std::mutex> lock(sm_mutex);
+
+			sm_vecRetired.emplace_back(nEpoch, std::move(func));
+		}
+
+		Collect();
+	}
+
+	// Frees with a grace period: waits when possible, retires otherwise.
+	template<typename T>
+	static void Reclaim(T* pObject)
+	{
+		if (!pObject)
+			return;
+
+		if (Synchronize())
+			delete pObject;
+		else
+			Retire([pObject]() { delete pObject; });
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Runs the retired callbacks whose grace period has elapsed
+	// Output : number of callbacks executed
+	//-----------------------------------------------------------------------------
+	static std::size_t Collect()
+	{
+		std::vector<std::function<void()>> vecReady;
+
+		{
+			std::lock_guard<std::mutex> lock(sm_mutex);
+
+			if (sm_vecRetired.empty())
+				return 0;
+
+			const std::uint64_t nOldest = GetOldestActiveEpoch();
+
+			auto it = sm_vecRetired.begin();
+
+			while (it != sm_vecRetired.end())
+			{
+				if (it->first <= nOldest)
+				{
+					vecReady.push_back(std::move(it->second));
+					it = sm_vecRetired.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+
+		for (auto& func : vecReady)
+			func();
+
+		return vecReady.size();
+	}
+
+private:
+	static constexpr std::uint64_t sm_nQuiescent = 0;
+
+	struct alignas(64) Record_t // One cache line per thread.
+	{
+		std::atomic<std::uint64_t> m_nEpoch {sm_nQuiescent};
+		std::atomic<bool> m_bUsed {true};
+		Record_t* m_pNext = nullptr;
+	};
+
+	struct ThreadState_t
+	{
+		ThreadState_t() noexcept : m_pRecord(nullptr), m_nDepth(0) {}
+		~ThreadState_t()
+		{
+			if (m_pRecord)
+			{
+				m_pRecord->m_nEpoch.store(sm_nQuiescent, std::memory_order_release);
+				m_pRecord->m_bUsed.store(false, std::memory_order_release); // Let another thread reuse it.
+			}
+		}
+
+		Record_t* m_pRecord;
+		std::uint32_t m_nDepth;
+	};
+
+	// Records are never freed: a thread takes a released one or pushes a new one.
+	static Record_t* AcquireRecord()
+	{
+		for (Record_t* pRecord = sm_pRecords.load(std::memory_order_acquire); pRecord; pRecord = pRecord->m_pNext)
+		{
+			bool bUsed = false;
+
+			if (!pRecord->m_bUsed.load(std::memory_order_relaxed) && pRecord->m_bUsed.compare_exchange_strong(bUsed, true, std::memory_order_acquire))
+				return pRecord;
+		}
+
+		auto* pRecord = new Record_t;
+
+		pRecord->m_pNext = sm_pRecords.load(std::memory_order_relaxed);
+
+		while (!sm_pRecords.compare_exchange_weak(pRecord->m_pNext, pRecord, std::memory_order_release, std::memory_order_relaxed)) {}
+
+		return pRecord;
+	}
+
+	// Starts a new epoch. Critical sections that announced an older one may still see unpublished objects.
+	static std::uint64_t Advance() noexcept
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst); // Order the unpublishing store before the scan.
+
+		return sm_nGlobalEpoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+	}
+
+	// Returns the smallest epoch announced by an active thread (or the current global one).
+	static std::uint64_t GetOldestActiveEpoch() noexcept
+	{
+		std::uint64_t nOldest = sm_nGlobalEpoch.load(std::memory_order_seq_cst);
+
+		for (Record_t* pRecord = sm_pRecords.load(std::memory_order_acquire); pRecord; pRecord = pRecord->m_pNext)
+		{
+			const std::uint64_t nEpoch = pRecord->m_nEpoch.load(std::memory_order_seq_cst);
+
+			if (nEpoch != sm_nQuiescent && nEpoch < nOldest)
+				nOldest = nEpoch;
+		}
+
+		return nOldest;
+	}
+
+	static void WaitFor(const std::uint64_t nEpoch) noexcept
+	{
+		for (Record_t* pRecord = sm_pRecords.load(std::memory_order_acquire); pRecord; pRecord = pRecord->m_pNext)
+		{
+			for (std::size_t nSpins = 0; ; ++nSpins)
+			{
+				const std::uint64_t nRecordEpoch = pRecord->m_nEpoch.load(std::memory_order_seq_cst);
+
+				if (nRecordEpoch == sm_nQuiescent || nRecordEpoch >= nEpoch)
+					break;
+
+				if (nSpins > 64)
+					std::this_thread::yield();
+			}
+		}
+	}
+
+	inline static std::atomic<std::uint64_t> sm_nGlobalEpoch {1};
+	inline static std::atomic<Record_t*> sm_pRecords {nullptr};
+	inline static thread_local ThreadState_t sm_thread;
+
+	inline static std::mutex sm_mutex;
+	inline static std::vector<std::pair<std::uint64_t, std::function<void()>>> sm_vecRetired;
+}; // class CEpoch
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_EPOCH_HPP
@@ -0,0 +1,324 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_FLATMAP_HPP
+#define DYNLIBUTILS_FLATMAP_HPP
+
+#pragma once
+
+#include "epoch.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace DynLibUtils {
+
+//=============================================================================
+// CAtomicFlatMap
+//
+// An open-addressing hash table keyed by a non-zero address (a vtable pointer,
+// an object pointer, ...) and storing immutable values by pointer.
+//
+// Readers (Find) are wait-free: one acquire load of the table, then a linear
+// probe over contiguous slots. Writers are serialized by a mutex and never
+// modify a published value in place; they build a new one and publish it with
+// an atomic pointer swap (RCU-style). Replaced values and outgrown tables are
+// retired through CEpoch, so readers must hold a CEpoch::CGuard for as long
+// as they use a pointer returned by Find().
+//
+// Keys are never removed from the table: erasing a key publishes a null value
+// into its slot, which keeps probe chains intact for concurrent readers.
+//=============================================================================
+template<typename V>
+class CAtomicFlatMap
+{
+public:
+	using Key_t = std::uintptr_t;
+	using Value_t = V;
+
+	static constexpr std::size_t sm_nMinCapacity = 16; // Must be a power of two.
+
+	CAtomicFlatMap() : m_pTable(nullptr), m_nUsed(0) {}
+	~CAtomicFlatMap()
+	{
+		// No readers are expected at destruction.
+		if (Table_t* pTable = m_pTable.load(std::memory_order_relaxed))
+			DestroyTable(pTable, true);
+	}
+
+	CAtomicFlatMap(const CAtomicFlatMap&) = delete;
+	CAtomicFlatMap& operator=(const CAtomicFlatMap&) = delete;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Looks up the value published for a key (wait-free)
+	// Input  : nKey - non-zero key
+	// Output : const V* (nullptr if the key was never inserted or was erased)
+	//-----------------------------------------------------------------------------
+	const V* Find(const Key_t nKey) const noexcept
+	{
+		const Table_t* pTable = m_pTable.load(std::memory_order_acquire);
+
+		if (!pTable)
+			return nullptr;
+
+		const std::size_t nMask = pTable->m_nMask;
+
+		for (std::size_t n = Hash(nKey) & nMask; ; n = (n + 1) & nMask)
+		{
+			const Slot_t& slot = pTable->m_aSlots[n];
+			const Key_t nSlotKey = slot.m_nKey.load(std::memory_order_acquire);
+
+			if (nSlotKey == nKey)
+				return slot.m_pValue.load(std::memory_order_acquire);
+
+			if (!nSlotKey)
+				return nullptr;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Replaces the value of a key under the writer lock
+	// Input  : nKey - non-zero key
+	//          funcUpdate - std::unique_ptr<V> (const V* pOld); the returned value
+	//                       is published, a null one erases the key
+	// Output : const V* (the published value)
+	//-----------------------------------------------------------------------------
+	template<typename FUNC>
+	const V* Update(const Key_t nKey, FUNC&& funcUpdate)
+	{
+		assert(nKey != 0);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		Slot_t& slot = FindOrInsertSlot(nKey);
+
+		V* pOld = slot.m_pValue.load(std::memory_order_relaxed);
+		V* pPublished = funcUpdate(static_cast<const V*>(pOld)).release();
+
+		slot.m_pValue.store(pPublished, std::memory_order_release);
+
+		if (pOld)
+			CEpoch::Retire([pOld]() { delete pOld; });
+
+		return pPublished;
+	}
+
+	// Publishes a null value for the key. Returns true if a value was erased.
+	bool Erase(const Key_t nKey)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		Table_t* pTable = m_pTable.load(std::memory_order_relaxed);
+
+		if (!pTable)
+			return false;
+
+		const std::size_t nMask = pTable->m_nMask;
+
+		for (std::size_t n = Hash(nKey) & nMask; ; n = (n + 1) & nMask)
+		{
+			Slot_t& slot = pTable->m_aSlots[n];
+			const Key_t nSlotKey = slot.m_nKey.load(std::memory_order_relaxed);
+
+			if (nSlotKey == nKey)
+			{
+				V* pOld = slot.m_pValue.exchange(nullptr, std::memory_order_acq_rel);
+
+				if (!pOld)
+					return false;
+
+				CEpoch::Retire([pOld]() { delete pOld; });
+
+				return true;
+			}
+
+			if (!nSlotKey)
+				return false;
+		}
+	}
+
+	// Calls func(Key_t, const V&) for every live value. Runs under the writer lock.
+	template<typename FUNC>
+	void ForEach(FUNC&& func) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const Table_t* pTable = m_pTable.load(std::memory_order_relaxed);
+
+		if (!pTable)
+			return;
+
+		for (std::size_t n = 0; n <= pTable->m_nMask; ++n)
+		{
+			const Slot_t& slot = pTable->m_aSlots[n];
+			const V* pValue = slot.m_pValue.load(std::memory_order_relaxed);
+
+			if (pValue)
+				func(slot.m_nKey.load(std::memory_order_relaxed), *pValue);
+		}
+	}
+
+	// Unpublishes every value and the table, then frees them after a grace period.
+	void Clear()
+	{
+		Table_t* pTable;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			pTable = m_pTable.exchange(nullptr, std::memory_order_acq_rel);
+			m_nUsed = 0;
+		}
+
+		if (!pTable)
+			return;
+
+		if (CEpoch::Synchronize())
+			DestroyTable(pTable, true);
+		else
+			CEpoch::Retire([pTable]() { DestroyTable(pTable, true); });
+	}
+
+protected:
+	struct Slot_t
+	{
+		std::atomic<Key_t> m_nKey {0};
+		std::atomic<V*> m_pValue {nullptr};
+	};
+
+	struct Table_t
+	{
+		explicit Table_t(std::size_t nCapacity) : m_nMask(nCapacity - 1), m_aSlots(new Slot_t[nCapacity]) {}
+
+		std::size_t m_nMask;
+		std::unique_ptr<Slot_t[]> m_aSlots;
+	};
+
+	// Values are owned by the slots of the current table; an outgrown table only shares them.
+	static void DestroyTable(Table_t* pTable, bool bWithValues)
+	{
+		if (bWithValues)
+		{
+			for (std::size_t n = 0; n <= pTable->m_nMask; ++n)
+				delete pTable->m_aSlots[n].m_pValue.load(std::memory_order_relaxed);
+		}
+
+		delete pTable;
+	}
+
+	static std::size_t Hash(Key_t nKey) noexcept
+	{
+		// Murmur3 finalizer: vtable and object addresses are 8/16-byte aligned and close together.
+		std::uint64_t h = static_cast<std::uint64_t>(nKey);
+
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDull;
+		h ^= h >> 33;
+
+		return static_cast<std::size_t>(h);
+	}
+
+	static Slot_t& ProbeSlot(Table_t* pTable, const Key_t nKey) noexcept
+	{
+		const std::size_t nMask = pTable->m_nMask;
+
+		std::size_t n = Hash(nKey) & nMask;
+
+		for (;; n = (n + 1) & nMask)
+		{
+			const Key_t nSlotKey = pTable->m_aSlots[n].m_nKey.load(std::memory_order_relaxed);
+
+			if (!nSlotKey || nSlotKey == nKey)
+				break;
+		}
+
+		return pTable->m_aSlots[n];
+	}
+
+	// Called under the writer lock. Grows the table (keeping the load factor under 1/2) before inserting.
+	Slot_t& FindOrInsertSlot(const Key_t nKey)
+	{
+		Table_t* pTable = m_pTable.load(std::memory_order_relaxed);
+
+		if (pTable)
+		{
+			Slot_t& slot = ProbeSlot(pTable, nKey);
+
+			if (slot.m_nKey.load(std::memory_order_relaxed) == nKey)
+				return slot;
+		}
+
+		const std::size_t nCapacity = pTable ? pTable->m_nMask + 1 : 0;
+
+		if ((m_nUsed + 1) * 2 > nCapacity)
+		{
+			std::size_t nLive = 1;
+
+			if (pTable)
+			{
+				for (std::size_t n = 0; n < nCapacity; ++n)
+				{
+					if (pTable->m_aSlots[n].m_pValue.load(std::memory_order_relaxed))
+						++nLive;
+				}
+			}
+
+			std::size_t nNewCapacity = sm_nMinCapacity;
+
+			while (nNewCapacity < nLive * 4)
+				nNewCapacity <<= 1;
+
+			auto* pNewTable = new Table_t(nNewCapacity);
+
+			m_nUsed = 0;
+
+			if (pTable)
+			{
+				for (std::size_t n = 0; n < nCapacity; ++n)
+				{
+					const Slot_t& from = pTable->m_aSlots[n];
+					V* pValue = from.m_pValue.load(std::memory_order_relaxed);
+
+					if (!pValue)
+						continue; // Erased keys are dropped on rehash.
+
+					Slot_t& to = ProbeSlot(pNewTable, from.m_nKey.load(std::memory_order_relaxed));
+
+					to.m_pValue.store(pValue, std::memory_order_relaxed);
+					to.m_nKey.store(from.m_nKey.load(std::memory_order_relaxed), std::memory_order_relaxed);
+					++m_nUsed;
+				}
+			}
+
+			m_pTable.store(pNewTable, std::memory_order_release);
+
+			if (pTable)
+				CEpoch::Retire([pTable]() { DestroyTable(pTable, false); }); // In-flight readers may still probe it.
+
+			pTable = pNewTable;
+		}
+
+		Slot_t& slot = ProbeSlot(pTable, nKey);
+
+		slot.m_nKey.store(nKey, std::memory_order_release);
+		++m_nUsed;
+
+		return slot;
+	}
+
+private:
+	std::atomic<Table_t*> m_pTable;
+	std::size_t m_nUsed; // Occupied slots (including erased keys) of the current table.
+
+	mutable std::mutex m_mutex;
+}; // class CAtomicFlatMap<V>
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_FLATMAP_HPP
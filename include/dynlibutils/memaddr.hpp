@@ -7,9 +7,16 @@
 
 #pragma once
 
+#include "decoder.hpp"
+
+#include <immintrin.h>
+
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
@@ -39,9 +46,18 @@ concept MemByteToStringFunc_t = requires(FUNC f, std::size_t index, std::uint8_t
 {
 	{ f(index, byte) } -> std::convertible_to<std::pair<std::string, bool>>;
 };
+
+// Concept for chunked dump output handler.
+// Signature: void func(std::string_view svChunk)
+template<typename FUNC>
+concept MemChunkOutputFunc_t = requires(FUNC f, std::string_view svChunk)
+{
+	{ f(svChunk) } -> std::same_as<void>;
+};
 #else
 #define MemLineOutputFunc_t typename
 #define MemByteToStringFunc_t typename
+#define MemChunkOutputFunc_t typename
 #endif
 
 template<typename T = std::uint8_t, std::size_t SIZE = sizeof(T), std::size_t CHARS = std::max<std::size_t>(2, SIZE)>
@@ -90,6 +106,132 @@ inline constexpr auto GetDefaultMemToHexFunc()
 	return g_funcDefaultMemToHex<BYTES_PER_LINE>;
 }
 
+// Checks that a byte formatter is the default one, whose dumps are written by MemDumpToBuffer().
+template<std::size_t BYTES_PER_LINE, typename TO_HEX_FUNC>
+inline constexpr bool IsDefaultMemToHexFunc()
+{
+	return std::is_same_v<TO_HEX_FUNC, decltype(GetDefaultMemToHexFunc<BYTES_PER_LINE>())>;
+}
+
+// Returns the number of chars of a dump in the default format: "XX XX ... XX |ascii|\n" per line,
+// the hex column of the last (partial) line being padded with spaces.
+inline constexpr std::size_t GetMemDumpSize(std::size_t nSize, std::size_t nBytesPerLine = 8)
+{
+	const std::size_t nRemainder = nSize % nBytesPerLine;
+
+	return (nSize / nBytesPerLine) * (nBytesPerLine * 4 + 3) + (nRemainder ? nBytesPerLine * 3 + nRemainder + 3 : 0);
+}
+
+// Writes the whole dump lines of a memory range which fit into a buffer, without allocating
+// (SSSE3 hex encoding, 16 bytes at a time). Returns the number of written chars; pDumpedSize
+// receives the number of dumped bytes.
+std::size_t MemDumpToBuffer(char* pBuffer, std::size_t nBufferSize, const void* pData, std::size_t nSize, std::size_t nBytesPerLine = 8, std::size_t* pDumpedSize = nullptr) noexcept;
+
+// Checks that a memory range is mapped readable, through the process region map (see CRegionMap).
+bool IsMemoryReadable(std::uintptr_t pAddress, std::size_t nSize);
+
+// Returns true if the CPU and the OS support AVX2 (checked once).
+bool IsAVX2Supported() noexcept;
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define DYNLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#	define DYNLIB_TARGET_AVX2
+#endif
+
+// A field read by CMemory::Gather(): a T at OFFSET bytes from the object.
+template<typename T, std::ptrdiff_t OFFSET>
+struct GatherField_t
+{
+	static_assert(std::is_trivially_copyable_v<T>, "A gathered field must be trivially copyable");
+
+	using Value_t = T;
+	static constexpr std::ptrdiff_t sm_nOffset = OFFSET;
+};
+
+namespace Detail {
+
+inline constexpr std::size_t kGatherPrefetchDistance = 16; // Objects.
+
+template<typename FIELD>
+inline void PrefetchField(std::uintptr_t pObject) noexcept
+{
+	_mm_prefetch(reinterpret_cast<const char*>(pObject + FIELD::sm_nOffset), _MM_HINT_T0);
+}
+
+// A null object reads as a value-initialized field.
+template<typename FIELD>
+inline void ReadField(std::uintptr_t pObject, typename FIELD::Value_t* pOutput) noexcept
+{
+	using Value_t = typename FIELD::Value_t;
+
+	*pOutput = pObject ? *reinterpret_cast<const Value_t*>(pObject + FIELD::sm_nOffset) : Value_t{};
+}
+
+template<typename ...FIELDS>
+inline void GatherScalar(const std::uintptr_t* pObjects, std::size_t nBegin, std::size_t nEnd, std::size_t nCount, typename FIELDS::Value_t*... pOutputs) noexcept
+{
+	for (std::size_t n = nBegin; n < nEnd; ++n)
+	{
+		if (n + kGatherPrefetchDistance < nCount && pObjects[n + kGatherPrefetchDistance])
+			(PrefetchField<FIELDS>(pObjects[n + kGatherPrefetchDistance]), ...);
+
+		(ReadField<FIELDS>(pObjects[n], pOutputs + n), ...);
+	}
+}
+
+// Reads a field of 4 objects: 4 and 8 byte fields with one masked gather (null lanes read 0), others one by one.
+template<typename FIELD>
+DYNLIB_TARGET_AVX2 inline void GatherFieldAVX2(const std::uintptr_t* pObjects, __m256i vAddresses, __m256i vValid, typename FIELD::Value_t* pOutput) noexcept
+{
+	using Value_t = typename FIELD::Value_t;
+
+	const __m256i vFields = _mm256_add_epi64(vAddresses, _mm256_set1_epi64x(FIELD::sm_nOffset));
+
+	if constexpr (sizeof(Value_t) == sizeof(std::int64_t))
+	{
+		const __m256i vValues = _mm256_mask_i64gather_epi64(_mm256_setzero_si256(), nullptr, vFields, vValid, 1);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pOutput), vValues);
+	}
+	else if constexpr (sizeof(Value_t) == sizeof(std::int32_t))
+	{
+		const __m128i vValid32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(vValid, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+		const __m128i vValues = _mm256_mask_i64gather_epi32(_mm_setzero_si128(), nullptr, vFields, vValid32, 1);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pOutput), vValues);
+	}
+	else
+	{
+		for (std::size_t n = 0; n < 4; ++n)
+			ReadField<FIELD>(pObjects[n], pOutput + n);
+	}
+}
+
+template<typename ...FIELDS>
+DYNLIB_TARGET_AVX2 inline std::size_t GatherAVX2(const std::uintptr_t* pObjects, std::size_t nCount, typename FIELDS::Value_t*... pOutputs) noexcept
+{
+	std::size_t n = 0;
+
+	for (; n + 4 <= nCount; n += 4)
+	{
+		for (std::size_t nAhead = n + kGatherPrefetchDistance; nAhead < std::min(n + kGatherPrefetchDistance + 4, nCount); ++nAhead)
+		{
+			if (pObjects[nAhead])
+				(PrefetchField<FIELDS>(pObjects[nAhead]), ...);
+		}
+
+		const __m256i vAddresses = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pObjects + n));
+		const __m256i vValid = _mm256_xor_si256(_mm256_cmpeq_epi64(vAddresses, _mm256_setzero_si256()), _mm256_set1_epi64x(-1));
+
+		(GatherFieldAVX2<FIELDS>(pObjects + n, vAddresses, vValid, pOutputs + n), ...);
+	}
+
+	return n;
+}
+
+} // namespace Detail
+
 class CMemory
 {
 public:
@@ -155,6 +297,47 @@ public:
 	}
 	CMemory& DerefSelf(int deref = 1, std::ptrdiff_t offset = 0) noexcept { while (m_addr && deref--) m_addr = *reinterpret_cast<std::uintptr_t*>(m_addr + offset); return *this; }
 
+	// Checked variants: every read is looked up in the process region map first (see IsMemoryReadable),
+	// an unmapped link yields DYNLIB_INVALID_MEMORY (or false) instead of a crash. Memory unmapped since
+	// the last build of the map is not caught (see CRegionMap).
+	CMemory DerefChecked(std::uintptr_t deref = 1, std::ptrdiff_t offset = 0) const
+	{
+		std::uintptr_t base = m_addr;
+
+		while (base && deref--)
+		{
+			if (!IsMemoryReadable(base + offset, sizeof(std::uintptr_t)))
+				return nullptr;
+
+			base = *reinterpret_cast<std::uintptr_t*>(base + offset);
+		}
+
+		return base;
+	}
+	CMemory& DerefCheckedSelf(int deref = 1, std::ptrdiff_t offset = 0) { m_addr = DerefChecked(deref, offset).m_addr; return *this; }
+	template<typename T> bool GetChecked(T& value) const { if (!IsMemoryReadable(m_addr, sizeof(T))) return false; value = GetRef<T>(); return true; }
+
+	// Reads fields of many objects into structure-of-arrays buffers: this is an array of count object
+	// pointers, each output receives count values (a null object reads as T{}). The objects ahead are
+	// prefetched; with AVX2, the 4 and 8 byte fields of 4 objects are read by one gather.
+	//
+	//   CMemory(vecEntities.data()).Gather<GatherField_t<int, 0x10>, GatherField_t<float, 0x24>>(vecEntities.size(), aHealth, aSpeed);
+	template<typename ...FIELDS>
+	std::size_t Gather(std::size_t count, typename FIELDS::Value_t*... outputs) const noexcept
+	{
+		static_assert(sizeof...(FIELDS) != 0, "Nothing to gather");
+
+		const auto* pObjects = RCast<const std::uintptr_t*>();
+
+		static const bool s_bAVX2 = IsAVX2Supported();
+
+		const std::size_t nGathered = s_bAVX2 ? Detail::GatherAVX2<FIELDS...>(pObjects, count, outputs...) : 0;
+
+		Detail::GatherScalar<FIELDS...>(pObjects, nGathered, count, count, outputs...);
+
+		return count;
+	}
+
 	CMemory FollowNearCall(const std::ptrdiff_t opcodeOffset = 0x1, const std::ptrdiff_t nextInstructionOffset = 0x5) const noexcept { return ResolveRelativeAddress(opcodeOffset, nextInstructionOffset); }
 	CMemory& FollowNearCallSelf(const std::ptrdiff_t opcodeOffset = 0x1, const std::ptrdiff_t nextInstructionOffset = 0x5) noexcept { return ResolveRelativeAddressSelf(opcodeOffset, nextInstructionOffset); }
 
@@ -177,11 +360,125 @@ public:
 		return *this;
 	}
 
-	template<std::size_t BYTES_PER_LINE = 8, MemLineOutputFunc_t OUT_FUNC, MemByteToStringFunc_t TO_HEX_FUNC>
+	// Instruction-aware methods (x86-64), the operand and next instruction offsets are decoded instead of being hard-coded.
+	std::size_t GetInstructionLength() const noexcept { return DynLibUtils::GetInstructionLength(m_ptr); } // 0 if the instruction can't be decoded.
+	CMemory NextInstruction(std::size_t count = 1) const noexcept { CMemory result(*this); return result.NextInstructionSelf(count); }
+	CMemory& NextInstructionSelf(std::size_t count = 1) noexcept
+	{
+		while (m_addr && count--)
+		{
+			const std::size_t length = GetInstructionLength();
+
+			m_addr = length ? m_addr + length : 0;
+		}
+
+		return *this;
+	}
+
+	// Returns the address a RIP-relative operand or a relative branch (call, jmp, jcc) of the instruction refers to.
+	CMemory ResolveInstruction() const noexcept
+	{
+		Instruction_t instr;
+
+		return DecodeInstruction(m_ptr, instr) ? instr.GetTarget(m_ptr) : 0;
+	}
+	CMemory& ResolveInstructionSelf() noexcept { m_addr = ResolveInstruction().m_addr; return *this; }
+
+	// Passes the dump lines of a memory range to funcOutput. With the default byte formatter, the lines
+	// are written by MemDumpToBuffer() (see DumpChunked) into one reused string; a custom one is
+	// called per byte and decides where the lines break.
+	template<std::size_t BYTES_PER_LINE = 8, MemLineOutputFunc_t OUT_FUNC, MemByteToStringFunc_t TO_HEX_FUNC = decltype(GetDefaultMemToHexFunc<BYTES_PER_LINE>())>
 	std::size_t Dump(std::size_t size, OUT_FUNC funcOutput, TO_HEX_FUNC funcToHex = GetDefaultMemToHexFunc<BYTES_PER_LINE>()) const
 	{
-		constexpr std::size_t kCharsPerLine = BYTES_PER_LINE * 2;
+		if constexpr (IsDefaultMemToHexFunc<BYTES_PER_LINE, TO_HEX_FUNC>())
+		{
+			std::string sLine;
+			sLine.reserve(GetMemDumpSize(BYTES_PER_LINE, BYTES_PER_LINE));
+
+			return DumpChunked<BYTES_PER_LINE>(size, [&](std::string_view svChunk)
+			{
+				// A chunk holds whole lines, and the ASCII column has no line feed.
+				for (std::size_t nPos = 0; nPos < svChunk.size(); )
+				{
+					const std::size_t nEnd = svChunk.find('\n', nPos) + 1;
+
+					sLine.assign(svChunk.data() + nPos, nEnd - nPos);
+					funcOutput(sLine);
+
+					nPos = nEnd;
+				}
+			});
+		}
+		else
+		{
+			return DumpLines<BYTES_PER_LINE>(size, funcOutput, funcToHex);
+		}
+	}
+
+	// Allocation-free variants of Dump() in its default format (see GetMemDumpSize).
+	// DumpTo() writes into a buffer (of GetMemDumpSize() chars for the whole range) and returns the number of written chars.
+	// The format is the default one only: the size of a custom one is not known ahead.
+	std::size_t DumpTo(char* pBuffer, std::size_t nBufferSize, std::size_t size, std::size_t nBytesPerLine = 8) const noexcept { return MemDumpToBuffer(pBuffer, nBufferSize, m_ptr, size, nBytesPerLine); }
+
+	// DumpChunked() streams a dump of any size through a stack buffer, handing a chunk of whole lines at a time. Returns the number of lines.
+	// A custom byte formatter (see Dump) is supported, its lines are gathered into the chunks (a longer line is handed alone); it allocates as Dump() does.
+	template<std::size_t BYTES_PER_LINE = 8, std::size_t CHUNK_SIZE = 16384, MemChunkOutputFunc_t OUT_FUNC, MemByteToStringFunc_t TO_HEX_FUNC = decltype(GetDefaultMemToHexFunc<BYTES_PER_LINE>())>
+	std::size_t DumpChunked(std::size_t size, OUT_FUNC funcOutput, TO_HEX_FUNC funcToHex = GetDefaultMemToHexFunc<BYTES_PER_LINE>()) const
+	{
+		static_assert(BYTES_PER_LINE && GetMemDumpSize(BYTES_PER_LINE, BYTES_PER_LINE) <= CHUNK_SIZE, "A chunk must hold a line");
+
+		char sChunk[CHUNK_SIZE];
+
+		if constexpr (IsDefaultMemToHexFunc<BYTES_PER_LINE, TO_HEX_FUNC>())
+		{
+			const auto* pData = RCast<const std::uint8_t*>();
+
+			for (std::size_t n = 0; n < size; )
+			{
+				std::size_t nDumped;
+				const std::size_t nChars = MemDumpToBuffer(sChunk, sizeof(sChunk), pData + n, size - n, BYTES_PER_LINE, &nDumped);
+
+				funcOutput(std::string_view(sChunk, nChars));
+				n += nDumped;
+			}
 
+			return (size + BYTES_PER_LINE - 1) / BYTES_PER_LINE;
+		}
+		else
+		{
+			std::size_t nChars = 0;
+
+			const std::size_t nLines = DumpLines<BYTES_PER_LINE>(size, [&](const std::string& sLine)
+			{
+				if (nChars + sLine.size() > sizeof(sChunk) && nChars)
+				{
+					funcOutput(std::string_view(sChunk, nChars));
+					nChars = 0;
+				}
+
+				if (sLine.size() > sizeof(sChunk))
+				{
+					funcOutput(std::string_view(sLine));
+
+					return;
+				}
+
+				std::memcpy(sChunk + nChars, sLine.data(), sLine.size());
+				nChars += sLine.size();
+			}, funcToHex);
+
+			if (nChars)
+				funcOutput(std::string_view(sChunk, nChars));
+
+			return nLines;
+		}
+	}
+
+protected:
+	// Formats the dump lines byte by byte with a custom formatter.
+	template<std::size_t BYTES_PER_LINE, typename OUT_FUNC, typename TO_HEX_FUNC>
+	std::size_t DumpLines(std::size_t size, OUT_FUNC funcOutput, TO_HEX_FUNC funcToHex) const
+	{
 		const auto* pData = RCast<const std::uint8_t*>();
 
 		std::string sLine;
@@ -213,15 +510,13 @@ public:
 			}
 		}
 
-		// Handle final partial line.
+		// Handle final partial line: its hex column is padded as in the default format (see GetMemDumpSize).
 		if (!sLine.empty())
 		{
-			std::size_t pad = kCharsPerLine - (size % kCharsPerLine);
+			const std::size_t nMissing = (BYTES_PER_LINE - size % BYTES_PER_LINE) % BYTES_PER_LINE;
 
-			for (std::size_t i = 0; i < pad; ++i)
-				sLine += "   ";
-
-			sLine += (pad ? "|" : " |") + sFormated + "|\n";
+			sLine.append(nMissing * 3, ' ');
+			sLine += (nMissing ? "|" : " |") + sFormated + "|\n";
 			funcOutput(sLine);
 			nOutputCount++;
 		}
@@ -229,7 +524,6 @@ public:
 		return nOutputCount++;
 	}
 
-protected:
 	union
 	{
 		void* m_ptr;
@@ -0,0 +1,225 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_MEMSOURCE_HPP
+#define DYNLIBUTILS_MEMSOURCE_HPP
+
+#pragma once
+
+#include "memaddr.hpp"
+#include "module.hpp"
+#include "regions.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace DynLibUtils {
+
+#ifdef _WIN32
+using ProcessId_t = unsigned long;
+#else
+using ProcessId_t = int;
+#endif
+
+// The memory of a process to read from: this one, or another one (a running server inspected by
+// a watchdog) through process_vm_readv on Linux, ReadProcessMemory on Windows and
+// mach_vm_read_overwrite on macOS. The addresses are the ones of the process.
+//
+// Remote reads are split into 64 KiB page-aligned pieces passed in one system call (iovecs on
+// Linux), so that an unmapped page stops a read at the piece before it. FindPattern() reads a
+// range in windows into a reusable buffer and runs the SIMD scan of CModule::FindPattern() over
+// them (see CPatternMatcher), carrying the pattern size less one byte of a window into the next
+// so the matches across their boundaries are found. The local source scans in place.
+// On Linux, a remote scan of 32 MiB takes about 1.25x the time of the local one (tests/memsource.cpp).
+//
+// Reading another process needs the right to: the same user and a ptrace scope which allows it
+// (e.g. a parent with its child) on Linux, PROCESS_VM_READ on Windows, task_for_pid() on macOS.
+//
+// Example usage:
+//
+//   CMemorySource server(nServerPid);
+//
+//   CMemory pFunc = server.FindPattern(ParseStringPattern("55 48 89 E5 ? ? 41"), "libserver.so");
+//
+//   int nTickCount;
+//   if (server.Read(pGlobals + 0x18, nTickCount))
+//       ...
+class CMemorySource
+{
+public:
+	static constexpr std::size_t sm_nPieceSize = 64 * 1024;   // Of a remote read.
+	static constexpr std::size_t sm_nWindowSize = 256 * 1024; // Read at a time by the scans.
+
+	CMemorySource();                          // This process.
+	explicit CMemorySource(ProcessId_t nPid); // Another one (or this one).
+	~CMemorySource();
+
+	CMemorySource(const CMemorySource&) = delete;
+	CMemorySource& operator=(const CMemorySource&) = delete;
+
+	bool IsValid() const noexcept { return m_bValid; } // The process could be opened.
+	bool IsLocal() const noexcept { return m_bLocal; }
+	ProcessId_t GetPid() const noexcept { return m_nPid; }
+
+	// Reads memory. Returns the number of bytes read, fewer than asked if an unreadable page is met.
+	std::size_t Read(const CMemory pAddress, void* pBuffer, std::size_t nSize) const;
+
+	template<typename T>
+	bool Read(const CMemory pAddress, T& value) const { return Read(pAddress, &value, sizeof(T)) == sizeof(T); }
+
+	struct ReadRequest_t
+	{
+		std::uintptr_t m_pAddress;
+		void* m_pBuffer;
+		std::size_t m_nSize;
+		std::size_t m_nRead; // Set by ReadBatch().
+	};
+
+	// Reads many ranges in as few system calls as possible. Returns the number of fully read ones.
+	std::size_t ReadBatch(ReadRequest_t* pRequests, std::size_t nCount) const;
+
+	// Gets the mapped regions of the process, sorted by address.
+	bool GetRegions(std::vector<Region_t>& vecRegions) const;
+
+	// Gets the regions of the process which map a module, by its file name (or path).
+	bool GetModuleRegions(const std::string_view svModuleName, std::vector<Region_t>& vecRegions) const;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Finds an array of bytes in a range of the process
+	// Input  : *pPattern
+	//          svMask
+	//          pBegin
+	//          pEnd
+	// Output : CMemory
+	//-----------------------------------------------------------------------------
+	template<std::size_t SIZE = (s_nDefaultPatternSize - 1) / 2>
+	CMemory FindPattern(const std::uint8_t* pPattern, const std::string_view svMask, const CMemory pBegin, const CMemory pEnd)
+	{
+		const CPatternMatcher<SIZE> matcher(pPattern, svMask);
+
+		const auto pRangeBegin = static_cast<std::uintptr_t>(pBegin.GetAddr()), pRangeEnd = static_cast<std::uintptr_t>(pEnd.GetAddr());
+		const std::size_t patternSize = matcher.GetSize();
+
+		if (!patternSize || pRangeEnd < pRangeBegin || pRangeEnd - pRangeBegin < patternSize)
+			return DYNLIB_INVALID_MEMORY;
+
+		// Whole blocks are read at every position: the last ones are scanned in the buffer, where they are followed by some slack.
+		m_vecBuffer.resize(sm_nWindowSize + patternSize + matcher.GetReadSize());
+
+		if (m_bLocal)
+		{
+			if (!CRegionMap::Get().IsReadable(pRangeBegin, pRangeEnd - pRangeBegin))
+				return DYNLIB_INVALID_MEMORY;
+
+			const std::uintptr_t pLast = pRangeEnd - patternSize;
+			std::uintptr_t pTail = pRangeBegin;
+
+			if (pRangeEnd - pRangeBegin > matcher.GetReadSize())
+			{
+				pTail = pRangeEnd - matcher.GetReadSize() + 1;
+
+				if (const auto* pFound = matcher.Find(reinterpret_cast<const std::uint8_t*>(pRangeBegin), reinterpret_cast<const std::uint8_t*>(pTail - 1)))
+					return reinterpret_cast<std::uintptr_t>(pFound);
+			}
+
+			if (pTail > pLast)
+				return DYNLIB_INVALID_MEMORY;
+
+			std::memcpy(m_vecBuffer.data(), reinterpret_cast<const void*>(pTail), pRangeEnd - pTail);
+
+			const auto* pFound = matcher.Find(m_vecBuffer.data(), m_vecBuffer.data() + (pLast - pTail));
+
+			return pFound ? CMemory(pTail + static_cast<std::uintptr_t>(pFound - m_vecBuffer.data())) : DYNLIB_INVALID_MEMORY;
+		}
+
+		const std::size_t nCarryMax = patternSize - 1;
+
+		std::uint8_t* pBuffer = m_vecBuffer.data();
+		std::size_t nCarry = 0;
+
+		for (std::uintptr_t p = pRangeBegin; p < pRangeEnd; )
+		{
+			const std::size_t nWanted = std::min<std::size_t>(sm_nWindowSize, pRangeEnd - p);
+			const std::size_t nRead = Read(p, pBuffer + nCarry, nWanted);
+			const std::size_t nData = nCarry + nRead;
+
+			if (nData >= patternSize)
+			{
+				if (const auto* pFound = matcher.Find(pBuffer, pBuffer + nData - patternSize))
+					return p - nCarry + static_cast<std::uintptr_t>(pFound - pBuffer);
+			}
+
+			if (nRead < nWanted) // Skips the unreadable piece.
+			{
+				nCarry = 0;
+				p = ((p + nRead) & ~(sm_nPieceSize - 1)) + sm_nPieceSize;
+
+				continue;
+			}
+
+			p += nRead;
+			nCarry = std::min(nCarryMax, nData);
+			std::memmove(pBuffer, pBuffer + nData - nCarry, nCarry);
+		}
+
+		return DYNLIB_INVALID_MEMORY;
+	}
+
+	template<std::size_t SIZE>
+	CMemory FindPattern(const Pattern_t<SIZE>& pattern, const CMemory pBegin, const CMemory pEnd)
+	{
+		return FindPattern<SIZE>(pattern.m_aBytes.data(), std::string_view(pattern.m_aMask.data(), pattern.m_nSize), pBegin, pEnd);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Finds an array of bytes in the executable regions of a module of the process
+	// Input  : pattern
+	//          svModuleName
+	// Output : CMemory
+	//-----------------------------------------------------------------------------
+	template<std::size_t SIZE>
+	CMemory FindPattern(const Pattern_t<SIZE>& pattern, const std::string_view svModuleName)
+	{
+		std::vector<Region_t> vecRegions;
+
+		if (!GetModuleRegions(svModuleName, vecRegions))
+			return DYNLIB_INVALID_MEMORY;
+
+		for (const auto& region : vecRegions)
+		{
+			if (!region.IsExecutable() || !region.IsReadable())
+				continue;
+
+			const CMemory pFound = FindPattern(pattern, region.m_pBegin, region.m_pEnd);
+
+			if (pFound.IsValid())
+				return pFound;
+		}
+
+		return DYNLIB_INVALID_MEMORY;
+	}
+
+private:
+	// Platform ones.
+	static ProcessId_t GetCurrentPid() noexcept;
+	bool Open();
+	void Close() noexcept;
+	std::size_t ReadRemote(std::uintptr_t pAddress, void* pBuffer, std::size_t nSize) const;
+	std::size_t ReadBatchRemote(ReadRequest_t* pRequests, std::size_t nCount) const;
+
+	ProcessId_t m_nPid;
+	std::uintptr_t m_hProcess = 0; // A handle (Windows), a task port (macOS).
+	bool m_bLocal;
+	bool m_bValid;
+
+	std::vector<std::uint8_t> m_vecBuffer; // Of the scans.
+}; // class CMemorySource
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_MEMSOURCE_HPP
@@ -13,6 +13,7 @@
 
 #include <emmintrin.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <string>
@@ -41,14 +42,43 @@ namespace DynLibUtils {
 
 struct Section_t : public CMemory // Start address of the section.
 {
+	// Access flags of the section (as mapped).
+	enum Flags_t : std::uint8_t
+	{
+		Readable   = 1 << 0,
+		Writable   = 1 << 1,
+		Executable = 1 << 2,
+	};
+
 	// Constructors.
-	Section_t(CMemory pSectionBase = nullptr, size_t nSectionSize = 0, const std::string_view& svSectionName = {}) noexcept : CMemory(pSectionBase), m_nSectionSize(nSectionSize), m_svSectionName(svSectionName) {} // Default one.
+	Section_t(CMemory pSectionBase = nullptr, size_t nSectionSize = 0, const std::string_view& svSectionName = {}, std::uint8_t nFlags = Readable) noexcept : CMemory(pSectionBase), m_nSectionSize(nSectionSize), m_svSectionName(svSectionName), m_nFlags(nFlags) {} // Default one.
 	Section_t(Section_t&& other) noexcept = default;
 
+	bool IsWritable() const noexcept { return m_nFlags & Writable; }
+	bool IsExecutable() const noexcept { return m_nFlags & Executable; }
+	bool Contains(const CMemory pAddress) const noexcept { return GetAddr() <= pAddress.GetAddr() && static_cast<std::size_t>(pAddress.GetAddr() - GetAddr()) < m_nSectionSize; }
+
 	std::size_t m_nSectionSize;     // Size of the section.
 	std::string m_svSectionName;    // Name of the section.
+	std::uint8_t m_nFlags;          // Flags_t of the section.
 }; // struct Section_t
 
+struct Import_t
+{
+	std::string_view m_svName; // Name of the symbol (points into the string table of the loaded module).
+	CMemory m_pSlot;           // GOT/IAT slot the calls go through (void**).
+	CMemory m_pTarget;         // Function the symbol resolves to (even if a lazy slot is not bound yet).
+	bool m_bWritable;          // The slot is writable as loaded (lazy binding), no protection change is needed.
+}; // struct Import_t
+
+// A function range from the unwind tables (.eh_frame_hdr, .pdata), as offsets from the module base.
+// Mach-O modules are not indexed.
+struct FunctionRange_t
+{
+	std::uint32_t m_nBegin;
+	std::uint32_t m_nEnd;
+}; // struct FunctionRange_t
+
 static constexpr std::size_t s_nDefaultPatternSize = 128;
 static constexpr std::size_t s_nMaxSimdBlocks = 1 << 6; // 64 blocks = 1024 bytes per chunk.
 
@@ -69,6 +99,117 @@ struct Pattern_t
 	std::array<char, SIZE> m_aMask;
 }; // struct Pattern_t
 
+// A pattern compiled for a SIMD scan: its 16-byte blocks are compared at every position of a
+// buffer, with a bit mask of their significant bytes. CModule::FindPattern() scans sections and
+// CMemorySource::FindPattern() the chunks read from a process with it.
+template<std::size_t SIZE = (s_nDefaultPatternSize - 1) / 2>
+class CPatternMatcher
+{
+public:
+	static constexpr std::size_t sm_nBlockSize = sizeof(__m128i); // 128 bits = 16 bytes.
+	static constexpr std::size_t sm_nMaxBlocks = std::max<std::size_t>(1u, std::min<std::size_t>(SIZE, s_nMaxSimdBlocks));
+
+	CPatternMatcher(const std::uint8_t* pPattern, const std::string_view svMask) noexcept : m_nSize(svMask.size()), m_nBlocks((svMask.size() + (sm_nBlockSize - 1)) / sm_nBlockSize)
+	{
+		for (std::size_t n = 0; n < m_nBlocks; ++n)
+		{
+			const std::size_t offset = n * sm_nBlockSize;
+			m_aChunks[n] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPattern + offset));
+
+			for (std::size_t j = 0; j < sm_nBlockSize; ++j)
+			{
+				const std::size_t idx = offset + j;
+				if (idx >= m_nSize)
+					break;
+
+				if (svMask[idx] == 'x')
+					m_aBitMasks[n] |= (1u << j);
+			}
+		}
+	}
+
+	std::size_t GetSize() const noexcept { return m_nSize; }
+	std::size_t GetReadSize() const noexcept { return m_nBlocks * sm_nBlockSize; } // Bytes read at a position (whole blocks).
+
+	[[always_inline]]
+	inline bool IsMatching(const std::uint8_t* pData) const noexcept
+	{
+		for (std::size_t n = 0; n < m_nBlocks; ++n)
+		{
+			const __m128i dataChunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + n * sm_nBlockSize));
+			const __m128i cmp = _mm_cmpeq_epi8(dataChunk, m_aChunks[n]);
+			const int mask = _mm_movemask_epi8(cmp);
+
+			if ((mask & m_aBitMasks[n]) != m_aBitMasks[n])
+				return false;
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Finds the first position of [pData, pLast] where the pattern matches
+	// Input  : pData
+	//          pLast - GetReadSize() bytes are read from each position
+	// Output : const std::uint8_t* (nullptr if none)
+	//-----------------------------------------------------------------------------
+	[[always_inline, flatten, hot]]
+	inline const std::uint8_t* Find(const std::uint8_t* pData, const std::uint8_t* pLast) const noexcept
+	{
+		// How far ahead (in bytes) to prefetch during scanning.
+		// This is calculated based on how many SIMD blocks (16 bytes each) will be read 
+		// in the current pattern match attempt.
+		//
+		// Helps reduce cache misses during large linear memory scans by hinting the CPU 
+		// to load the next block of memory before it is needed.
+		const std::size_t lookAhead = GetReadSize();
+
+		for (; pData <= pLast; ++pData)
+		{
+			if (static_cast<std::size_t>(pLast - pData) > lookAhead)
+				_mm_prefetch(reinterpret_cast<const char*>(pData + lookAhead), _MM_HINT_NTA);
+
+			if (IsMatching(pData))
+				return pData;
+		}
+
+		return nullptr;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Finds the last position of [pFirst, pData] where the pattern matches
+	// Input  : pFirst
+	//          pData
+	// Output : const std::uint8_t* (nullptr if none)
+	//-----------------------------------------------------------------------------
+	[[always_inline, flatten, hot]]
+	inline const std::uint8_t* FindReverse(const std::uint8_t* pFirst, const std::uint8_t* pData) const noexcept
+	{
+		// Same as the forward scan, the cache lines below are requested ahead.
+		const std::size_t lookBehind = GetReadSize();
+
+		for (;; --pData)
+		{
+			if (static_cast<std::size_t>(pData - pFirst) > lookBehind)
+				_mm_prefetch(reinterpret_cast<const char*>(pData - lookBehind), _MM_HINT_NTA);
+
+			if (IsMatching(pData))
+				return pData;
+
+			if (pData == pFirst)
+				break;
+		}
+
+		return nullptr;
+	}
+
+private:
+	std::size_t m_nSize;
+	std::size_t m_nBlocks;
+	std::uint16_t m_aBitMasks[sm_nMaxBlocks] = {};
+	__m128i m_aChunks[sm_nMaxBlocks];
+}; // class CPatternMatcher<SIZE>
+
 // Concept for pattern callback.
 // Signature: bool callback(std::size_t index, CMemory match)
 // Returns:   false -> stop scanning.
@@ -278,12 +419,17 @@ public:
 		[[nodiscard]] CMemory OffsetAndFind(const std::ptrdiff_t offset, CMemory pStart, const Section_t* pSection = nullptr) const { return Find(pStart + offset, pSection); }
 		[[nodiscard]] CMemory OffsetFromSelfAndFind(const CMemory pStart, const Section_t* pSection = nullptr) const { return OffsetAndFind(Base_t::m_nSize, pStart, pSection); }
 		[[nodiscard]] CMemory DerefAndFind(const std::uintptr_t deref, CMemory pStart, const Section_t* pSection = nullptr) const { return Find(pStart.Deref(deref), pSection); }
+		[[nodiscard]] CMemory FindReverse(const CMemory pStart, const Section_t* pSection = nullptr) const
+		{
+			return m_pModule->FindPatternReverse<SIZE>(CMemory(Base_t::m_aBytes.data()), std::string_view(Base_t::m_aMask.data(), Base_t::m_nSize), pStart, pSection);
+		}
 	}; // class CSignatureView<SIZE>
 
 private:
 	std::string m_sPath;
 	std::string m_sLastError;
 	std::vector<Section_t> m_vecSections;
+	std::vector<FunctionRange_t> m_vecFunctions; // Sorted by m_nBegin.
 
 	const Section_t *m_pExecutableSection;
 
@@ -293,7 +439,7 @@ public:
 
 	CModule(const CModule&) = delete;
 	CModule& operator=(const CModule&) = delete;
-	CModule(CModule&& other) noexcept : CMemory(std::exchange(static_cast<CMemory &>(other), DYNLIB_INVALID_MEMORY)), m_sPath(std::move(other.m_sPath)), m_vecSections(std::move(other.m_vecSections)), m_pExecutableSection(std::move(other.m_pExecutableSection)) {}
+	CModule(CModule&& other) noexcept : CMemory(std::exchange(static_cast<CMemory &>(other), DYNLIB_INVALID_MEMORY)), m_sPath(std::move(other.m_sPath)), m_vecSections(std::move(other.m_vecSections)), m_vecFunctions(std::move(other.m_vecFunctions)), m_pExecutableSection(std::move(other.m_pExecutableSection)) {}
 	CModule(const CMemory pModuleMemory);
 	explicit CModule(const std::string_view svModuleName);
 	explicit CModule(const char* pszModuleName) : CModule(std::string_view(pszModuleName)) {}
@@ -357,78 +503,86 @@ public:
 			pData = start;
 		}
 
-		constexpr auto kSimdBytes = sizeof(__m128i); // 128 bits = 16 bytes.
-		constexpr auto kMaxSimdBlocks = std::max<std::size_t>(1u, std::min<std::size_t>(SIZE, s_nMaxSimdBlocks));
+		const CPatternMatcher<SIZE> matcher(pPattern, svMask);
 
-		const std::size_t numBlocks = (patternSize + (kSimdBytes - 1)) / kSimdBytes;
+		if (const auto* pFound = matcher.Find(pData, pEnd))
+			return const_cast<std::uint8_t*>(pFound);
 
-		std::uint16_t bitMasks[kMaxSimdBlocks] = {};
-		__m128i patternChunks[kMaxSimdBlocks];
+		return DYNLIB_INVALID_MEMORY;
+	}
 
-		for (std::size_t n = 0; n < numBlocks; ++n)
-		{
-			const std::size_t offset = n * kSimdBytes;
-			patternChunks[n] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPattern + offset));
+	template<std::size_t SIZE>
+	[[nodiscard]]
+	inline CMemory FindPattern(const Pattern_t<SIZE>& copyPattern, const CMemory pStartAddress = nullptr, const Section_t* pModuleSection = nullptr) const
+	{
+		return FindPattern<SIZE>(copyPattern.m_aBytes.data(), std::string_view(copyPattern.m_aMask.data(), copyPattern.m_nSize), pStartAddress, pModuleSection);
+	}
 
-			for (std::size_t j = 0; j < kSimdBytes; ++j)
-			{
-				const std::size_t idx = offset + j;
-				if (idx >= patternSize)
-					break;
+	template<std::size_t SIZE>
+	[[nodiscard]]
+	inline CMemory FindPattern(Pattern_t<SIZE>&& movePattern, const CMemory pStartAddress = nullptr, const Section_t* pModuleSection = nullptr) const
+	{
+		return FindPattern<SIZE>(std::move(movePattern.m_aBytes).data(), std::string_view(std::move(movePattern.m_aMask).data(), std::move(movePattern.m_nSize)), pStartAddress, pModuleSection);
+	}
 
-				if (svMask[idx] == 'x')
-					bitMasks[n] |= (1u << j);
-			}
-		}
+	//-----------------------------------------------------------------------------
+	// Purpose: Finds an array of bytes backwards in process memory using SIMD
+	//          instructions: the nearest match at or before pStartAddress
+	// Input  : *pPattern
+	//          svMask
+	//          pStartAddress - the highest address to test (the section end if null)
+	//          *pModuleSection
+	// Output : CMemory
+	//-----------------------------------------------------------------------------
+	template<std::size_t SIZE = (s_nDefaultPatternSize - 1) / 2>
+	[[always_inline, flatten, hot]]
+	inline CMemory FindPatternReverse(const CMemoryView<std::uint8_t> pPatternMem, const std::string_view svMask, const CMemory pStartAddress, const Section_t* pModuleSection) const
+	{
+		const auto* pPattern = pPatternMem.RCastView();
 
-		// How far ahead (in bytes) to prefetch during scanning.
-		// This is calculated based on how many SIMD blocks (16 bytes each) will be read 
-		// in the current pattern match attempt.
-		//
-		// Helps reduce cache misses during large linear memory scans by hinting the CPU 
-		// to load the next block of memory before it is needed.
-		const std::size_t lookAhead = numBlocks * kSimdBytes;
+		const Section_t* pSection = pModuleSection ? pModuleSection : m_pExecutableSection;
 
-		for (; pData <= pEnd; ++pData)
-		{
-			if (static_cast<std::size_t>(pEnd - pData) > lookAhead)
-				_mm_prefetch(reinterpret_cast<const char*>(pData + lookAhead), _MM_HINT_NTA);
+		if (!pSection || !pSection->IsValid())
+			return DYNLIB_INVALID_MEMORY;
 
-			bool bFound = true;
+		const std::size_t sectionSize = pSection->m_nSectionSize;
+		const std::size_t patternSize = svMask.size();
 
-			for (std::size_t n = 0; n < numBlocks; ++n)
-			{
-				const __m128i dataChunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + n * kSimdBytes));
-				const __m128i cmp = _mm_cmpeq_epi8(dataChunk, patternChunks[n]);
-				const int mask = _mm_movemask_epi8(cmp);
+		if (sectionSize < patternSize)
+			return DYNLIB_INVALID_MEMORY;
 
-				if ((mask & bitMasks[n]) != bitMasks[n])
-				{
-					bFound = false;
-					break;
-				}
-			}
+		const auto* pBegin = pSection->RCast<std::uint8_t*>();
+		auto* pData = pBegin + sectionSize - patternSize;
 
-			if (bFound)
-				return pData;
+		if (pStartAddress)
+		{
+			const auto* start = pStartAddress.RCast<const std::uint8_t*>();
+			if (start < pBegin)
+				return DYNLIB_INVALID_MEMORY;
+
+			pData = std::min(pData, start);
 		}
 
+		const CPatternMatcher<SIZE> matcher(pPattern, svMask);
+
+		if (const auto* pFound = matcher.FindReverse(pBegin, pData))
+			return const_cast<std::uint8_t*>(pFound);
+
 		return DYNLIB_INVALID_MEMORY;
 	}
 
 	template<std::size_t SIZE>
 	[[nodiscard]]
-	inline CMemory FindPattern(const Pattern_t<SIZE>& copyPattern, const CMemory pStartAddress = nullptr, const Section_t* pModuleSection = nullptr) const
+	inline CMemory FindPatternReverse(const Pattern_t<SIZE>& copyPattern, const CMemory pStartAddress = nullptr, const Section_t* pModuleSection = nullptr) const
 	{
-		return FindPattern<SIZE>(copyPattern.m_aBytes.data(), std::string_view(copyPattern.m_aMask.data(), copyPattern.m_nSize), pStartAddress, pModuleSection);
+		return FindPatternReverse<SIZE>(const_cast<std::uint8_t*>(copyPattern.m_aBytes.data()), std::string_view(copyPattern.m_aMask.data(), copyPattern.m_nSize), pStartAddress, pModuleSection);
 	}
 
-	template<std::size_t SIZE>
-	[[nodiscard]]
-	inline CMemory FindPattern(Pattern_t<SIZE>&& movePattern, const CMemory pStartAddress = nullptr, const Section_t* pModuleSection = nullptr) const
-	{
-		return FindPattern<SIZE>(std::move(movePattern.m_aBytes).data(), std::string_view(std::move(movePattern.m_aMask).data(), std::move(movePattern.m_nSize)), pStartAddress, pModuleSection);
-	}
+	// Finds the start of the function containing an address: from the unwind tables when they
+	// know the function, otherwise the nearest preceding 16-byte aligned prologue after padding
+	// (int3, nop) or a ret, at most nMaxDistance bytes before it. Without unwind tables, a leaf
+	// function which starts with no prologue yields the enclosing function, if any.
+	[[nodiscard]] CMemory FindFunctionStart(const CMemory pAddress, const std::size_t nMaxDistance = 0x10000) const;
 
 	template<std::size_t SIZE, PatternCallback_t FUNC>
 	[[nodiscard]]
@@ -463,7 +617,12 @@ public:
 	}
 
 	[[nodiscard]] CMemory GetVirtualTableByName(const std::string_view svTableName, bool bDecorated = false) const;
+	[[nodiscard]] std::vector<CMemory> GetVirtualTablesByMethod(const CMemory pFunction, const std::ptrdiff_t nIndex) const;
 	[[nodiscard]] CMemory GetFunctionByName(const std::string_view svFunctionName) const noexcept;
+#ifndef __APPLE__ // Mach-O symbol pointers and chained fixups are not parsed.
+	[[nodiscard]] std::vector<Import_t> GetImports(const std::string_view svSymbolName = {}) const; // All imports, or the ones of a symbol.
+	[[nodiscard]] static std::vector<Import_t> GetLoadedImports(const std::string_view svSymbolName); // Imports of a symbol by every loaded module.
+#endif
 
 	[[nodiscard]] void* GetHandle() const noexcept { return GetPtr(); }
 	[[nodiscard]] CMemory GetBase() const noexcept;
@@ -478,6 +637,64 @@ public:
 
 		return nullptr;
 	}
+	[[nodiscard]] const Section_t *GetSectionByAddress(const CMemory pAddress) const
+	{
+		for (const auto& section : m_vecSections)
+			if (section.Contains(pAddress))
+				return &section;
+
+		return nullptr;
+	}
+	[[nodiscard]] const std::vector<Section_t>& GetSections() const noexcept { return m_vecSections; }
+	[[nodiscard]] const std::vector<FunctionRange_t>& GetFunctions() const noexcept { return m_vecFunctions; } // Empty on macOS (__unwind_info is not parsed).
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Finds the function containing an address in the unwind tables, as
+	//          a range which FindPattern() and FindAllPatterns() can scan
+	// Input  : pAddress
+	// Output : Section_t (invalid if the address is not in a known function,
+	//          always on macOS where the functions are not indexed)
+	//-----------------------------------------------------------------------------
+	[[nodiscard]] Section_t GetFunctionRange(const CMemory pAddress) const
+	{
+		const std::uintptr_t base = GetBase().GetAddr();
+		const std::uintptr_t address = pAddress.GetAddr();
+
+		if (address < base || address - base > UINT32_MAX)
+			return {};
+
+		const auto offset = static_cast<std::uint32_t>(address - base);
+
+		auto it = std::upper_bound(m_vecFunctions.cbegin(), m_vecFunctions.cend(), offset, [](std::uint32_t value, const FunctionRange_t& range) { return value < range.m_nBegin; });
+
+		if (it == m_vecFunctions.cbegin() || offset >= (--it)->m_nEnd)
+			return {};
+
+		return Section_t(base + it->m_nBegin, it->m_nEnd - it->m_nBegin, {}, Section_t::Readable | Section_t::Executable);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Returns the span covering all executable sections
+	// Output : std::pair<CMemory, CMemory> ([begin, end), both invalid if none)
+	//-----------------------------------------------------------------------------
+	[[nodiscard]] std::pair<CMemory, CMemory> GetExecutableRange() const
+	{
+		std::uintptr_t begin = ~std::uintptr_t(0), end = 0;
+
+		for (const auto& section : m_vecSections)
+		{
+			if (!section.IsExecutable() || !section.m_nSectionSize)
+				continue;
+
+			begin = std::min<std::uintptr_t>(begin, section.GetAddr());
+			end = std::max<std::uintptr_t>(end, section.GetAddr() + section.m_nSectionSize);
+		}
+
+		if (begin >= end)
+			return {DYNLIB_INVALID_MEMORY, DYNLIB_INVALID_MEMORY};
+
+		return {begin, end};
+	}
 
 protected:
 	void SaveLastError();
@@ -0,0 +1,91 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_POINTERPATH_HPP
+#define DYNLIBUTILS_POINTERPATH_HPP
+
+#pragma once
+
+#include "memaddr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace DynLibUtils {
+
+// A multi-level pointer chain: base + o0 -> deref -> + o1 -> deref ... -> + oN, that is
+// CMemory(base).Deref(1, o0).Deref(1, o1)...Offset(oN) with the offsets compiled once.
+//
+// The links read by the last resolution are cached. Resolve() prefetches every cached slot (their
+// addresses are known from the cache, so the cache misses overlap instead of being paid one after
+// another), then compares the links in order up to the first changed one, whose slot and the
+// following ones are read again. A slot is never read once a link before it has changed.
+//
+// ResolveBatch() resolves many paths together: the cached slots of every path are prefetched
+// before being validated, and the chains which must be walked advance one level at a time in
+// turn, prefetching the slot of their next level in the meantime.
+//
+// A checked path looks every slot up in the process region map (see CRegionMap) before reading
+// it, so a stale link yields DYNLIB_INVALID_MEMORY instead of a crash.
+//
+// Example usage:
+//
+//   CPointerPath pathHealth(pServerGlobals, {0x58, 0x10, 0x340}); // [[globals + 0x58] + 0x10] + 0x340
+//
+//   CPointerPath::ResolveBatch(vecPaths); // Every tick.
+//   int nHealth = pathHealth.GetResult().Get<int>();
+class CPointerPath
+{
+public:
+	CPointerPath() = default;
+	CPointerPath(const CMemory pBase, std::initializer_list<std::ptrdiff_t> listOffsets, bool bChecked = false) : CPointerPath(pBase, std::vector<std::ptrdiff_t>(listOffsets), bChecked) {}
+	CPointerPath(const CMemory pBase, const std::vector<std::ptrdiff_t>& vecOffsets, bool bChecked = false);
+
+	// Resolves the path through the cached links. Returns DYNLIB_INVALID_MEMORY if a link is null (or unmapped when checked).
+	CMemory Resolve();
+
+	// Resolves the path walking every link (the cache is neither used nor updated).
+	CMemory ResolveUncached() const;
+
+	// Resolves many paths (see above). Returns the number of valid ones.
+	static std::size_t ResolveBatch(CPointerPath* pPaths, std::size_t nCount);
+	static std::size_t ResolveBatch(std::vector<CPointerPath>& vecPaths) { return ResolveBatch(vecPaths.data(), vecPaths.size()); }
+
+	// Drops the cached links (e.g. on a map change).
+	void Invalidate() noexcept { m_nCachedLinks = 0; m_pResult = nullptr; }
+
+	CMemory GetBase() const noexcept { return m_pBase; }
+	CMemory GetResult() const noexcept { return m_pResult; } // The last resolved address.
+	std::size_t GetLevels() const noexcept { return m_vecLinks.size(); } // The number of dereferences.
+
+private:
+	struct Link_t
+	{
+		std::ptrdiff_t m_nOffset; // Added before the dereference.
+		std::uintptr_t m_pSlot;   // Cached address read.
+		std::uintptr_t m_pValue;  // Cached pointer read there.
+	};
+
+	bool Read(std::uintptr_t pSlot, std::uintptr_t& pValue) const;
+
+	std::size_t Validate() const;       // Returns the number of leading links which are unchanged.
+	void Prefetch() const noexcept;     // Prefetches the cached slots.
+	std::uintptr_t GetLinkBase(std::size_t nLink) const noexcept { return nLink ? m_vecLinks[nLink - 1].m_pValue : static_cast<std::uintptr_t>(m_pBase.GetAddr()); }
+	bool Step();                        // Reads the next link after the cached ones. Returns false on a null/unmapped link.
+	CMemory Finish() noexcept;          // Computes the result once every link is cached.
+
+	CMemory m_pBase;
+	std::vector<Link_t> m_vecLinks;
+	std::ptrdiff_t m_nFinalOffset = 0;
+
+	std::size_t m_nCachedLinks = 0;
+	CMemory m_pResult;
+	bool m_bChecked = false;
+}; // class CPointerPath
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_POINTERPATH_HPP
@@ -0,0 +1,81 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_POINTERSCAN_HPP
+#define DYNLIBUTILS_POINTERSCAN_HPP
+
+#pragma once
+
+#include "memaddr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace DynLibUtils {
+
+class CModule;
+
+// A reverse pointer scanner: finds the 8-byte aligned slots of a set of memory ranges whose value
+// points into [pBegin, pEnd), e.g. the globals which hold a singleton, or who still references a
+// leaked block. The same sweep finds the slots holding one of a set of values, such as the live
+// objects of a class and of its subclasses by their vptrs.
+//
+// The ranges are the writable sections of modules (.data, .bss, relocated read-only data) and,
+// optionally, every writable region of the process (see CRegionMap). They are split into chunks
+// swept by several threads with SIMD range compares (AVX2 when the CPU has it), and the slots are
+// returned as one array sorted by address.
+//
+// The process regions are taken from a fresh map, but one unmapped by another thread during the
+// scan still faults: scan the process while it is quiet.
+//
+// Example usage:
+//
+//   CPointerScanner scanner;
+//   scanner.AddModule(server);
+//
+//   for (const auto& pSlot : scanner.Find(pSingleton, pSingleton + sizeof(CGameRules)))
+//       ...
+//
+//   scanner.AddWritableRegions();
+//
+//   auto vecEntities = scanner.FindInstances({server.GetVirtualTableByName("CBaseEntity"), ...}, sizeof(void*));
+class CPointerScanner
+{
+public:
+	explicit CPointerScanner(std::size_t nThreads = 0) : m_nThreads(nThreads) {} // 0 is the hardware concurrency.
+
+	void AddModule(const CModule& module); // Its writable sections.
+	void AddWritableRegions();             // Every writable region of the process.
+	void AddRange(const CMemory pBegin, std::size_t nSize);
+	void Clear() noexcept { m_vecRanges.clear(); }
+
+	// Returns the slots of the ranges which point into [pBegin, pEnd), sorted by address.
+	std::vector<CMemory> Find(const CMemory pBegin, const CMemory pEnd) const;
+
+	// Returns the slots of the ranges which hold one of some values, sorted by address.
+	std::vector<CMemory> FindValues(const std::vector<CMemory>& vecValues) const;
+
+	// Returns the live objects of classes: the slots which hold one of their vptrs (see CModule::GetVirtualTableByName),
+	// optionally with nValidateSize bytes writable in the region map, sorted by address. Plain copies of
+	// the vptrs (the argument array, values spilled on stacks) are found as well.
+	std::vector<CMemory> FindInstances(const std::vector<CMemory>& vecVTables, std::size_t nValidateSize = 0) const;
+
+private:
+	struct Range_t
+	{
+		std::uintptr_t m_pBegin;
+		std::uintptr_t m_pEnd;
+	};
+
+	std::vector<CMemory> Scan(std::uintptr_t pLow, std::uintptr_t nSize, const std::function<bool (std::uintptr_t pSlot)>& funcFilter) const;
+
+	std::size_t m_nThreads;
+	std::vector<Range_t> m_vecRanges;
+}; // class CPointerScanner
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_POINTERSCAN_HPP
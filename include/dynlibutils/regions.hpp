@@ -0,0 +1,120 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_REGIONS_HPP
+#define DYNLIBUTILS_REGIONS_HPP
+
+#pragma once
+
+#include "memaddr.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace DynLibUtils {
+
+// A mapped range of the process address space.
+struct Region_t
+{
+	enum Flags_t : std::uint8_t
+	{
+		Readable   = 1 << 0,
+		Writable   = 1 << 1,
+		Executable = 1 << 2,
+	};
+
+	std::uintptr_t m_pBegin;
+	std::uintptr_t m_pEnd;
+	std::uint8_t m_nFlags;
+
+	bool IsReadable() const noexcept { return m_nFlags & Readable; }
+	bool IsWritable() const noexcept { return m_nFlags & Writable; }
+	bool IsExecutable() const noexcept { return m_nFlags & Executable; }
+};
+
+// A map of the process memory regions (/proc/self/maps, VirtualQuery, mach_vm_region), kept as an
+// array of intervals sorted by address, to check that a pointer may be dereferenced before doing
+// so: a lookup is a binary search (or a hit of the thread's last region) with no system call.
+//
+// The map is rebuilt when a module was loaded or unloaded since the last build (every lookup checks
+// it), and at most once per interval (see SetMissRefreshInterval) when a lookup misses, which catches
+// the memory mapped since then. A miss within the interval asks the system about the range itself
+// (one system call), so mapped memory is never reported unmapped. Adjacent regions with the same
+// access are merged.
+//
+// Memory unmapped since the last build is still reported mapped until the next one: call
+// Refresh(true) after freeing memory which checked reads may reach.
+//
+// Lookups are lock-free: the regions are an immutable snapshot published with an atomic pointer
+// and reclaimed through CEpoch, so a refresh never blocks the readers.
+//
+// Example usage:
+//
+//   if (CRegionMap::Get().IsReadable(pEntity, sizeof(Entity_t)))
+//       ...
+//
+//   CMemory pHealth = pGlobals.DerefChecked(2, 0x10); // DYNLIB_INVALID_MEMORY on an unmapped link.
+class CRegionMap final
+{
+public:
+	CRegionMap();
+	~CRegionMap();
+
+	CRegionMap(const CRegionMap&) = delete;
+	CRegionMap& operator=(const CRegionMap&) = delete;
+
+	// The process-wide map (used by the checked CMemory methods). It is never destroyed.
+	static CRegionMap& Get() { static CRegionMap* s_pMap = new CRegionMap(); return *s_pMap; }
+
+	// Rebuilds the map if the loaded modules changed since the last build (always with bForce). Returns true if it was rebuilt.
+	bool Refresh(bool bForce = false);
+
+	// A lookup miss refreshes the map at most once per interval (zero disables it, the misses are only probed). 100 ms by default.
+	void SetMissRefreshInterval(std::chrono::milliseconds interval) noexcept { m_nMissRefreshInterval.store(interval.count(), std::memory_order_relaxed); }
+
+	// Checks that every byte of [pAddress, pAddress + nSize) is mapped with (at least) the access of nFlags.
+	bool HasAccess(const CMemory pAddress, std::size_t nSize, std::uint8_t nFlags);
+
+	bool IsReadable(const CMemory pAddress, std::size_t nSize = 1) { return HasAccess(pAddress, nSize, Region_t::Readable); }
+	bool IsWritable(const CMemory pAddress, std::size_t nSize = 1) { return HasAccess(pAddress, nSize, Region_t::Writable); }
+	bool IsExecutable(const CMemory pAddress, std::size_t nSize = 1) { return HasAccess(pAddress, nSize, Region_t::Executable); }
+
+	// Gets the (merged) region which contains an address. Returns false if it is not mapped.
+	bool FindRegion(const CMemory pAddress, Region_t& region);
+
+	std::vector<Region_t> GetRegions(); // A copy of the current snapshot, sorted by address.
+
+private:
+	struct Snapshot_t
+	{
+		std::vector<Region_t> m_vecRegions;
+		std::uint64_t m_nSerial;     // Unique across the maps, for the per-thread cache.
+		std::uint64_t m_nGeneration; // Of the loaded modules.
+	};
+
+	// Platform ones.
+	static bool Collect(std::vector<Region_t>& vecRegions); // Sorted by address.
+	static std::uint64_t GetModuleGeneration(); // Changes when a module is loaded or unloaded.
+	static bool Probe(std::uintptr_t pAddress, std::size_t nSize, std::uint8_t nFlags, bool& bAccess); // Asks the system about a range. Returns false if it can't tell.
+
+	const Region_t* Lookup(const Snapshot_t* pSnapshot, std::uintptr_t pAddress) const noexcept;
+	bool CheckAccess(const Snapshot_t* pSnapshot, std::uintptr_t pAddress, std::size_t nSize, std::uint8_t nFlags) const noexcept;
+	void RefreshOnModuleChange();
+	bool RefreshOnMiss();
+
+	std::atomic<const Snapshot_t*> m_pSnapshot;
+	std::atomic<std::uint64_t> m_nGeneration;         // Of the snapshot, read without a guard.
+	std::atomic<std::int64_t> m_nLastRefresh;         // steady_clock ticks.
+	std::atomic<std::int64_t> m_nMissRefreshInterval; // Milliseconds.
+
+	std::mutex m_mutex; // Serializes the refreshes.
+}; // class CRegionMap
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_REGIONS_HPP
@@ -0,0 +1,112 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_SNAPSHOT_HPP
+#define DYNLIBUTILS_SNAPSHOT_HPP
+
+#pragma once
+
+#include "memaddr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DynLibUtils {
+
+// A changed range of the live memory, found by a diff.
+struct DiffRange_t
+{
+	CMemory m_pBegin;
+	std::size_t m_nSize;
+};
+
+// A copy of some memory ranges, to find the bytes which changed since, e.g. the fields written
+// by an in-game event. The copies are kept in one arena allocation, reused by the next Take(), and
+// Diff() compares them with the live memory 64 bytes at a time with SIMD (AVX2 when the CPU has
+// it), reporting the changed bytes as ranges.
+//
+// With dirty tracking (Linux soft-dirty bits), Take() clears the soft-dirty bits of the process
+// before copying, and Diff() reads them from /proc/self/pagemap to compare the pages written
+// since only: a diff of a large heap touches its dirty pages. The bits are process-wide, so:
+//  - clearing them write-protects every page of the process, and the first write to each page
+//    since faults once;
+//  - the Take() of another tracking snapshot clears them too, and a snapshot then compares its
+//    whole ranges (see IsTrackingDirty); so does one whose kernel has no soft-dirty support.
+//    Clearing them out of this class (writing to /proc/self/clear_refs) is not detected.
+//
+// The ranges which are not readable in the region map (see CRegionMap) are not copied, nor are
+// compared the ones which have been unmapped since.
+//
+// Example usage:
+//
+//   CMemorySnapshot snapshot(true);
+//   snapshot.AddWritableRegions();
+//   snapshot.Take();
+//
+//   ... // Fire the event.
+//
+//   for (const auto& change : snapshot.Diff(8))
+//       ...
+class CMemorySnapshot
+{
+public:
+	explicit CMemorySnapshot(bool bTrackDirty = false) : m_bTrackDirty(bTrackDirty) {}
+
+	void AddRange(const CMemory pBegin, std::size_t nSize);
+	void AddWritableRegions(); // Every writable region of the process.
+
+	// Drops the ranges and the copies.
+	void Clear() noexcept;
+
+	// Copies the ranges. Returns the number of bytes copied.
+	std::size_t Take();
+
+	// Compares the ranges with their copies. Returns the changed ranges sorted by address, the changes
+	// separated by at most nMergeGap unchanged bytes being reported as one.
+	std::vector<DiffRange_t> Diff(std::size_t nMergeGap = 0) const;
+
+	// Gets the copy of an address (to read the value it had). Returns DYNLIB_INVALID_MEMORY if it was not copied.
+	CMemory GetCopy(const CMemory pAddress) const;
+
+	std::size_t GetSize() const noexcept { return m_nCopiedSize; } // The number of bytes copied.
+
+	// Checks that Diff() skips the clean pages: tracking was requested, and the soft-dirty bits are
+	// supported and were not cleared by another snapshot since Take().
+	bool IsTrackingDirty() const noexcept;
+
+private:
+	struct Range_t
+	{
+		std::uintptr_t m_pBegin;
+		std::uintptr_t m_pEnd;
+		std::size_t m_nOffset; // Of the copy in the arena.
+		bool m_bCopied;
+	};
+
+	struct Span_t
+	{
+		std::uintptr_t m_pBegin;
+		std::uintptr_t m_pEnd;
+	};
+
+	// Platform ones.
+	static bool IsSoftDirtySupported();
+	static bool ClearSoftDirty();
+	static bool CollectDirtySpans(std::uintptr_t pBegin, std::uintptr_t pEnd, std::vector<Span_t>& vecSpans); // The dirty pages of a range, clipped to it.
+
+	std::vector<Range_t> m_vecRanges;
+
+	std::unique_ptr<std::uint8_t[]> m_pArena;
+	std::size_t m_nArenaSize = 0;
+	std::size_t m_nCopiedSize = 0;
+
+	bool m_bTrackDirty;
+	std::uint64_t m_nDirtyGeneration = 0; // Of the soft-dirty clear made by Take(), 0 if none.
+}; // class CMemorySnapshot
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_SNAPSHOT_HPP
@@ -0,0 +1,76 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_STRINGS_HPP
+#define DYNLIBUTILS_STRINGS_HPP
+
+#pragma once
+
+#include "memaddr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace DynLibUtils {
+
+class CModule;
+
+// An index of the literal strings of a module: every NUL-terminated run of printable ASCII
+// characters (tabs and line breaks included) of its read-only data sections (.rodata, .rdata, __cstring).
+//
+// The index is built on the first lookup by a SSE2 sweep over the sections. The strings are views
+// of the module memory (nothing is copied); exact lookups go through a hash map, prefix ones
+// through a lexicographically sorted order, and substring ones scan the views.
+//
+// A string merged by the linker into the tail of a longer one ("Name" of "GetName") is only found
+// as a substring. The module must outlive the index.
+//
+// Example usage:
+//
+//   CStringIndex strings(module);
+//   CXRefIndex xrefs(module);
+//
+//   CMemory pFunction = xrefs.GetUniqueReference(strings.Find("Failed to load %s\n"), XREF_DATA);
+class CStringIndex
+{
+public:
+	explicit CStringIndex(const CModule& module, std::size_t nMinLength = 4) : m_pModule(&module), m_nMinLength(nMinLength) {}
+
+	CStringIndex(const CStringIndex&) = delete;
+	CStringIndex& operator=(const CStringIndex&) = delete;
+
+	std::size_t GetCount() const { Build(); return m_vecStrings.size(); }
+	const std::vector<std::string_view>& GetStrings() const { Build(); return m_vecStrings; } // Sorted by address.
+
+	// Returns the lowest address of a string (DYNLIB_INVALID_MEMORY if there is none).
+	CMemory Find(const std::string_view svString) const;
+
+	// Returns every address of a string, in ascending order.
+	std::vector<CMemory> FindAll(const std::string_view svString) const;
+
+	// Returns the strings which start with a prefix, in ascending order of address.
+	std::vector<CMemory> FindByPrefix(const std::string_view svPrefix) const;
+
+	// Returns the strings which contain a substring, in ascending order of address.
+	std::vector<CMemory> FindBySubstring(const std::string_view svSubstring) const;
+
+private:
+	void Build() const;
+
+	const CModule* m_pModule;
+	std::size_t m_nMinLength;
+
+	mutable std::once_flag m_built;
+	mutable std::vector<std::string_view> m_vecStrings;                  // Sorted by address.
+	mutable std::vector<std::uint32_t> m_vecSorted;                      // Indices of m_vecStrings, sorted lexicographically.
+	mutable std::unordered_map<std::string_view, std::uint32_t> m_mapExact; // String -> its lowest index.
+}; // class CStringIndex
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_STRINGS_HPP
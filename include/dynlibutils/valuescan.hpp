@@ -0,0 +1,225 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_VALUESCAN_HPP
+#define DYNLIBUTILS_VALUESCAN_HPP
+
+#pragma once
+
+#include "memaddr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace DynLibUtils {
+
+class CModule;
+
+// A typed value scanner, as memory editors have it: finds the int32, int64, float or double values
+// of some memory ranges which are equal to a value or within [low, high] (or takes all of them when
+// the initial value is unknown), then narrows the candidates by further passes once the value
+// changed: equal to a new value, within a new range, changed, increased...
+//
+// The ranges are cut into 1 MB blocks swept by several threads with SIMD compares (AVX2 when the
+// CPU has it). The candidates of a block are kept as a bitmap of its elements while they are dense
+// and as an array of their indices once they are sparse, along with the values they had at the last
+// pass. A narrowing pass reads the surviving candidates only: the dense blocks are compared again
+// with SIMD, skipping the 64 elements without a candidate, the sparse ones one candidate at a time.
+//
+// The values are aligned to their size. The blocks which are no longer readable in the process
+// region map (see CRegionMap) are dropped by the next pass.
+//
+// Example usage:
+//
+//   CValueScanner scanner;
+//   scanner.AddWritableRegions();
+//
+//   scanner.FirstScan<std::int32_t>(100);             // The health.
+//   ...                                               // Take damage.
+//   scanner.NextScan(CValueScanner::Decreased);
+//   scanner.NextScan<std::int32_t>(75);
+//
+//   for (const auto& pHealth : scanner.GetCandidates(16))
+//       ...
+class CValueScanner
+{
+public:
+	enum Type_t : std::uint8_t
+	{
+		Int32,
+		Int64,
+		Float,
+		Double,
+	};
+
+	// Compares with the values of the last pass.
+	enum Compare_t : std::uint8_t
+	{
+		Changed,
+		Unchanged,
+		Increased,
+		Decreased,
+	};
+
+	union Value_t
+	{
+		Value_t(std::int32_t n) : m_nInt32(n) {}
+		Value_t(std::int64_t n) : m_nInt64(n) {}
+		Value_t(float fl) : m_flFloat(fl) {}
+		Value_t(double fl) : m_flDouble(fl) {}
+
+		std::int32_t m_nInt32;
+		std::int64_t m_nInt64;
+		float m_flFloat;
+		double m_flDouble;
+	};
+
+	explicit CValueScanner(std::size_t nThreads = 0) : m_nThreads(nThreads) {} // 0 is the hardware concurrency.
+
+	// The ranges of the first scan.
+	void AddModule(const CModule& module); // Its writable sections.
+	void AddWritableRegions();             // Every writable region of the process.
+	void AddRange(const CMemory pBegin, std::size_t nSize);
+
+	// Drops the candidates and the ranges.
+	void Clear() noexcept { m_vecRanges.clear(); m_vecBlocks.clear(); m_nCount = 0; }
+
+	// Starts a search for the values of T (4 or 8-byte integers, float or double) equal to a value,
+	// within [low, high], or any (an unknown initial value). Returns the number of candidates.
+	template<typename T> std::size_t FirstScan(T value) { return FirstScan(value, value); }
+	template<typename T> std::size_t FirstScan(T low, T high) { return First(TypeOf<T>(), ToValue(low), ToValue(high), false); }
+	template<typename T> std::size_t FirstScanUnknown() { return First(TypeOf<T>(), ToValue(T()), ToValue(T()), true); }
+
+	// Narrows the candidates to the ones now equal to a value, within [low, high], or comparing with
+	// their previous value. The values are converted to the type of the first scan (saturated when
+	// they do not fit), so NextScan(75) goes on with a search of int64s too. Returns the number of
+	// candidates.
+	template<typename T> std::size_t NextScan(T value) { return NextScan(value, value); }
+	template<typename T> std::size_t NextScan(T low, T high) { return Run(NextBetween, ToValue(low, m_eType), ToValue(high, m_eType), Changed); }
+	std::size_t NextScan(Compare_t eCompare) { return Run(NextCompare, Value_t(0), Value_t(0), eCompare); }
+
+	std::size_t GetCount() const noexcept { return m_nCount; }
+	Type_t GetType() const noexcept { return m_eType; }
+
+	// Returns the addresses of the (first nMax) candidates, sorted.
+	std::vector<CMemory> GetCandidates(std::size_t nMax = std::numeric_limits<std::size_t>::max()) const;
+
+	template<typename T>
+	static constexpr Type_t TypeOf() noexcept
+	{
+		static_assert((std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)) || std::is_same_v<T, float> || std::is_same_v<T, double>, "Unsupported value type");
+
+		if constexpr (std::is_same_v<T, float>)
+			return Float;
+		else if constexpr (std::is_same_v<T, double>)
+			return Double;
+		else
+			return sizeof(T) == 4 ? Int32 : Int64;
+	}
+
+private:
+	template<typename T>
+	static Value_t ToValue(T value) noexcept
+	{
+		if constexpr (std::is_integral_v<T>)
+			return sizeof(T) == 4 ? Value_t(static_cast<std::int32_t>(value)) : Value_t(static_cast<std::int64_t>(value));
+		else
+			return Value_t(value);
+	}
+
+	// Converts a value to a type, saturating the integers which it does not fit.
+	template<typename T>
+	static Value_t ToValue(T value, Type_t eType) noexcept
+	{
+		switch (eType)
+		{
+			case Int32:
+				return Value_t(Saturate<std::int32_t>(value));
+			case Int64:
+				return Value_t(Saturate<std::int64_t>(value));
+			case Float:
+				return Value_t(static_cast<float>(value));
+			default:
+				return Value_t(static_cast<double>(value));
+		}
+	}
+
+	template<typename U, typename T>
+	static U Saturate(T value) noexcept
+	{
+		static_assert(std::is_arithmetic_v<T>, "Unsupported value type");
+
+		constexpr U nMin = std::numeric_limits<U>::min(), nMax = std::numeric_limits<U>::max();
+
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			if (!(value > static_cast<T>(nMin))) // NaN too.
+				return nMin;
+
+			if (!(value < static_cast<T>(nMax)))
+				return nMax;
+		}
+		else if constexpr (std::is_unsigned_v<T>)
+		{
+			if (value > static_cast<std::make_unsigned_t<U>>(nMax))
+				return nMax;
+		}
+		else if constexpr (sizeof(T) > sizeof(U))
+		{
+			if (value < nMin)
+				return nMin;
+
+			if (value > nMax)
+				return nMax;
+		}
+
+		return static_cast<U>(value);
+	}
+
+	enum Pass_t : std::uint8_t
+	{
+		FirstBetween,
+		FirstAny,
+		NextBetween,
+		NextCompare,
+	};
+
+	struct Range_t
+	{
+		std::uintptr_t m_pBegin;
+		std::uintptr_t m_pEnd;
+	};
+
+	struct Block_t
+	{
+		std::uintptr_t m_pBase;                  // Of element 0.
+		std::uint32_t m_nElements;
+		std::uint32_t m_nCount;                  // Of candidates.
+		std::vector<std::uint64_t> m_vecBitmap;  // Dense: a bit per element.
+		std::vector<std::uint32_t> m_vecIndices; // Sparse: the indices of the candidates, sorted.
+		std::vector<std::uint64_t> m_vecValues;  // The values of the candidates at the last pass (as the type), in order.
+	};
+
+	std::size_t First(Type_t eType, Value_t low, Value_t high, bool bAny);
+	std::size_t Run(Pass_t ePass, Value_t low, Value_t high, Compare_t eCompare); // Passes every block, drops the empty ones.
+
+	// Implemented for the value types.
+	template<typename T> static void ScanBlock(Block_t& block, Pass_t ePass, T low, T high, Compare_t eCompare);
+	template<typename T> static void StoreBitmap(Block_t& block); // Counts the candidates of a bitmap and reads their values.
+	template<typename T> static void Repack(Block_t& block);      // Picks the representation of the candidates by their density.
+
+	std::size_t m_nThreads;
+	std::vector<Range_t> m_vecRanges;
+
+	Type_t m_eType = Int32;
+	std::vector<Block_t> m_vecBlocks;
+	std::size_t m_nCount = 0;
+}; // class CValueScanner
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_VALUESCAN_HPP
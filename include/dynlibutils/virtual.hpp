@@ -10,14 +10,29 @@
 #include "memaddr.hpp"
 
 #include <bit>
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 #define DYNLIB_INVALID_VCALL -1
 
+// Number of pointer-sized entries which precede the first virtual function of a primary vtable:
+//   - MSVC: the RTTI Complete Object Locator pointer.
+//   - Itanium C++ ABI: offset-to-top and the typeinfo pointer (virtual bases add vcall/vbase offsets before them).
+#if defined(_MSC_VER)
+#	define DYNLIB_VTABLE_PREFIX_SIZE 1
+#else
+#	define DYNLIB_VTABLE_PREFIX_SIZE 2
+#endif
+
 namespace DynLibUtils {
 
+class CModule;
+
 template<auto METHOD>
 constexpr std::ptrdiff_t GetVirtualIndex() noexcept
 {
@@ -128,6 +143,15 @@ constexpr std::ptrdiff_t GetVirtualIndex() noexcept
 	return DYNLIB_INVALID_VCALL;
 }
 
+// The dynamic class of the objects which share a vptr, read from the RTTI of their vtable.
+struct ClassInfo_t
+{
+	const void* m_pTypeInfo;       // std::type_info (Itanium) or the RTTI Type Descriptor (MSVC).
+	std::ptrdiff_t m_nOffsetToTop; // From the subobject which holds the vptr to the complete object (0 for a primary vtable).
+	std::string m_sDecoratedName;  // "7CPlayer", ".?AVCPlayer@@"
+	std::string m_sName;           // "CPlayer"
+};
+
 // Provides an interface to manipulate and invoke entries from a class's virtual table (vtable).
 class CVirtualTable
 {
@@ -158,7 +182,49 @@ public: // Callers.
 	// The function pointer is assumed to have the signature R (*)(void*, Args...), 
 	// where the first argument is the this-pointer.
 	template<typename R, typename... Args> R CallMethod(std::ptrdiff_t nIndex, Args... args) { return GetMethod<R (*)(Args...)>(nIndex)(args...); }
-	template<typename R, typename... Args> R CallMethod(std::ptrdiff_t nIndex, Args... args) const { return const_cast<CThis *>(this)->CallMethod(nIndex, args...); }
+	template<typename R, typename... Args> R CallMethod(std::ptrdiff_t nIndex, Args... args) const { return const_cast<CThis *>(this)->template CallMethod<R, Args...>(nIndex, args...); }
+
+public: // RTTI.
+	// Gets the class of the vtable from a process-wide cache keyed by the vptr (a wait-free hash probe),
+	// reading its RTTI on the first lookup (checked against the region map). Returns nullptr if the
+	// vtable has no readable RTTI, which is cached too. The records are never freed.
+	//
+	//   std::string_view svClass = CVirtualTable(pObject).GetClassName();
+	const ClassInfo_t* GetClassInfo() const;
+	const void* GetTypeInfo() const { const ClassInfo_t* pInfo = GetClassInfo(); return pInfo ? pInfo->m_pTypeInfo : nullptr; }
+	std::string_view GetClassName() const { const ClassInfo_t* pInfo = GetClassInfo(); return pInfo ? std::string_view(pInfo->m_sName) : std::string_view(); }
+
+public: // Layout.
+	// Counts the slots of the vtable: walks them while they point into the executable sections of 
+	// pModule (or at a pure virtual stub), stopping at the offset-to-top/typeinfo of the next vtable 
+	// or at the end of the section that holds this one. Slots are range-checked 4 at a time with SIMD.
+	std::size_t GetLength(const CModule& module, std::size_t nMaxLength = 4096) const;
+
+	// Copies nLength slots. With a module base, slots are stored relative to it (RVAs), 
+	// which makes clones comparable across processes and builds.
+	std::vector<std::uintptr_t> Clone(std::size_t nLength, CMemory pBase = nullptr) const
+	{
+		std::vector<std::uintptr_t> vecResult(nLength);
+
+		for (std::size_t n = 0; n < nLength; ++n)
+			vecResult[n] = reinterpret_cast<std::uintptr_t>(m_pVTFs[n]) - pBase.GetAddr();
+
+		return vecResult;
+	}
+
+	// Returns the indices of the slots which differ between two clones (the tail of a longer one differs).
+	static std::vector<std::size_t> Compare(const std::vector<std::uintptr_t>& vecLeft, const std::vector<std::uintptr_t>& vecRight)
+	{
+		std::vector<std::size_t> vecResult;
+
+		const std::size_t nCommon = std::min(vecLeft.size(), vecRight.size()), nTotal = std::max(vecLeft.size(), vecRight.size());
+
+		for (std::size_t n = 0; n < nTotal; ++n)
+			if (n >= nCommon || vecLeft[n] != vecRight[n])
+				vecResult.push_back(n);
+
+		return vecResult;
+	}
 
 	// Union to store either:
 	//  - m_pVTFs: pointer to an array of void* (the vtable).
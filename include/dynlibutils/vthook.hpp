@@ -8,7 +8,10 @@
 #define DYNLIBUTILS_VTHOOK_HPP
 #pragma once
 
+#include "epoch.hpp"
+#include "flatmap.hpp"
 #include "memaddr.hpp"
+#include "module.hpp"
 #include "virtual.hpp"
 
 #if _WIN32
@@ -21,11 +24,19 @@
 #endif
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace DynLibUtils {
 
@@ -50,6 +61,8 @@ public:
 	//   - nLength:  Number of bytes to change. Default is sizeof(void*), which 
 	//               is often enough to patch a single function pointer or small 
 	//               instruction sequence.
+	//   - bExecutable: The region holds code which other threads may be running, 
+	//               so it stays executable while it is writable and afterwards.
 	//
 	// Behavior:
 	//   - On Windows: 
@@ -66,22 +79,25 @@ public:
 	//       * Computes nAligned = pPageEnd - pPageStart so that the entire range 
 	//         of pages touched by the original region is included. 
 	//       * Stores m_pTarget = pPageStart and m_nLength = nAligned. 
-	//       * Sets m_nOldProtect = PROT_READ (assumes original region was at least readable). 
+	//       * Sets m_nOldProtect = PROT_READ (assumes original region was at least readable), 
+	//         or PROT_READ | PROT_EXEC for code. 
 	//       * Calls mprotect(pPageStart, nAligned, PROT_READ | PROT_WRITE) to grant 
-	//         write permission (while keeping read). 
+	//         write permission (while keeping read, and execute for code). 
 	//       * Asserts that mprotect returned 0 (success).
 	//
 	// The constructor is noexcept: it does not throw exceptions. Failures to change 
 	// page protection are caught by assert() in debug builds; in release builds, they 
 	// proceed silently, which may mean writing to protected memory will fail.
 	//--------------------------------------------------------------------------
-	explicit VirtualUnprotector(void *pTarget, std::size_t nLength = sizeof(void*)) noexcept
+	explicit VirtualUnprotector(void *pTarget, std::size_t nLength = sizeof(void*), bool bExecutable = false) noexcept
 	{
 #if _WIN32
+		(void)bExecutable; // PAGE_EXECUTE_READWRITE keeps code executable.
+
 		m_nLength = nLength;
 		m_pTarget = pTarget;
 
-		bool bIsUnprotected = VirtualProtect(pTarget, nLength, PAGE_EXECUTE_READWRITE, &m_nOldProtect);
+		[[maybe_unused]] bool bIsUnprotected = VirtualProtect(pTarget, nLength, PAGE_EXECUTE_READWRITE, &m_nOldProtect);
 #else
 		long pageSize = sysconf(_SC_PAGESIZE);
 
@@ -96,11 +112,11 @@ public:
 		auto nAligned = static_cast<std::size_t>(pPageEnd - pPageStart);
 
 		// Assume the original protection was at least PROT_READ.
-		m_nOldProtect = PROT_READ;
+		m_nOldProtect = bExecutable ? PROT_READ | PROT_EXEC : PROT_READ;
 		m_nLength = nAligned;
 		m_pTarget = pPageStart;
 
-		bool bIsUnprotected = !mprotect(pPageStart, nAligned, PROT_READ | PROT_WRITE); // Grant write permission while keeping read permission.
+		[[maybe_unused]] bool bIsUnprotected = !mprotect(pPageStart, nAligned, m_nOldProtect | PROT_WRITE); // Grant write permission while keeping the others.
 #endif
 
 		assert(bIsUnprotected);
@@ -117,9 +133,9 @@ public:
 	{
 #if _WIN32
 		DWORD origProtect;
-		bool bIsUnprotected = VirtualProtect(m_pTarget, m_nLength, m_nOldProtect, &origProtect);
+		[[maybe_unused]] bool bIsUnprotected = VirtualProtect(m_pTarget, m_nLength, m_nOldProtect, &origProtect);
 #else
-		bool bIsUnprotected = !mprotect(m_pTarget, m_nLength, m_nOldProtect);
+		[[maybe_unused]] bool bIsUnprotected = !mprotect(m_pTarget, m_nLength, m_nOldProtect);
 #endif
 
 		assert(bIsUnprotected);
@@ -131,12 +147,169 @@ private:
 	CMemory m_pTarget;
 }; // class VirtualUnprotector
 
+// Publishes a pointer-sized slot (a vtable entry) with a single atomic store, so a concurrent 
+// caller reads either the old or the new function and never a torn value.
+inline void AtomicStorePointer(void** ppSlot, void* pValue) noexcept
+{
+#if _WIN32
+	InterlockedExchangePointer(ppSlot, pValue);
+#else
+	__atomic_store_n(ppSlot, pValue, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Returns the size of a virtual memory page.
+inline std::size_t GetPageSize() noexcept
+{
+#if _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+
+	return static_cast<std::size_t>(info.dwPageSize);
+#else
+	static const long s_nPageSize = sysconf(_SC_PAGESIZE);
+
+	return static_cast<std::size_t>(s_nPageSize);
+#endif
+}
+
+// Groups sorted writes into runs of the same or adjacent pages and unprotects each run once.
+//   - funcRange: std::pair<std::uintptr_t, std::size_t> (const T& write) - address and size of a write.
+//   - funcWrite: void (T& write) - performs a write while its pages are writable.
+template<typename T, typename RANGE, typename WRITE>
+inline void WriteUnprotectedRuns(std::vector<T>& vecWrites, const RANGE& funcRange, const WRITE& funcWrite, bool bExecutable = false)
+{
+	const std::uintptr_t nPageSize = static_cast<std::uintptr_t>(GetPageSize());
+
+	auto funcPageOf = [nPageSize](std::uintptr_t pAddress) { return pAddress & ~(nPageSize - 1); };
+	auto funcLastPageOf = [&](const T& write) { const auto [pAddress, nSize] = funcRange(write); return funcPageOf(pAddress + nSize - 1); }; // A write may straddle two pages.
+
+	const std::size_t nCount = vecWrites.size();
+
+	for (std::size_t n = 0; n < nCount; )
+	{
+		const std::uintptr_t pRunStart = funcPageOf(funcRange(vecWrites[n]).first);
+		std::uintptr_t pRunLastPage = funcLastPageOf(vecWrites[n]);
+
+		std::size_t nEnd = n + 1;
+
+		// Extend the run while the next write is on the last or on the adjacent page.
+		while (nEnd < nCount && funcPageOf(funcRange(vecWrites[nEnd]).first) <= pRunLastPage + nPageSize)
+		{
+			pRunLastPage = std::max(pRunLastPage, funcLastPageOf(vecWrites[nEnd]));
+			++nEnd;
+		}
+
+		const std::uintptr_t pRunEnd = pRunLastPage + nPageSize;
+
+		VirtualUnprotector unprotect(reinterpret_cast<void *>(pRunStart), pRunEnd - pRunStart, bExecutable);
+
+		for (; n < nEnd; ++n)
+		{
+			funcWrite(vecWrites[n]);
+		}
+	}
+}
+
+// Writes pointer-sized values into protected memory (vtable slots, GOT entries), changing the 
+// protection once per contiguous run of touched pages instead of once per write. Each write is 
+// a single atomic store. vecWrites is sorted by address in place.
+inline void WritePointersUnprotected(std::vector<std::pair<void**, void*>>& vecWrites)
+{
+	if (vecWrites.empty())
+	{
+		return;
+	}
+
+	std::sort(vecWrites.begin(), vecWrites.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+
+	WriteUnprotectedRuns(vecWrites, 
+		[](const std::pair<void**, void*>& write) { return std::make_pair(reinterpret_cast<std::uintptr_t>(write.first), sizeof(void*)); }, 
+		[](std::pair<void**, void*>& write) { AtomicStorePointer(write.first, write.second); });
+}
+
+// A patch of a few instruction bytes.
+struct CodePatch_t
+{
+	void* m_pTarget;
+	const std::uint8_t* m_pBytes;
+	std::size_t m_nLength;
+};
+
+// Writes a patch which does not fit into an aligned 8-byte word into code which other threads may 
+// be executing (see WriteCodeBytes). Its first byte becomes an int3 while the others are written, 
+// each step being made visible to every core; a thread which hits the int3 waits in a trap handler 
+// (SIGTRAP, a vectored exception handler on Windows) and resumes at the complete patch.
+void WriteCodeBytesThroughBreakpoint(void* pTarget, const std::uint8_t* pBytes, std::size_t nLength);
+
+// Checks that the trap handler of WriteCodeBytesThroughBreakpoint() is installed (installs it).
+// Without it, such patches are copied and must only be applied to code which is not running.
+bool IsBreakpointPatchingAvailable();
+
+// Writes a patch into code which other threads may be executing. A patch that fits into an 
+// aligned 8-byte word is published with one atomic store, others through a breakpoint.
+inline void WriteCodeBytes(void* pTarget, const std::uint8_t* pBytes, std::size_t nLength)
+{
+	const auto pAddress = reinterpret_cast<std::uintptr_t>(pTarget);
+	const std::uintptr_t pWord = pAddress & ~std::uintptr_t(7);
+
+	if (pAddress + nLength <= pWord + 8)
+	{
+		auto* pWordPtr = reinterpret_cast<std::uint64_t*>(pWord);
+
+		std::uint64_t nWord = *pWordPtr;
+
+		std::memcpy(reinterpret_cast<std::uint8_t*>(&nWord) + (pAddress - pWord), pBytes, nLength);
+#if _WIN32
+		InterlockedExchange64(reinterpret_cast<volatile LONG64*>(pWordPtr), static_cast<LONG64>(nWord));
+#else
+		__atomic_store_n(pWordPtr, nWord, __ATOMIC_SEQ_CST);
+#endif
+	}
+	else
+	{
+		WriteCodeBytesThroughBreakpoint(pTarget, pBytes, nLength);
+	}
+}
+
+// Writes patches into code, changing the protection once per contiguous run of touched pages 
+// and keeping them executable. vecPatches is sorted by address in place.
+inline void WriteCodeUnprotected(std::vector<CodePatch_t>& vecPatches)
+{
+	if (vecPatches.empty())
+	{
+		return;
+	}
+
+	std::sort(vecPatches.begin(), vecPatches.end(), [](const auto& left, const auto& right) { return left.m_pTarget < right.m_pTarget; });
+
+	WriteUnprotectedRuns(vecPatches, 
+		[](const CodePatch_t& patch) { return std::make_pair(reinterpret_cast<std::uintptr_t>(patch.m_pTarget), patch.m_nLength); }, 
+		[](CodePatch_t& patch) { WriteCodeBytes(patch.m_pTarget, patch.m_pBytes, patch.m_nLength); }, 
+		true);
+
+	for (const auto& patch : vecPatches)
+	{
+#if _WIN32
+		FlushInstructionCache(GetCurrentProcess(), patch.m_pTarget, patch.m_nLength);
+#else
+		__builtin___clear_cache(static_cast<char*>(patch.m_pTarget), static_cast<char*>(patch.m_pTarget) + patch.m_nLength);
+#endif
+	}
+}
+
 // A template class that allows hooking (i.e., replacing) a single virtual method 
 // in a class’s vtable. It derives from CMemory to leverage memory‐reading/writing utilities.
 // Template Parameters:
 //   R    - The return type of the virtual function being hooked.
 //   Args – Argument types of the virtual function being hooked. 
 //          The first parameter must be a pointer to an (abstract) class type.
+//
+// Thread safety: the vtable slot is written with one atomic store, and the original function 
+// pointer is published before it and stays valid after Unhook(). Unhook() and the destructor wait 
+// for a CEpoch grace period, so a replacement function which wraps its body into a CEpoch::CGuard 
+// may safely use `Call()` while another thread unhooks or destroys the hook.
 template<typename R, typename ...Args>
 class CVTHook : public CMemory
 {
@@ -148,6 +321,7 @@ public:
 		if (IsHooked())
 		{
 			UnhookImpl();
+			CEpoch::Synchronize();
 		}
 	}
 
@@ -184,9 +358,11 @@ public:
 	// If no hook is installed, returns false.
 	// Otherwise:
 	//   * Restores the original function pointer. 
-	//   * Resets internal state. 
+	//   * Resets the slot pointer (the original function is kept for calls in flight). 
+	//   * Waits until no thread is inside a guarded hook, unless bWait is false (the caller then 
+	//     owns the grace period) or it is called from inside one. 
 	//   * Returns true.
-	bool Unhook()
+	bool Unhook(bool bWait = true)
 	{
 		if (!IsHooked())
 		{
@@ -194,7 +370,12 @@ public:
 		}
 
 		UnhookImpl();
-		Clear();
+		SetPtr(nullptr);
+
+		if (bWait)
+		{
+			CEpoch::Synchronize();
+		}
 
 		return true;
 	}
@@ -213,14 +394,14 @@ protected: // Implementation methods.
 	{
 		VirtualUnprotector unprotect(GetPtr());
 
-		*GetTargetPtr() = pfnTarget;
+		AtomicStorePointer(GetTargetPtr<void **>(), reinterpret_cast<void *>(pfnTarget));
 	}
 
 	void UnhookImpl() noexcept
 	{
 		VirtualUnprotector unprotect(GetPtr());
 
-		*GetTargetPtr<void **>() = m_pOriginalFn.GetPtr();
+		AtomicStorePointer(GetTargetPtr<void **>(), m_pOriginalFn.GetPtr());
 	}
 
 private:
@@ -233,6 +414,9 @@ private:
 //   R    – Return type of the virtual function being hooked.
 //   Args – Argument types of the virtual function being hooked. 
 //          The first parameter must be a pointer to an (abstract) class type.
+//
+// The trampoline runs the callback inside a CEpoch::CGuard; Unhook() unpublishes the callback 
+// first (late callers fall back to the original function) and frees it after a grace period.
 template<typename R, typename ...Args>
 class CVTFHook : public CVTHook<R, Args...>
 {
@@ -240,7 +424,18 @@ public:
 	using CBase = CVTHook<R, Args...>;
 	using Function_t = std::function<R (Args...)>; // Allowing lambdas or other callable objects that match R(Args...) to be used as the hook target.
 
-	void Clear() { CBase::Clear(); sm_callback = nullptr; }
+	~CVTFHook() { Unhook(); }
+
+	// The callback is shared by the hooks of the signature: only the hooked one owns it.
+	void Clear()
+	{
+		if (CBase::IsHooked())
+		{
+			CEpoch::Reclaim(sm_pCallback.exchange(nullptr, std::memory_order_acq_rel));
+		}
+
+		CBase::Clear();
+	}
 
 	// Hooks takes labda callback:
 	//   - pVTable:  CVirtualTable instance pointing to the target class’s vtable.
@@ -249,23 +444,45 @@ public:
 	template<auto METHOD> void Hook(CVirtualTable pVTable, Function_t &&func) noexcept { Hook(pVTable, GetVirtualIndex<METHOD>(), std::move(func)); }
 	void Hook(CVirtualTable pVTable, std::ptrdiff_t nIndex, Function_t &&func) noexcept
 	{
-		assert(!sm_callback);
+		assert(!sm_pCallback.load(std::memory_order_relaxed));
 
-		sm_callback = std::move(func);
-		CBase::Hook(pVTable, nIndex, +[](Args... args) -> R { return sm_callback(args...); });
+		sm_pfnOriginal.store(pVTable.GetMethod<typename CBase::Function_t>(nIndex), std::memory_order_release);
+		sm_pCallback.store(new Function_t(std::move(func)), std::memory_order_release);
+		CBase::Hook(pVTable, nIndex, &Trampoline);
 	}
 
 	bool Unhook()
 	{
-		bool bResult = CBase::Unhook();
+		if (!CBase::IsHooked())
+		{
+			return false;
+		}
 
-		sm_callback = nullptr;
+		Function_t* pCallback = sm_pCallback.exchange(nullptr, std::memory_order_acq_rel);
 
-		return bResult;
+		CBase::Unhook();
+		CEpoch::Reclaim(pCallback);
+
+		return true;
 	}
 
 protected:
-	inline static Function_t sm_callback;
+	static R Trampoline(Args... args)
+	{
+		CEpoch::CGuard guard;
+
+		const Function_t* pCallback = sm_pCallback.load(std::memory_order_acquire);
+
+		if (!pCallback)
+		{
+			return sm_pfnOriginal.load(std::memory_order_acquire)(args...); // Unhooked while entering.
+		}
+
+		return (*pCallback)(args...);
+	}
+
+	inline static std::atomic<Function_t*> sm_pCallback {nullptr};
+	inline static std::atomic<typename CBase::Function_t> sm_pfnOriginal {nullptr};
 }; // class CVTFHook<R, Args...>
 
 // A template class represents generic manager for multiple virtual‐table hooks of the same signature.
@@ -284,6 +501,9 @@ public:
 	using Element_t = T;
 	using Function_t = typename Element_t::Function_t;
 
+public:
+	using Storage_t = std::multimap<CVirtualTable, Element_t>;
+
 public:
 	bool IsEmpty() const noexcept { return m_storage.empty(); } // Returns true if no hooks are currently stored.
 	auto Find(const CVirtualTable pVTable) { return m_storage.equal_range(pVTable); } // Delimiting all entries (each Element_t) that were registered under that exact virtual table key.
@@ -292,21 +512,21 @@ public:
 
 public:
 	// Behavior:
-	//   1. Creates a local entry instance (vth).
-	//   2. Calls vth.Hook(pVTable, nIndex, vfunc) to perform the low‐level hook:
-	//      * Saves the original function pointer in vth’s internal state.
+	//   1. Inserts an unhooked entry instance under the key pVTable (in place: a hooked 
+	//      element unhooks itself when destroyed, so it must never be copied).
+	//   2. Calls Hook(pVTable, nIndex, vfunc) on it to perform the low‐level hook:
+	//      * Saves the original function pointer in the element’s internal state.
 	//      * Replaces the vtable entry [pVTable + nIndex] with vfunc.
-	//   3. Inserts the newly‐constructed vth into m_storage under the key pVTable,
-	//      returning an iterator to the inserted element.
+	//   3. Returns an iterator to the inserted element.
 	template<auto METHOD>
 	auto AddHook(CVirtualTable pVTable, Function_t vfunc) { return AddHook(pVTable, GetVirtualIndex<METHOD>(), vfunc); }
 	auto AddHook(CVirtualTable pVTable, std::ptrdiff_t nIndex, Function_t vfunc)
 	{
-		Element_t vth;
+		auto it = m_storage.emplace(std::piecewise_construct, std::forward_as_tuple(pVTable), std::forward_as_tuple());
 
-		vth.Hook(pVTable, nIndex, vfunc);
+		it->second.Hook(pVTable, nIndex, vfunc);
 
-		return m_storage.emplace(pVTable, std::move(vth));
+		return it;
 	}
 
 	// Returns a vector containing the return values from each hook’s Call() invocation, 
@@ -316,20 +536,11 @@ public:
 	{
 		std::vector<R> results;
 
-		auto found = Find(CVirtualTable(pThis));
-
-		auto &vhooks = found.second;
-
-		if (vhooks == End())
-		{
-			return results;
-		}
-
-		results.reserve(vhooks.size());
+		auto [itBegin, itEnd] = Find(CVirtualTable(pThis));
 
-		for (auto it : vhooks)
+		for (auto it = itBegin; it != itEnd; ++it)
 		{
-			results.push_back(it->Call(pThis, args...));
+			results.push_back(it->second.Call(pThis, args...));
 		}
 
 		return results;
@@ -339,18 +550,16 @@ public:
 	template<typename C, typename ...Args>
 	bool CallNoReturn(C pThis, Args... args)
 	{
-		auto found = Find(CVirtualTable(pThis));
-
-		auto &vhooks = found.second;
+		auto [itBegin, itEnd] = Find(CVirtualTable(pThis));
 
-		if (vhooks == End())
+		if (itBegin == itEnd)
 		{
 			return false;
 		}
 
-		for (auto it : vhooks)
+		for (auto it = itBegin; it != itEnd; ++it)
 		{
-			it->Call(pThis, args...);
+			it->second.Call(pThis, args...);
 		}
 
 		return true;
@@ -359,8 +568,24 @@ public:
 	//   - Returns the number of elements removed (std::size_t).
 	std::size_t RemoveHook(CVirtualTable pVTable) { return m_storage.erase(pVTable); }
 
+protected:
+	// Detaches the elements of a vtable (or all of them) without unhooking. Destroying the result 
+	// unhooks and waits for a grace period, which lets callers do it outside of their own locks.
+	std::vector<typename Storage_t::node_type> Extract(CVirtualTable pVTable)
+	{
+		std::vector<typename Storage_t::node_type> vecNodes;
+
+		for (auto it = m_storage.find(pVTable); it != m_storage.end() && it->first == pVTable; )
+		{
+			vecNodes.push_back(m_storage.extract(it++));
+		}
+
+		return vecNodes;
+	}
+	Storage_t ExtractAll() noexcept { return std::exchange(m_storage, Storage_t()); }
+
 private:
-	std::multimap<CVirtualTable, Element_t> m_storage;
+	Storage_t m_storage;
 }; // class CVTMHookBase<T, FUNC>
 
 template<typename R, typename ...Args>
@@ -373,17 +598,9 @@ using CVTMHook = CVTMHookBase<CVTHook<R, Args...>>;
 //   T     – Pointer of сlass type of the object whose virtual method is being hooked.
 //   Args  – Argument types of the virtual method.
 //
-// Inheritance:
-//   CVTFMHook inherits from CVTMHook<R, Args...>, which provides storage and basic hook‐installation 
-//   logic for a multimap of CVirtualTable → hook elements. Each hook element in this context 
-//   must itself know how to call a function pointer with signature R (Args...).
-//
-// CVTFMHook extends that by maintaining, for each hooked class (keyed by its CVirtualTable), a 
-// vector of user‐supplied callbacks (Function_t = R(*)(T, Args...)). When the hooked virtual 
-// function is called, all callbacks associated with that class’s vtable will be invoked.
-//
-// Note: This class assumes that the base hook element (Element_t) installed in the vtable will 
-//       dispatch to a static trampoline that iterates over sm_vcallbacks[CVirtualTable(pClass)].
+// CVTFMHook maintains, for each hooked class (keyed by its CVirtualTable), a contiguous array of 
+// user‐supplied callbacks (Callback_t = std::function<R (T, Args...)>). When the hooked virtual function 
+// is called, all callbacks associated with that class’s vtable will be invoked.
 //
 // Example usage:
 //
@@ -407,27 +624,44 @@ using CVTMHook = CVTMHookBase<CVTHook<R, Args...>>;
 //
 //
 // Implementation Details:
-//   - sm_vcallbacks: A static std::map from CVirtualTable → std::vector<Function_t>.
-//                     For each distinct vtable (i.e., each derived class or polymorphic type),
-//                     we store a list of callbacks of type R(T, Args...).
-//   - AddHook: Adds a new callback to sm_vcallbacks[vtable], and installs (via base AddHook) a
-//              single vtable‐slot hook that dispatches to all callbacks in the vector.
-//   - RemoveHook: Erases the entry for a given CVirtualTable from sm_vcallbacks, then removes
-//                 all registered hooks in the base class for that vtable.
-//   - Clear:     Clears sm_vcallbacks entirely and then clears all hooks from the base class.
-//
-// Disclaimer: This code snippet assumes that Element_t (from the base class) is capable of
-//             installing a hook that, when invoked, calls a single raw function pointer that
-//             matches R(T, Args...). The static lambda in AddHook is that trampoline.
+//   - sm_vcallbacks: A static CAtomicFlatMap from vtable address → Entry_t. An entry holds the original
+//                    function of the slot and a contiguous array of callbacks of type R(T, Args...).
+//                    The trampoline pays one wait-free hash probe per call; entries are immutable once
+//                    published, writers build a new entry and swap it in (RCU-style).
+//   - sm_slots:      The vtable‐slot hooks which dispatch to the entries, one per hooked vtable. Like the
+//                    entries, they are shared by every instance of the class: an instance owns its
+//                    callbacks only, and the slot is restored once the last callback is removed.
+//   - AddHook: Publishes a new entry with the callback appended, and installs the slot hook (first time only).
+//              Another slot of an already hooked vtable is rejected.
+//   - RemoveHook: Removes the callbacks of the instance for a given CVirtualTable (in-flight calls of an
+//                 emptied entry fall back to the original function).
+//   - Clear:     Removes the callbacks of the instance for every vtable; the destructor calls it.
+//
+// Thread safety: AddHook/RemoveHook/Clear may run concurrently with calls to hooked methods and with
+// each other. The trampoline runs inside a CEpoch::CGuard; replaced entries are freed after a grace
+// period, and slots are restored (waiting for in-flight calls) outside of the writer lock.
 //
 //=============================================================================
 template<typename R, class T, typename ...Args>
-class CVTFMHook : public CVTMHook<R, Args...>
+class CVTFMHook
 {
 public:
 	using Function_t = R (*)(T, Args...);
 	using Callback_t = std::function<R (T, Args...)>;
 
+	struct Entry_t
+	{
+		Function_t m_pfnOriginal;
+		std::vector<Callback_t> m_vecCallbacks;
+		std::vector<const CVTFMHook*> m_vecOwners; // The instance which added each callback.
+	};
+
+	CVTFMHook() = default;
+	~CVTFMHook() { Clear(); }
+
+	CVTFMHook(const CVTFMHook&) = delete;
+	CVTFMHook& operator=(const CVTFMHook&) = delete;
+
 	// AddHook (by index):
 	//   Installs or appends a callback for a given vtable index.
 	//
@@ -437,52 +671,680 @@ public:
 	//     - funcCallback:  The std::function<R(T, Args...)> to append to the callback list.
 	//
 	//   Behavior:
-	//     1. Insert or append funcCallback into the static map sm_vcallbacks at key `pVTable`.
-	//     2. Call the base class’s
-	//      - The unary '+' ensures the lambda is converted to a raw function pointer of type Function_t.
-	//      - When the hooked method is invoked on an object `pClass`, the trampoline lambda:
-	//          a) Constructs a CVirtualTable(pClass) to look up the correct list of callbacks.
-	//          b) Retrieves `callbacks`, which is a std::vector<Function_t> stored in sm_vcallbacks.
-	//          c) Iterates through each callback in the vector and invokes it with (pClass, args...).
+	//     1. Publishes a copy of the vtable entry with funcCallback appended into sm_vcallbacks.
+	//     2. If the vtable is not hooked yet (by any instance), installs the Dispatch trampoline 
+	//        into its slot, once the entry which holds the original function is published.
+	//
+	//   The callbacks are keyed by the vtable only (Dispatch can't tell the slots apart), so one
+	//   slot per vtable can be hooked: returns false if another index of it is hooked already.
 	template<auto METHOD>
-	void AddHook(CVirtualTable pVTable, Callback_t funcCallback) { return AddHook(pVTable, GetVirtualIndex<METHOD>(), funcCallback); }
-	void AddHook(CVirtualTable pVTable, std::ptrdiff_t nIndex, Callback_t funcCallback)
+	bool AddHook(CVirtualTable pVTable, Callback_t funcCallback) { return AddHook(pVTable, GetVirtualIndex<METHOD>(), std::move(funcCallback)); }
+	bool AddHook(CVirtualTable pVTable, std::ptrdiff_t nIndex, Callback_t funcCallback)
 	{
-		AddHook(pVTable, nIndex,
-			+[](T pClass, Args... args)
+		assert(nIndex != DYNLIB_INVALID_VCALL);
+
+		std::lock_guard<std::mutex> lock(sm_mutex);
+
+		auto it = sm_slots.find(pVTable);
+
+		Function_t pfnOriginal = nullptr;
+
+		if (it == sm_slots.end())
+		{
+			pfnOriginal = pVTable.GetMethod<Function_t>(nIndex);
+		}
+		else
+		{
+			if (it->second.template GetTargetPtr<void**>() != &pVTable.GetMethod<void*>(nIndex))
 			{
-				auto found = sm_vcallbacks.find(CVirtualTable(pClass));
+				return false;
+			}
 
-				assert(found != sm_vcallbacks.cend());
+			pfnOriginal = it->second.template GetOrigin<Function_t>();
+		}
 
-				auto &callbacks = found.second;
+		sm_vcallbacks.Update(pVTable.m_diff, [&](const Entry_t* pOld)
+		{
+			auto pNew = std::make_unique<Entry_t>();
 
-				const auto itEnd = callbacks.cend();
+			pNew->m_pfnOriginal = pfnOriginal;
 
-				for (auto it : callbacks)
-				{
-					it(pClass, args...);
-				}
+			if (pOld)
+			{
+				pNew->m_vecCallbacks.reserve(pOld->m_vecCallbacks.size() + 1);
+				pNew->m_vecCallbacks = pOld->m_vecCallbacks;
+				pNew->m_vecOwners.reserve(pOld->m_vecOwners.size() + 1);
+				pNew->m_vecOwners = pOld->m_vecOwners;
 			}
-		);
+
+			pNew->m_vecCallbacks.push_back(std::move(funcCallback));
+			pNew->m_vecOwners.push_back(this);
+
+			return pNew;
+		});
+
+		if (it == sm_slots.end())
+		{
+			sm_slots.emplace(std::piecewise_construct, std::forward_as_tuple(pVTable), std::forward_as_tuple()).first->second.Hook(pVTable, nIndex, &Dispatch);
+		}
+
+		return true;
 	}
 
+	// Removes the callbacks of this instance for a vtable. Returns false if it has none.
 	bool RemoveHook(CVirtualTable pVTable)
 	{
-		sm_vcallbacks(pVTable);
+		std::vector<typename Slots_t::node_type> vecNodes;
+
+		bool bRemoved;
+
+		{
+			std::lock_guard<std::mutex> lock(sm_mutex);
+
+			bRemoved = RemoveOwn(pVTable, vecNodes);
+		}
 
-		return RemoveHook(pVTable) != 0;
+		if (bRemoved)
+		{
+			CEpoch::Synchronize();
+		}
+
+		return bRemoved;
 	}
 
+	// Removes the callbacks of this instance for every vtable.
 	void Clear()
 	{
-		sm_vcallbacks.clear();
-		Clear();
+		std::vector<typename Slots_t::node_type> vecNodes;
+
+		bool bRemoved = false;
+
+		{
+			std::lock_guard<std::mutex> lock(sm_mutex);
+
+			std::vector<CVirtualTable> vecVTables;
+
+			vecVTables.reserve(sm_slots.size());
+
+			for (const auto& [pVTable, slot] : sm_slots)
+			{
+				vecVTables.push_back(pVTable);
+			}
+
+			for (const auto& pVTable : vecVTables)
+			{
+				bRemoved |= RemoveOwn(pVTable, vecNodes);
+			}
+		}
+
+		if (bRemoved)
+		{
+			CEpoch::Synchronize();
+		}
+	}
+
+	// Returns true if this instance has no callbacks.
+	bool IsEmpty() const
+	{
+		std::lock_guard<std::mutex> lock(sm_mutex);
+
+		return std::none_of(sm_slots.begin(), sm_slots.end(), [this](const auto& slot)
+		{
+			const Entry_t* pEntry = sm_vcallbacks.Find(slot.first.m_diff);
+
+			return pEntry && std::find(pEntry->m_vecOwners.begin(), pEntry->m_vecOwners.end(), this) != pEntry->m_vecOwners.end();
+		});
+	}
+
+	// Invokes the original (unhooked) implementation for the vtable of pClass.
+	static R CallOriginal(T pClass, Args... args)
+	{
+		CEpoch::CGuard guard;
+
+		const Entry_t* pEntry = sm_vcallbacks.Find(CVirtualTable(pClass).m_diff);
+
+		assert(pEntry);
+
+		return pEntry->m_pfnOriginal(pClass, args...);
 	}
 
 protected:
-	inline static std::map<CVirtualTable, std::vector<Function_t>> sm_vcallbacks;
-}; // class CVTFHookSet<R, T, Args...>
+	using Slots_t = std::map<CVirtualTable, CVTHook<R, T, Args...>>;
+
+	// The trampoline installed into every hooked slot. One hash probe, then a walk over a contiguous array.
+	// For non-void methods, the result of the last callback is returned.
+	static R Dispatch(T pClass, Args... args)
+	{
+		CEpoch::CGuard guard;
+
+		const Entry_t* pEntry = sm_vcallbacks.Find(CVirtualTable(pClass).m_diff);
+
+		assert(pEntry && "Object's vtable isn't registered in CVTFMHook");
+
+		const auto& vecCallbacks = pEntry->m_vecCallbacks;
+		const std::size_t nCount = vecCallbacks.size();
+
+		if (!nCount)
+		{
+			return pEntry->m_pfnOriginal(pClass, args...);
+		}
+
+		for (std::size_t n = 0; n + 1 < nCount; ++n)
+		{
+			vecCallbacks[n](pClass, args...);
+		}
+
+		return vecCallbacks[nCount - 1](pClass, args...);
+	}
+
+	// Publishes the entry of a vtable without the callbacks of this instance (under sm_mutex). The slot
+	// of an emptied entry is restored, its node is moved into vecNodes to be destroyed after a grace period.
+	bool RemoveOwn(CVirtualTable pVTable, std::vector<typename Slots_t::node_type>& vecNodes)
+	{
+		const Entry_t* pEntry = sm_vcallbacks.Find(pVTable.m_diff);
+
+		if (!pEntry || std::find(pEntry->m_vecOwners.begin(), pEntry->m_vecOwners.end(), this) == pEntry->m_vecOwners.end())
+		{
+			return false;
+		}
+
+		bool bEmptied = false;
+
+		sm_vcallbacks.Update(pVTable.m_diff, [&](const Entry_t* pOld)
+		{
+			auto pNew = std::make_unique<Entry_t>();
+
+			pNew->m_pfnOriginal = pOld->m_pfnOriginal;
+
+			for (std::size_t n = 0; n < pOld->m_vecOwners.size(); ++n)
+			{
+				if (pOld->m_vecOwners[n] != this)
+				{
+					pNew->m_vecCallbacks.push_back(pOld->m_vecCallbacks[n]);
+					pNew->m_vecOwners.push_back(pOld->m_vecOwners[n]);
+				}
+			}
+
+			bEmptied = pNew->m_vecCallbacks.empty();
+
+			return pNew;
+		});
+
+		// Restore the slot under the lock (a concurrent AddHook must see the original function); an
+		// emptied entry keeps the original function reachable for calls which are already entering.
+		if (bEmptied)
+		{
+			auto node = sm_slots.extract(pVTable);
+
+			if (node)
+			{
+				node.mapped().Unhook(false);
+				vecNodes.push_back(std::move(node));
+			}
+		}
+
+		return true;
+	}
+
+	inline static CAtomicFlatMap<Entry_t> sm_vcallbacks;
+	inline static Slots_t sm_slots;
+	inline static std::mutex sm_mutex; // Serializes writers (AddHook/RemoveHook/Clear) and guards sm_slots.
+}; // class CVTFMHook<R, T, Args...>
+
+// A class hooks many vtable slots (of one vtable or of several ones) in one protection transaction:
+// hooks are queued with Add() and installed by Commit(), which unprotects each contiguous run of 
+// touched pages once (see WritePointersUnprotected) instead of once per slot as CVTHook does.
+//
+// Example usage:
+//
+//   CVirtualTable vtable = module.GetVirtualTableByName("CEntity");
+//   CVTBatchHook batch;
+//
+//   for (std::size_t n = 0, nLength = vtable.GetLength(module); n < nLength; ++n)
+//       batch.Add(vtable, n, s_aTracers[n]);
+//
+//   batch.Commit();
+//   ...
+//   batch.GetOrigin<void (*)(CEntity*)>(vtable, 3)(pEntity);
+class CVTBatchHook
+{
+public:
+	CVTBatchHook() = default;
+	~CVTBatchHook() { Unhook(); }
+
+	CVTBatchHook(const CVTBatchHook&) = delete;
+	CVTBatchHook& operator=(const CVTBatchHook&) = delete;
+
+	bool IsHooked() const noexcept { return !m_vecHooked.empty(); }
+	std::size_t GetCount() const noexcept { return m_vecHooked.size(); }
+
+	// Queues a slot to hook. METHOD is a pointer‐to‐member function of the target class.
+	template<auto METHOD, typename FN>
+	CVTBatchHook& Add(CVirtualTable pVTable, FN pFn) { return Add(pVTable, GetVirtualIndex<METHOD>(), pFn); }
+	template<typename FN>
+	CVTBatchHook& Add(CVirtualTable pVTable, std::ptrdiff_t nIndex, FN pFn)
+	{
+		static_assert(std::is_pointer_v<FN>, "Hook target must be a function pointer");
+
+		assert(nIndex != DYNLIB_INVALID_VCALL);
+
+		m_vecPending.push_back({&pVTable.GetMethod<void *>(nIndex), nullptr, reinterpret_cast<void *>(pFn)});
+
+		return *this;
+	}
+
+	// Queues the same slot of several vtables (e.g. from CModule::GetVirtualTablesByMethod).
+	template<typename FN>
+	CVTBatchHook& Add(const std::vector<CMemory>& vecVTables, std::ptrdiff_t nIndex, FN pFn)
+	{
+		for (const auto& pVTable : vecVTables)
+			Add(CVirtualTable(pVTable), nIndex, pFn);
+
+		return *this;
+	}
+
+	// Installs the queued hooks. Returns the number of installed ones.
+	std::size_t Commit()
+	{
+		std::vector<std::pair<void**, void*>> vecWrites;
+
+		vecWrites.reserve(m_vecPending.size());
+
+		for (auto& entry : m_vecPending)
+		{
+			assert(!FindHooked(entry.m_ppSlot) && "The slot is already hooked by this batch");
+
+			entry.m_pOriginal = *entry.m_ppSlot;
+			vecWrites.emplace_back(entry.m_ppSlot, entry.m_pTarget);
+		}
+
+		WritePointersUnprotected(vecWrites);
+
+		const std::size_t nCount = m_vecPending.size();
+
+		m_vecHooked.insert(m_vecHooked.end(), m_vecPending.begin(), m_vecPending.end());
+		m_vecPending.clear();
+
+		std::sort(m_vecHooked.begin(), m_vecHooked.end(), [](const Entry_t& left, const Entry_t& right) { return left.m_ppSlot < right.m_ppSlot; });
+
+		return nCount;
+	}
+
+	// Restores every hooked slot in one transaction and waits for a CEpoch grace period.
+	bool Unhook()
+	{
+		m_vecPending.clear();
+
+		if (!IsHooked())
+		{
+			return false;
+		}
+
+		std::vector<std::pair<void**, void*>> vecWrites;
+
+		vecWrites.reserve(m_vecHooked.size());
+
+		for (const auto& entry : m_vecHooked)
+		{
+			vecWrites.emplace_back(entry.m_ppSlot, entry.m_pOriginal);
+		}
+
+		WritePointersUnprotected(vecWrites);
+		m_vecHooked.clear();
+		CEpoch::Synchronize();
+
+		return true;
+	}
+
+	// Returns the original function of a hooked slot (nullptr if the slot isn't hooked by this batch).
+	template<typename T = void*>
+	T GetOrigin(CVirtualTable pVTable, std::ptrdiff_t nIndex) const noexcept
+	{
+		const Entry_t* pEntry = FindHooked(&pVTable.GetMethod<void *>(nIndex));
+
+		return reinterpret_cast<T>(pEntry ? pEntry->m_pOriginal : nullptr);
+	}
+
+private:
+	struct Entry_t
+	{
+		void** m_ppSlot;
+		void* m_pOriginal;
+		void* m_pTarget;
+	};
+
+	const Entry_t* FindHooked(void** ppSlot) const noexcept
+	{
+		auto it = std::lower_bound(m_vecHooked.begin(), m_vecHooked.end(), ppSlot, [](const Entry_t& entry, void** ppValue) { return entry.m_ppSlot < ppValue; });
+
+		return it != m_vecHooked.end() && it->m_ppSlot == ppSlot ? &*it : nullptr;
+	}
+
+	std::vector<Entry_t> m_vecPending;
+	std::vector<Entry_t> m_vecHooked; // Sorted by slot address.
+}; // class CVTBatchHook
+
+#ifndef __APPLE__
+// A class hooks the imports of a symbol: the GOT (ELF) or IAT (PE) slots the calls of a module go
+// through are redirected to the hook, so calls made by other modules are left untouched. Slots
+// of several modules are patched in one protection transaction (see WritePointersUnprotected),
+// and slots which are writable as loaded (lazy binding) are stored to without any protection change.
+//
+// Not available on macOS, where CModule does not list the imports.
+//
+// Example usage:
+//
+//   CImportHook hook;
+//
+//   if (hook.HookAll("send", &Send_Hook))
+//       ...
+//   hook.GetOrigin<decltype(&send)>()(nSocket, pBuffer, nLength, nFlags);
+class CImportHook
+{
+public:
+	CImportHook() = default;
+	~CImportHook() { Unhook(); }
+
+	CImportHook(const CImportHook&) = delete;
+	CImportHook& operator=(const CImportHook&) = delete;
+
+	bool IsHooked() const noexcept { return !m_vecHooked.empty(); }
+	std::size_t GetCount() const noexcept { return m_vecHooked.size(); }
+
+	// Hooks the imports of a symbol by a module. Returns the number of hooked slots.
+	template<typename FN>
+	std::size_t Hook(const CModule& module, const std::string_view svSymbolName, FN pFn) { return Hook(module.GetImports(svSymbolName), reinterpret_cast<void *>(pFn)); }
+
+	// Hooks the imports of a symbol by every loaded module. Returns the number of hooked slots.
+	template<typename FN>
+	std::size_t HookAll(const std::string_view svSymbolName, FN pFn) { return Hook(CModule::GetLoadedImports(svSymbolName), reinterpret_cast<void *>(pFn)); }
+
+	// Hooks the given imports (e.g. filtered from CModule::GetImports). Returns the number of hooked slots.
+	std::size_t Hook(const std::vector<Import_t>& vecImports, void* pFn)
+	{
+		std::vector<std::pair<void**, void*>> vecWrites;
+		std::size_t nCount = 0;
+
+		for (const auto& import : vecImports)
+		{
+			auto** ppSlot = import.m_pSlot.RCast<void **>();
+			auto it = LowerBound(ppSlot);
+
+			if (it != m_vecHooked.end() && it->m_ppSlot == ppSlot)
+				continue;
+
+			if (!m_pOriginal)
+				m_pOriginal = import.m_pTarget;
+
+			m_vecHooked.insert(it, {ppSlot, *ppSlot, import.m_bWritable});
+
+			if (import.m_bWritable)
+				AtomicStorePointer(ppSlot, pFn);
+			else
+				vecWrites.emplace_back(ppSlot, pFn);
+
+			nCount++;
+		}
+
+		WritePointersUnprotected(vecWrites);
+
+		return nCount;
+	}
+
+	// Restores every hooked slot and waits for a CEpoch grace period.
+	bool Unhook(bool bWait = true)
+	{
+		if (!IsHooked())
+		{
+			return false;
+		}
+
+		std::vector<std::pair<void**, void*>> vecWrites;
+
+		for (const auto& entry : m_vecHooked)
+		{
+			if (entry.m_bWritable)
+				AtomicStorePointer(entry.m_ppSlot, entry.m_pOriginal);
+			else
+				vecWrites.emplace_back(entry.m_ppSlot, entry.m_pOriginal);
+		}
+
+		WritePointersUnprotected(vecWrites);
+		m_vecHooked.clear();
+		m_pOriginal = nullptr;
+
+		if (bWait)
+			CEpoch::Synchronize();
+
+		return true;
+	}
+
+	// Returns the function the symbol resolves to (resolved even if a lazy slot was not bound yet).
+	template<typename T = void*>
+	T GetOrigin() const noexcept { return m_pOriginal.RCast<T>(); }
+
+private:
+	struct Entry_t
+	{
+		void** m_ppSlot;
+		void* m_pOriginal;
+		bool m_bWritable;
+	};
+
+	std::vector<Entry_t>::iterator LowerBound(void** ppSlot) noexcept
+	{
+		return std::lower_bound(m_vecHooked.begin(), m_vecHooked.end(), ppSlot, [](const Entry_t& entry, void** ppValue) { return entry.m_ppSlot < ppValue; });
+	}
+
+	CMemory m_pOriginal;
+	std::vector<Entry_t> m_vecHooked; // Sorted by slot address.
+}; // class CImportHook
+#endif // !__APPLE__
+
+// A pool of pointer arrays for shadow vtables. Arrays are grouped by power-of-two size classes 
+// and recycled through per-class free lists; memory is carved out of large blocks which are kept 
+// for the lifetime of the process, so Attach/Detach never hit the system allocator in steady state.
+class CVTShadowArena final
+{
+public:
+	static CVTShadowArena& Get() { static CVTShadowArena s_arena; return s_arena; }
+
+	void** Allocate(std::size_t nPointers)
+	{
+		const std::size_t nClass = GetSizeClass(nPointers);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto& vecFree = m_aFreeLists[nClass];
+
+		if (!vecFree.empty())
+		{
+			void** pResult = vecFree.back();
+
+			vecFree.pop_back();
+
+			return pResult;
+		}
+
+		const std::size_t nSize = GetClassSize(nClass);
+
+		if (m_nBlockUsed + nSize > m_nBlockSize)
+		{
+			m_nBlockSize = std::max<std::size_t>(sm_nBlockPointers, nSize);
+			m_vecBlocks.push_back(std::make_unique<void*[]>(m_nBlockSize));
+			m_nBlockUsed = 0;
+		}
+
+		void** pResult = m_vecBlocks.back().get() + m_nBlockUsed;
+
+		m_nBlockUsed += nSize;
+
+		return pResult;
+	}
+
+	void Free(void** pArray, std::size_t nPointers)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_aFreeLists[GetSizeClass(nPointers)].push_back(pArray);
+	}
+
+private:
+	static constexpr std::size_t sm_nMinClassPointers = 16;
+	static constexpr std::size_t sm_nBlockPointers = 8192; // 64 KiB on 64-bit.
+	static constexpr std::size_t sm_nClasses = sizeof(std::size_t) * 8;
+
+	static std::size_t GetSizeClass(std::size_t nPointers) noexcept
+	{
+		std::size_t nClass = 0;
+
+		while (GetClassSize(nClass) < nPointers)
+			++nClass;
+
+		return nClass;
+	}
+	static std::size_t GetClassSize(std::size_t nClass) noexcept { return sm_nMinClassPointers << nClass; }
+
+	std::mutex m_mutex;
+	std::array<std::vector<void**>, sm_nClasses> m_aFreeLists;
+	std::vector<std::unique_ptr<void*[]>> m_vecBlocks;
+	std::size_t m_nBlockSize = 0;
+	std::size_t m_nBlockUsed = 0;
+}; // class CVTShadowArena
+
+// A class hooks virtual methods of a single object by shadowing its vtable (VMT shadowing):
+//   1. The object's vtable, including the RTTI prefix (offset-to-top/typeinfo or the complete 
+//      object locator, see DYNLIB_VTABLE_PREFIX_SIZE), is copied into a CVTShadowArena array.
+//   2. Slots are patched in the copy only.
+//   3. The object's vptr is swapped to the copy with one atomic store.
+//
+// Unlike CVTHook, no page protection is changed and other instances of the class keep running 
+// through the original vtable without any overhead. RTTI (typeid, dynamic_cast) keeps working, as 
+// the prefix is preserved.
+//
+// Thread safety: Detach() restores the vptr atomically and frees the copy after a CEpoch grace 
+// period; replacement functions that may race with Detach() should wrap their body into a 
+// CEpoch::CGuard.
+//
+// Example usage:
+//
+//   CVTShadowHook shadow;
+//
+//   shadow.Attach(pEntity, nMethodCount);
+//   shadow.Hook<&CEntity::Think>(+[](CEntity* pThis) { ... shadow.Call<void>(GetVirtualIndex<&CEntity::Think>(), pThis); });
+//   ...
+//   shadow.Detach();
+class CVTShadowHook
+{
+public:
+	CVTShadowHook() noexcept : m_ppObjectVTable(nullptr), m_pShadow(nullptr), m_nMethods(0), m_nPrefix(0) {}
+	~CVTShadowHook() { Detach(); }
+
+	CVTShadowHook(const CVTShadowHook&) = delete;
+	CVTShadowHook& operator=(const CVTShadowHook&) = delete;
+
+	bool IsAttached() const noexcept { return m_ppObjectVTable != nullptr; }
+
+	// Shadows the vtable of pObject:
+	//   - pObject:  a polymorphic object (its first pointer-sized field is the vptr).
+	//   - nMethods:  the number of virtual methods to copy (slots [0, nMethods)).
+	//   - nPrefix (optional):  the number of entries preceding the first method to copy.
+	bool Attach(void* pObject, std::size_t nMethods, std::size_t nPrefix = DYNLIB_VTABLE_PREFIX_SIZE)
+	{
+		assert(!IsAttached());
+		assert(pObject && nMethods);
+
+		if (IsAttached() || !pObject || !nMethods)
+		{
+			return false;
+		}
+
+		m_ppObjectVTable = reinterpret_cast<void***>(pObject);
+		m_original = CVirtualTable(pObject);
+		m_nMethods = nMethods;
+		m_nPrefix = nPrefix;
+
+		void** pCopy = CVTShadowArena::Get().Allocate(nPrefix + nMethods);
+
+		std::copy_n(m_original.m_pVTFs - nPrefix, nPrefix + nMethods, pCopy);
+
+		m_pShadow = pCopy + nPrefix;
+		AtomicStorePointer(reinterpret_cast<void **>(m_ppObjectVTable), m_pShadow);
+
+		return true;
+	}
+
+	// Restores the original vptr of the object and releases the copy after a grace period.
+	bool Detach()
+	{
+		if (!IsAttached())
+		{
+			return false;
+		}
+
+		AtomicStorePointer(reinterpret_cast<void **>(m_ppObjectVTable), m_original.m_pVTFs);
+
+		void** pCopy = m_pShadow - m_nPrefix;
+		const std::size_t nPointers = m_nPrefix + m_nMethods;
+
+		if (CEpoch::Synchronize())
+		{
+			CVTShadowArena::Get().Free(pCopy, nPointers);
+		}
+		else
+		{
+			CEpoch::Retire([pCopy, nPointers]() { CVTShadowArena::Get().Free(pCopy, nPointers); });
+		}
+
+		m_ppObjectVTable = nullptr;
+		m_pShadow = nullptr;
+		m_original = CVirtualTable();
+
+		return true;
+	}
+
+	// Replaces a slot of the shadow vtable. METHOD is a pointer‐to‐member function of the target class.
+	template<auto METHOD, typename FN>
+	void Hook(FN pFn) noexcept { Hook(GetVirtualIndex<METHOD>(), pFn); }
+	template<typename FN>
+	void Hook(std::ptrdiff_t nIndex, FN pFn) noexcept
+	{
+		static_assert(std::is_pointer_v<FN> && std::is_function_v<std::remove_pointer_t<FN>>, "Hook target must be a function pointer");
+
+		assert(IsAttached());
+		assert(nIndex != DYNLIB_INVALID_VCALL && static_cast<std::size_t>(nIndex) < m_nMethods);
+
+		AtomicStorePointer(&m_pShadow[nIndex], reinterpret_cast<void *>(pFn));
+	}
+
+	// Puts the original function back into a slot of the shadow vtable.
+	template<auto METHOD>
+	void Unhook() noexcept { Unhook(GetVirtualIndex<METHOD>()); }
+	void Unhook(std::ptrdiff_t nIndex) noexcept
+	{
+		assert(IsAttached());
+		assert(nIndex != DYNLIB_INVALID_VCALL && static_cast<std::size_t>(nIndex) < m_nMethods);
+
+		AtomicStorePointer(&m_pShadow[nIndex], m_original.GetMethod<void *>(nIndex));
+	}
+
+	bool IsHooked(std::ptrdiff_t nIndex) const noexcept { return IsAttached() && m_pShadow[nIndex] != m_original.GetMethod<void *>(nIndex); }
+
+	CVirtualTable GetOriginal() const noexcept { return m_original; } // The shared vtable of the class.
+	CVirtualTable GetShadow() const noexcept { return CMemory(m_pShadow); } // The per-object copy.
+	std::size_t GetMethodCount() const noexcept { return m_nMethods; }
+
+	// Invokes the original implementation of a slot (see CVirtualTable::CallMethod).
+	template<typename R, typename ...Args>
+	R Call(std::ptrdiff_t nIndex, Args... args) const { return m_original.CallMethod<R, Args...>(nIndex, args...); }
+
+private:
+	void*** m_ppObjectVTable; // The vptr field of the object.
+	void** m_pShadow; // The first method of the copy.
+	CVirtualTable m_original;
+	std::size_t m_nMethods;
+	std::size_t m_nPrefix;
+}; // class CVTShadowHook
 
 // ========================================================================================
 // CVTHookAutoBase: Automatic wrapper for member function pointers
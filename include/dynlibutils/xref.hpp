@@ -0,0 +1,95 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#ifndef DYNLIBUTILS_XREF_HPP
+#define DYNLIBUTILS_XREF_HPP
+
+#pragma once
+
+#include "memaddr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DynLibUtils {
+
+class CModule;
+
+// Kinds of cross-references.
+enum XRefType_t : std::uint8_t
+{
+	XREF_CALL = 0, // call rel32
+	XREF_JUMP,     // jmp rel32 (tail calls, thunks)
+	XREF_DATA,     // RIP-relative memory operand (lea/mov/cmp ... [rip+disp32], call/jmp [rip+disp32])
+};
+
+struct XRef_t
+{
+	CMemory m_pFrom;     // Referencing instruction.
+	CMemory m_pTo;       // Referenced address.
+	XRefType_t m_eType;
+};
+
+// A cross-reference index of a module: every direct `call`/`jmp rel32` of its executable sections
+// whose destination is code of the module, and every RIP-relative memory operand which refers to
+// the module image (strings, globals, vtables, import slots), sorted both by source and by
+// destination, so the callers of a function, the code using a string and the callees of a range
+// are binary searches.
+//
+// The index is built by a SSE2 sweep over the code for E8/E9 bytes whose rel32 lands in the
+// executable sections, and the candidates are then validated against the instruction boundaries
+// of a linear decoder sweep (see DecodeInstruction), which drops the bytes that are part of other
+// instructions (displacements, immediates, ...). The same sweep collects the RIP-relative operands.
+//
+// Example usage:
+//
+//   CXRefIndex xrefs(module);
+//
+//   // The unique function which calls a known one.
+//   CMemory pCall = xrefs.GetUniqueReference(pKnownFunction, XREF_CALL);
+//
+//   // The code which loads a string.
+//   for (const auto& xref : xrefs.GetReferencesTo(pString))
+//       ...
+class CXRefIndex
+{
+public:
+	CXRefIndex() = default;
+	explicit CXRefIndex(const CModule& module) { Build(module); }
+
+	// (Re)builds the index. Returns the number of cross-references.
+	std::size_t Build(const CModule& module);
+
+	bool IsBuilt() const noexcept { return m_pBase != 0; }
+	std::size_t GetCount() const noexcept { return m_vecBySource.size(); }
+
+	// Returns the references to an address (e.g. the callers of a function, the users of a string), sorted by source.
+	std::vector<XRef_t> GetReferencesTo(const CMemory pTarget) const;
+
+	// Returns the references made from [pBegin, pEnd) (e.g. the callees of a function), sorted by source.
+	std::vector<XRef_t> GetReferencesFrom(const CMemory pBegin, const CMemory pEnd) const;
+
+	// Returns the source of the only reference of a kind to an address (DYNLIB_INVALID_MEMORY if there are none or several).
+	CMemory GetUniqueReference(const CMemory pTarget, XRefType_t eType) const;
+
+private:
+	// Offsets from the module base: half the size of pointers.
+	struct Entry_t
+	{
+		std::uint32_t m_nFrom;
+		std::uint32_t m_nTo;
+		XRefType_t m_eType;
+	};
+
+	XRef_t ToXRef(const Entry_t& entry) const noexcept { return {m_pBase + entry.m_nFrom, m_pBase + entry.m_nTo, entry.m_eType}; }
+
+	std::uintptr_t m_pBase = 0;
+	std::vector<Entry_t> m_vecBySource; // Sorted by m_nFrom.
+	std::vector<Entry_t> m_vecByTarget; // Sorted by m_nTo, then by m_nFrom.
+}; // class CXRefIndex
+
+} // namespace DynLibUtils
+
+#endif // DYNLIBUTILS_XREF_HPP
@@ -0,0 +1,166 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/memsource.hpp>
+
+#include <libproc.h>
+#include <mach/mach.h>
+#include <mach/mach_vm.h>
+#include <unistd.h>
+
+using namespace DynLibUtils;
+
+ProcessId_t CMemorySource::GetCurrentPid() noexcept
+{
+	return getpid();
+}
+
+bool CMemorySource::Open()
+{
+	if (m_bLocal)
+	{
+		m_hProcess = mach_task_self();
+
+		return true;
+	}
+
+	mach_port_t task;
+
+	if (task_for_pid(mach_task_self(), m_nPid, &task) != KERN_SUCCESS)
+		return false;
+
+	m_hProcess = task;
+
+	return true;
+}
+
+void CMemorySource::Close() noexcept
+{
+	if (!m_bLocal && m_hProcess)
+		mach_port_deallocate(mach_task_self(), static_cast<mach_port_t>(m_hProcess));
+
+	m_hProcess = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads memory of another task with mach_vm_read_overwrite
+// Input  : pAddress
+//          pBuffer
+//          nSize
+// Output : std::size_t (the number of bytes read, up to the first unreadable piece)
+//-----------------------------------------------------------------------------
+std::size_t CMemorySource::ReadRemote(std::uintptr_t pAddress, void* pBuffer, std::size_t nSize) const
+{
+	const auto task = static_cast<mach_port_t>(m_hProcess);
+
+	mach_vm_size_t nRead = 0;
+
+	if (mach_vm_read_overwrite(task, pAddress, nSize, reinterpret_cast<mach_vm_address_t>(pBuffer), &nRead) == KERN_SUCCESS)
+		return static_cast<std::size_t>(nRead);
+
+	// The pieces are read up to the first one which fails.
+	std::size_t nDone = 0;
+
+	for (std::uintptr_t p = pAddress, pEnd = pAddress + nSize; p < pEnd; )
+	{
+		const std::uintptr_t pNext = std::min((p & ~(sm_nPieceSize - 1)) + sm_nPieceSize, pEnd);
+
+		if (mach_vm_read_overwrite(task, p, pNext - p, reinterpret_cast<mach_vm_address_t>(static_cast<std::uint8_t*>(pBuffer) + nDone), &nRead) != KERN_SUCCESS || nRead != pNext - p)
+			break;
+
+		nDone += pNext - p;
+		p = pNext;
+	}
+
+	return nDone;
+}
+
+std::size_t CMemorySource::ReadBatchRemote(ReadRequest_t* pRequests, std::size_t nCount) const
+{
+	std::size_t nFull = 0;
+
+	for (std::size_t n = 0; n < nCount; ++n)
+	{
+		ReadRequest_t& request = pRequests[n];
+
+		request.m_nRead = request.m_nSize ? ReadRemote(request.m_pAddress, request.m_pBuffer, request.m_nSize) : 0;
+		nFull += request.m_nRead == request.m_nSize;
+	}
+
+	return nFull;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Walks the regions of the task with mach_vm_region
+// Input  : vecRegions - receives them, sorted by address
+// Output : false if the task can't be queried
+//-----------------------------------------------------------------------------
+bool CMemorySource::GetRegions(std::vector<Region_t>& vecRegions) const
+{
+	if (!m_bValid)
+		return false;
+
+	mach_vm_address_t pAddress = 0;
+	mach_vm_size_t nSize = 0;
+
+	for (;;)
+	{
+		vm_region_basic_info_data_64_t info;
+		mach_msg_type_number_t nCount = VM_REGION_BASIC_INFO_COUNT_64;
+		mach_port_t object;
+
+		if (mach_vm_region(static_cast<mach_port_t>(m_hProcess), &pAddress, &nSize, VM_REGION_BASIC_INFO_64, reinterpret_cast<vm_region_info_t>(&info), &nCount, &object) != KERN_SUCCESS)
+			break;
+
+		std::uint8_t nFlags = 0;
+
+		if (info.protection & VM_PROT_READ)
+			nFlags |= Region_t::Readable;
+
+		if (info.protection & VM_PROT_WRITE)
+			nFlags |= Region_t::Writable;
+
+		if (info.protection & VM_PROT_EXECUTE)
+			nFlags |= Region_t::Executable;
+
+		vecRegions.push_back({static_cast<std::uintptr_t>(pAddress), static_cast<std::uintptr_t>(pAddress + nSize), nFlags});
+
+		pAddress += nSize;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the regions of the task which map a module (proc_regionfilename)
+// Input  : svModuleName - the file name or the path
+//          vecRegions - receives them, sorted by address
+// Output : false if the module is not mapped
+//-----------------------------------------------------------------------------
+bool CMemorySource::GetModuleRegions(const std::string_view svModuleName, std::vector<Region_t>& vecRegions) const
+{
+	std::vector<Region_t> vecAll;
+
+	if (!GetRegions(vecAll))
+		return false;
+
+	const std::size_t nPrevious = vecRegions.size();
+
+	char szPath[PROC_PIDPATHINFO_MAXSIZE];
+
+	for (const auto& region : vecAll)
+	{
+		const int nLength = proc_regionfilename(m_nPid, region.m_pBegin, szPath, sizeof(szPath));
+
+		if (nLength <= 0)
+			continue;
+
+		const std::string_view svPath(szPath, static_cast<std::size_t>(nLength));
+
+		if (svPath == svModuleName || svPath.substr(svPath.find_last_of('/') + 1) == svModuleName)
+			vecRegions.push_back(region);
+	}
+
+	return vecRegions.size() > nPrevious;
+}
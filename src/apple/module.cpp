@@ -133,12 +133,24 @@ bool CModule::LoadFromPath(const std::string_view svModelePath, int flags)
 			const MachSegment* seg = reinterpret_cast<const MachSegment*>(cmd);
 			const MachSection* sec = reinterpret_cast<const MachSection*>(reinterpret_cast<uintptr_t>(seg) + sizeof(MachSegment));
 
+			std::uint8_t nFlags = 0;
+
+			if (seg->initprot & VM_PROT_READ)
+				nFlags |= Section_t::Readable;
+
+			if (seg->initprot & VM_PROT_WRITE)
+				nFlags |= Section_t::Writable;
+
+			if (seg->initprot & VM_PROT_EXECUTE)
+				nFlags |= Section_t::Executable;
+
 			for (uint32_t j = 0; j < seg->nsects; ++j) {
 				const MachSection& section = sec[j];
 				m_vecSections.emplace_back(
 					GetAddr() + section.addr,
 					section.size,
-					section.sectname
+					section.sectname,
+					nFlags
 				);
 			}
 		}
@@ -187,5 +199,6 @@ CMemory CModule::GetBase() const noexcept
 
 void CModule::SaveLastError()
 {
-	m_sLastError = dlerror();
+	const char* pszError = dlerror(); // May be null (e.g. RTLD_NOLOAD of a module that is not loaded).
+	m_sLastError = pszError ? pszError : "";
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/regions.hpp>
+
+#include <mach/mach.h>
+#include <mach/mach_vm.h>
+#include <mach-o/dyld.h>
+
+using namespace DynLibUtils;
+
+//-----------------------------------------------------------------------------
+// Purpose: Walks the regions of the task with mach_vm_region
+// Input  : vecRegions - receives them, sorted by address
+// Output : true
+//-----------------------------------------------------------------------------
+bool CRegionMap::Collect(std::vector<Region_t>& vecRegions)
+{
+	mach_vm_address_t pAddress = 0;
+	mach_vm_size_t nSize = 0;
+
+	for (;;)
+	{
+		vm_region_basic_info_data_64_t info;
+		mach_msg_type_number_t nCount = VM_REGION_BASIC_INFO_COUNT_64;
+		mach_port_t object;
+
+		if (mach_vm_region(mach_task_self(), &pAddress, &nSize, VM_REGION_BASIC_INFO_64, reinterpret_cast<vm_region_info_t>(&info), &nCount, &object) != KERN_SUCCESS)
+			break;
+
+		std::uint8_t nFlags = 0;
+
+		if (info.protection & VM_PROT_READ)
+			nFlags |= Region_t::Readable;
+
+		if (info.protection & VM_PROT_WRITE)
+			nFlags |= Region_t::Writable;
+
+		if (info.protection & VM_PROT_EXECUTE)
+			nFlags |= Region_t::Executable;
+
+		vecRegions.push_back({static_cast<std::uintptr_t>(pAddress), static_cast<std::uintptr_t>(pAddress + nSize), nFlags});
+
+		pAddress += nSize;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks the access of a range with mach_vm_region
+// Input  : pAddress
+//          nSize
+//          nFlags
+//          bAccess - receives the result
+// Output : true
+//-----------------------------------------------------------------------------
+bool CRegionMap::Probe(std::uintptr_t pAddress, std::size_t nSize, std::uint8_t nFlags, bool& bAccess)
+{
+	const std::uintptr_t pEnd = pAddress + (nSize ? nSize : 1);
+
+	bAccess = pAddress < pEnd;
+
+	for (std::uintptr_t p = pAddress; bAccess && p < pEnd; )
+	{
+		mach_vm_address_t pRegion = p; // Moved to the next region if p is not mapped.
+		mach_vm_size_t nRegionSize = 0;
+
+		vm_region_basic_info_data_64_t info;
+		mach_msg_type_number_t nCount = VM_REGION_BASIC_INFO_COUNT_64;
+		mach_port_t object;
+
+		if (mach_vm_region(mach_task_self(), &pRegion, &nRegionSize, VM_REGION_BASIC_INFO_64, reinterpret_cast<vm_region_info_t>(&info), &nCount, &object) != KERN_SUCCESS || pRegion > p)
+		{
+			bAccess = false;
+
+			break;
+		}
+
+		std::uint8_t nRegionFlags = 0;
+
+		if (info.protection & VM_PROT_READ)
+			nRegionFlags |= Region_t::Readable;
+
+		if (info.protection & VM_PROT_WRITE)
+			nRegionFlags |= Region_t::Writable;
+
+		if (info.protection & VM_PROT_EXECUTE)
+			nRegionFlags |= Region_t::Executable;
+
+		bAccess = (nRegionFlags & nFlags) == nFlags;
+		p = static_cast<std::uintptr_t>(pRegion + nRegionSize);
+	}
+
+	return true;
+}
+
+static std::atomic<std::uint64_t> s_nModuleGeneration {0};
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the number of module loads and unloads (since the first call)
+// Output : std::uint64_t
+//-----------------------------------------------------------------------------
+std::uint64_t CRegionMap::GetModuleGeneration()
+{
+	static const bool s_bRegistered = []()
+	{
+		// Also called for the images loaded at registration.
+		_dyld_register_func_for_add_image([](const mach_header*, intptr_t) { s_nModuleGeneration.fetch_add(1, std::memory_order_relaxed); });
+		_dyld_register_func_for_remove_image([](const mach_header*, intptr_t) { s_nModuleGeneration.fetch_add(1, std::memory_order_relaxed); });
+
+		return true;
+	}();
+
+	return s_nModuleGeneration.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,23 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/snapshot.hpp>
+
+using namespace DynLibUtils;
+
+// macOS has no soft-dirty bits: the snapshots compare their whole ranges.
+bool CMemorySnapshot::IsSoftDirtySupported()
+{
+	return false;
+}
+
+bool CMemorySnapshot::ClearSoftDirty()
+{
+	return false;
+}
+
+bool CMemorySnapshot::CollectDirtySpans(std::uintptr_t pBegin, std::uintptr_t pEnd, std::vector<Span_t>& vecSpans)
+{
+	return false;
+}
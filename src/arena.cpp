@@ -0,0 +1,428 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/arena.hpp>
+#include <dynlibutils/module.hpp>
+#include <dynlibutils/vthook.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#	undef WIN32_LEAN_AND_MEAN
+#else
+#	include <cerrno>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#	ifdef __APPLE__
+#		include <mach/mach.h>
+#		include <mach/mach_vm.h>
+#	endif
+#endif
+
+using namespace DynLibUtils;
+
+static constexpr std::uintptr_t s_nMaxNearDistance = 0x7FFF0000; // Keeps rel32 reach between any two bytes of the code and a chunk.
+static constexpr std::uintptr_t s_nMinAddress = 0x10000;
+static constexpr std::uintptr_t s_nMaxAddress = 0x7FFFFFFF0000;
+
+// Checks that every byte of [pBegin, pBegin + nSize) can reach every byte of [pLow, pHigh] with a rel32 operand.
+static bool IsInReach(std::uintptr_t pBegin, std::size_t nSize, std::uintptr_t pLow, std::uintptr_t pHigh) noexcept
+{
+	if (!pLow)
+		return true;
+
+	return std::max(pBegin + nSize, pHigh) - std::min(pBegin, pLow) < s_nMaxNearDistance;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Collects the unmapped ranges of the address space between two addresses
+// Input  : pFrom
+//          pTo
+// Output : std::vector<std::pair<std::uintptr_t, std::uintptr_t>> ([begin, end) ranges)
+//-----------------------------------------------------------------------------
+static std::vector<std::pair<std::uintptr_t, std::uintptr_t>> GetFreeRanges(std::uintptr_t pFrom, std::uintptr_t pTo)
+{
+	std::vector<std::pair<std::uintptr_t, std::uintptr_t>> vecFree;
+
+#ifdef _WIN32
+	for (std::uintptr_t pAddress = pFrom; pAddress < pTo; )
+	{
+		MEMORY_BASIC_INFORMATION mbi;
+
+		if (!VirtualQuery(reinterpret_cast<void*>(pAddress), &mbi, sizeof(mbi)))
+			break;
+
+		const auto pRegion = reinterpret_cast<std::uintptr_t>(mbi.BaseAddress);
+
+		if (mbi.State == MEM_FREE)
+			vecFree.emplace_back(pRegion, pRegion + mbi.RegionSize);
+
+		pAddress = pRegion + mbi.RegionSize;
+	}
+#else
+	std::vector<std::pair<std::uintptr_t, std::uintptr_t>> vecMapped;
+
+#	ifdef __APPLE__
+	mach_vm_address_t nAddress = pFrom;
+	mach_vm_size_t nSize = 0;
+	vm_region_basic_info_data_64_t info;
+	mach_msg_type_number_t nCount = VM_REGION_BASIC_INFO_COUNT_64;
+	mach_port_t nObject;
+
+	while (nAddress < pTo && mach_vm_region(mach_task_self(), &nAddress, &nSize, VM_REGION_BASIC_INFO_64, reinterpret_cast<vm_region_info_t>(&info), &nCount, &nObject) == KERN_SUCCESS)
+	{
+		vecMapped.emplace_back(nAddress, nAddress + nSize);
+		nAddress += nSize;
+		nCount = VM_REGION_BASIC_INFO_COUNT_64;
+	}
+#	else
+	FILE* pMaps = std::fopen("/proc/self/maps", "r");
+
+	if (!pMaps)
+		return vecFree;
+
+	char szLine[512];
+
+	while (std::fgets(szLine, sizeof(szLine), pMaps))
+	{
+		unsigned long long nBegin, nEnd;
+
+		if (std::sscanf(szLine, "%llx-%llx", &nBegin, &nEnd) == 2)
+			vecMapped.emplace_back(static_cast<std::uintptr_t>(nBegin), static_cast<std::uintptr_t>(nEnd));
+	}
+
+	std::fclose(pMaps);
+#	endif
+
+	std::uintptr_t pPrevEnd = pFrom;
+
+	for (const auto& [pBegin, pEnd] : vecMapped)
+	{
+		if (pBegin > pPrevEnd)
+			vecFree.emplace_back(pPrevEnd, std::min(pBegin, pTo));
+
+		pPrevEnd = std::max(pPrevEnd, pEnd);
+
+		if (pPrevEnd >= pTo)
+			break;
+	}
+
+	if (pPrevEnd < pTo)
+		vecFree.emplace_back(pPrevEnd, pTo);
+#endif
+
+	return vecFree;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Picks chunk addresses in free gaps within reach of [pLow, pHigh]
+// Input  : nSize
+//          pLow
+//          pHigh
+// Output : std::vector<std::uintptr_t> (candidates, closest first)
+//-----------------------------------------------------------------------------
+static std::vector<std::uintptr_t> FindChunkCandidates(std::size_t nSize, std::uintptr_t pLow, std::uintptr_t pHigh)
+{
+	constexpr std::uintptr_t nAlign = CCodeArena::sm_nChunkSize; // The allocation granularity on Windows.
+
+	const std::uintptr_t pFrom = std::max(s_nMinAddress, pHigh > s_nMaxNearDistance ? pHigh - s_nMaxNearDistance : 0);
+	const std::uintptr_t pTo = std::min(s_nMaxAddress, pLow + s_nMaxNearDistance);
+
+	std::vector<std::pair<std::uintptr_t, std::uintptr_t>> vecCandidates; // Distance, address.
+
+	for (const auto& [pBegin, pEnd] : GetFreeRanges(pFrom, pTo))
+	{
+		const std::uintptr_t pFirst = (pBegin + nAlign - 1) & ~(nAlign - 1);
+		const std::uintptr_t pLast = ((pEnd - nSize) & ~(nAlign - 1));
+
+		if (pEnd - pBegin < nSize || pFirst > pLast)
+			continue;
+
+		// The gap ends closest to the code.
+		for (const std::uintptr_t pCandidate : {pFirst, pLast})
+		{
+			if (!IsInReach(pCandidate, nSize, pLow, pHigh))
+				continue;
+
+			const std::uintptr_t nDistance = pCandidate < pLow ? pLow - pCandidate : pCandidate > pHigh ? pCandidate - pHigh : 0;
+
+			vecCandidates.emplace_back(nDistance, pCandidate);
+		}
+	}
+
+	std::sort(vecCandidates.begin(), vecCandidates.end());
+
+	std::vector<std::uintptr_t> vecResult;
+
+	vecResult.reserve(vecCandidates.size());
+
+	for (const auto& candidate : vecCandidates)
+		vecResult.push_back(candidate.second);
+
+	return vecResult;
+}
+
+CCodeArena::~CCodeArena()
+{
+	for (const auto& pChunk : m_vecChunks)
+		UnmapChunk(*pChunk);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reserves a chunk of executable memory
+// Input  : nSize - multiple of sm_nChunkSize
+//          pLow, pHigh - code the chunk must be within rel32 reach of (pLow = 0 for anywhere)
+// Output : std::unique_ptr<Chunk_t> (nullptr on failure)
+//-----------------------------------------------------------------------------
+std::unique_ptr<CCodeArena::Chunk_t> CCodeArena::MapChunk(std::size_t nSize, std::uintptr_t pLow, std::uintptr_t pHigh) const
+{
+	std::vector<std::uintptr_t> vecCandidates;
+
+	if (pLow)
+		vecCandidates = FindChunkCandidates(nSize, pLow, pHigh);
+	else
+		vecCandidates.push_back(0);
+
+#ifdef _WIN32
+	for (const std::uintptr_t pCandidate : vecCandidates)
+	{
+		void* pCode = VirtualAlloc(reinterpret_cast<void*>(pCandidate), nSize, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READ);
+
+		if (pCode)
+			return std::make_unique<Chunk_t>(Chunk_t {reinterpret_cast<std::uintptr_t>(pCode), reinterpret_cast<std::uintptr_t>(pCode), nSize, {{0, nSize}}});
+	}
+#else
+	int nFd = -1;
+
+#	if defined(__linux__) && defined(MFD_CLOEXEC)
+	if (m_bDoubleMapping)
+	{
+		nFd = memfd_create("dynlibutils-code", MFD_CLOEXEC);
+
+		if (nFd >= 0 && ftruncate(nFd, static_cast<off_t>(nSize)))
+		{
+			close(nFd);
+			nFd = -1;
+		}
+	}
+#	endif
+
+	for (const std::uintptr_t pCandidate : vecCandidates)
+	{
+		int nFlags = nFd >= 0 ? MAP_SHARED : MAP_PRIVATE | MAP_ANONYMOUS;
+
+#	ifdef MAP_FIXED_NOREPLACE
+		if (pCandidate)
+			nFlags |= MAP_FIXED_NOREPLACE;
+#	endif
+
+		void* pCode = mmap(reinterpret_cast<void*>(pCandidate), nSize, PROT_READ | PROT_EXEC, nFlags, nFd, 0);
+
+		if (pCode == MAP_FAILED && nFd >= 0 && (errno == EPERM || errno == EACCES))
+		{
+			// Executable shared mappings are denied by the policy: fall back to a single mapping.
+			close(nFd);
+			nFd = -1;
+			pCode = mmap(reinterpret_cast<void*>(pCandidate), nSize, PROT_READ | PROT_EXEC, (nFlags & ~MAP_SHARED) | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		}
+
+		if (pCode == MAP_FAILED)
+			continue;
+
+		const auto pCodeAddr = reinterpret_cast<std::uintptr_t>(pCode);
+
+		if (!IsInReach(pCodeAddr, nSize, pLow, pHigh)) // The hint was not honoured.
+		{
+			munmap(pCode, nSize);
+
+			continue;
+		}
+
+		std::uintptr_t pWritableAddr = pCodeAddr;
+
+		if (nFd >= 0)
+		{
+			void* pWritable = mmap(nullptr, nSize, PROT_READ | PROT_WRITE, MAP_SHARED, nFd, 0);
+
+			if (pWritable != MAP_FAILED)
+				pWritableAddr = reinterpret_cast<std::uintptr_t>(pWritable);
+
+			close(nFd);
+		}
+
+		return std::make_unique<Chunk_t>(Chunk_t {pCodeAddr, pWritableAddr, nSize, {{0, nSize}}});
+	}
+
+	if (nFd >= 0)
+		close(nFd);
+#endif
+
+	return nullptr;
+}
+
+void CCodeArena::UnmapChunk(const Chunk_t& chunk)
+{
+#ifdef _WIN32
+	VirtualFree(reinterpret_cast<void*>(chunk.m_pCode), 0, MEM_RELEASE);
+#else
+	if (chunk.m_pWritable != chunk.m_pCode)
+		munmap(reinterpret_cast<void*>(chunk.m_pWritable), chunk.m_nSize);
+
+	munmap(reinterpret_cast<void*>(chunk.m_pCode), chunk.m_nSize);
+#endif
+}
+
+// First fit from the chunk's free list.
+bool CCodeArena::AllocateFrom(Chunk_t& chunk, std::size_t nSize, CodeBlock_t& block)
+{
+	for (auto it = chunk.m_mapFree.begin(); it != chunk.m_mapFree.end(); ++it)
+	{
+		const auto [nOffset, nFree] = *it;
+
+		if (nFree < nSize)
+			continue;
+
+		chunk.m_mapFree.erase(it);
+
+		if (nFree > nSize)
+			chunk.m_mapFree.emplace(nOffset + nSize, nFree - nSize);
+
+		block.m_pCode = chunk.m_pCode + nOffset;
+		block.m_pWritable = chunk.m_pWritable + nOffset;
+		block.m_nSize = nSize;
+
+		return true;
+	}
+
+	return false;
+}
+
+CodeBlock_t CCodeArena::Allocate(std::size_t nSize, std::uintptr_t pLow, std::uintptr_t pHigh)
+{
+	CodeBlock_t block;
+
+	if (!nSize)
+		return block;
+
+	nSize = (nSize + sm_nBlockAlign - 1) & ~(sm_nBlockAlign - 1);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (const auto& pChunk : m_vecChunks)
+	{
+		if (IsInReach(pChunk->m_pCode, pChunk->m_nSize, pLow, pHigh) && AllocateFrom(*pChunk, nSize, block))
+			return block;
+	}
+
+	auto pChunk = MapChunk((nSize + sm_nChunkSize - 1) & ~(sm_nChunkSize - 1), pLow, pHigh);
+
+	if (!pChunk)
+		return block;
+
+	AllocateFrom(*pChunk, nSize, block);
+	m_vecChunks.push_back(std::move(pChunk));
+
+	return block;
+}
+
+CodeBlock_t CCodeArena::Allocate(std::size_t nSize, CMemory pNear)
+{
+	const auto pAddress = static_cast<std::uintptr_t>(pNear.GetAddr());
+
+	return Allocate(nSize, pAddress, pAddress);
+}
+
+CodeBlock_t CCodeArena::Allocate(std::size_t nSize, const CModule& module)
+{
+	std::uintptr_t pLow = static_cast<std::uintptr_t>(module.GetBase().GetAddr()), pHigh = pLow;
+
+	for (const auto& section : module.GetSections())
+	{
+		if (!section.m_nSectionSize)
+			continue;
+
+		pLow = std::min<std::uintptr_t>(pLow, section.GetAddr());
+		pHigh = std::max<std::uintptr_t>(pHigh, section.GetAddr() + section.m_nSectionSize);
+	}
+
+	return Allocate(nSize, pLow, pHigh);
+}
+
+void CCodeArena::Write(const CodeBlock_t& block, const void* pData, std::size_t nLength, std::size_t nOffset)
+{
+	assert(nOffset + nLength <= block.m_nSize);
+
+	void* pCode = block.m_pCode.Offset(static_cast<std::ptrdiff_t>(nOffset));
+
+	if (block.IsDoubleMapped())
+	{
+		std::memcpy(block.m_pWritable.Offset(static_cast<std::ptrdiff_t>(nOffset)), pData, nLength);
+	}
+	else
+	{
+		VirtualUnprotector unprotect(pCode, nLength, true);
+
+		std::memcpy(pCode, pData, nLength);
+	}
+
+#ifdef _WIN32
+	FlushInstructionCache(GetCurrentProcess(), pCode, nLength);
+#else
+	__builtin___clear_cache(static_cast<char*>(pCode), static_cast<char*>(pCode) + nLength);
+#endif
+}
+
+void CCodeArena::Free(const CodeBlock_t& block)
+{
+	if (!block.IsValid())
+		return;
+
+	const auto pCode = static_cast<std::uintptr_t>(block.m_pCode.GetAddr());
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (const auto& pChunk : m_vecChunks)
+	{
+		if (pCode < pChunk->m_pCode || pCode >= pChunk->m_pCode + pChunk->m_nSize)
+			continue;
+
+		auto& mapFree = pChunk->m_mapFree;
+
+		std::size_t nOffset = pCode - pChunk->m_pCode;
+		std::size_t nSize = block.m_nSize;
+
+		// Coalesce with the neighbouring free ranges.
+		auto itNext = mapFree.lower_bound(nOffset);
+
+		if (itNext != mapFree.end() && itNext->first == nOffset + nSize)
+		{
+			nSize += itNext->second;
+			itNext = mapFree.erase(itNext);
+		}
+
+		if (itNext != mapFree.begin())
+		{
+			auto itPrev = std::prev(itNext);
+
+			if (itPrev->first + itPrev->second == nOffset)
+			{
+				nOffset = itPrev->first;
+				nSize += itPrev->second;
+				mapFree.erase(itPrev);
+			}
+		}
+
+		mapFree.emplace(nOffset, nSize);
+
+		return;
+	}
+
+	assert(!"The block does not belong to the arena");
+}
@@ -0,0 +1,577 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/detour.hpp>
+#include <dynlibutils/decoder.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+using namespace DynLibUtils;
+
+// Room for the relocated bytes (at most 16 bytes per stolen instruction), the jump back and the relay.
+static constexpr std::size_t s_nNearTrampolineSize = 128;
+static constexpr std::size_t s_nFarTrampolineSize = 256;
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks if a rel32 operand reaches a destination
+// Input  : pNext - address of the next instruction
+//          pTo
+//-----------------------------------------------------------------------------
+static bool FitsRel32(std::uintptr_t pNext, std::uintptr_t pTo) noexcept
+{
+	const auto nDelta = static_cast<std::int64_t>(pTo - pNext);
+
+	return std::numeric_limits<std::int32_t>::min() <= nDelta && nDelta <= std::numeric_limits<std::int32_t>::max();
+}
+
+static void EmitBytes(std::vector<std::uint8_t>& vecCode, std::initializer_list<std::uint8_t> bytes)
+{
+	vecCode.insert(vecCode.end(), bytes);
+}
+
+template<typename T>
+static void EmitValue(std::vector<std::uint8_t>& vecCode, T value)
+{
+	const auto* pBytes = reinterpret_cast<const std::uint8_t*>(&value);
+
+	vecCode.insert(vecCode.end(), pBytes, pBytes + sizeof(T));
+}
+
+// jmp [rip+0] with the absolute destination right after it (CDetour::sm_nFarJumpSize bytes).
+static void EmitFarJump(std::vector<std::uint8_t>& vecCode, std::uintptr_t pTo)
+{
+	EmitBytes(vecCode, {0xFF, 0x25, 0x00, 0x00, 0x00, 0x00});
+	EmitValue(vecCode, static_cast<std::uint64_t>(pTo));
+}
+
+// jmp rel32, or a far jump.
+static void EmitJump(std::vector<std::uint8_t>& vecCode, std::uintptr_t pFrom, std::uintptr_t pTo)
+{
+	if (FitsRel32(pFrom + CDetour::sm_nNearJumpSize, pTo))
+	{
+		EmitBytes(vecCode, {0xE9});
+		EmitValue(vecCode, static_cast<std::int32_t>(pTo - (pFrom + CDetour::sm_nNearJumpSize)));
+	}
+	else
+	{
+		EmitFarJump(vecCode, pTo);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Relocates whole instructions from the function entry
+// Input  : pSource - the function entry
+//          nMinLength - number of bytes which are going to be overwritten
+//          pDest - address the code is going to be placed at
+//          vecCode - receives the relocated code
+// Output : std::size_t (number of relocated source bytes; 0 on failure)
+//-----------------------------------------------------------------------------
+static std::size_t RelocateCode(const std::uint8_t* pSource, std::size_t nMinLength, std::uintptr_t pDest, std::vector<std::uint8_t>& vecCode)
+{
+	const auto pSourceAddr = reinterpret_cast<std::uintptr_t>(pSource);
+
+	std::size_t nStolen = 0;
+
+	while (nStolen < nMinLength)
+	{
+		const std::uint8_t* pInstr = pSource + nStolen;
+
+		Instruction_t instr;
+
+		const std::size_t nLength = DecodeInstruction(pInstr, instr);
+
+		if (!nLength)
+			return 0;
+
+		const std::uintptr_t pNewIP = pDest + vecCode.size();
+		const std::uint8_t nOpcode = instr.m_nOpcode;
+		const bool bPrimary = instr.m_nMap == OPCODE_MAP_PRIMARY;
+
+		bool bTerminator = false;
+
+		if (instr.IsRelativeBranch())
+		{
+			const std::uintptr_t pTo = instr.GetTarget(pInstr);
+
+			if (pSourceAddr < pTo && pTo < pSourceAddr + std::max(nMinLength, nStolen + nLength))
+				return 0; // A branch into the overwritten bytes.
+
+			if (bPrimary && nOpcode == 0xE8)
+			{
+				if (FitsRel32(pNewIP + 5, pTo))
+				{
+					EmitBytes(vecCode, {0xE8});
+					EmitValue(vecCode, static_cast<std::int32_t>(pTo - (pNewIP + 5)));
+				}
+				else
+				{
+					EmitBytes(vecCode, {0xFF, 0x15, 0x02, 0x00, 0x00, 0x00, 0xEB, 0x08}); // call [rip+2]; jmp +8
+					EmitValue(vecCode, static_cast<std::uint64_t>(pTo));
+				}
+			}
+			else if (bPrimary && (nOpcode == 0xE9 || nOpcode == 0xEB))
+			{
+				EmitJump(vecCode, pNewIP, pTo);
+				bTerminator = true;
+			}
+			else if ((bPrimary && (nOpcode & 0xF0) == 0x70) || (instr.m_nMap == OPCODE_MAP_0F && (nOpcode & 0xF0) == 0x80))
+			{
+				const std::uint8_t nCondition = nOpcode & 0x0F;
+
+				if (FitsRel32(pNewIP + 6, pTo))
+				{
+					EmitBytes(vecCode, {0x0F, static_cast<std::uint8_t>(0x80 | nCondition)});
+					EmitValue(vecCode, static_cast<std::int32_t>(pTo - (pNewIP + 6)));
+				}
+				else
+				{
+					// Skip the jump if the inverse holds. Always the far form: the skip must match its size, and
+					// a rel32 from 2 bytes further might still reach.
+					EmitBytes(vecCode, {static_cast<std::uint8_t>(0x70 | (nCondition ^ 1)), static_cast<std::uint8_t>(CDetour::sm_nFarJumpSize)});
+					EmitFarJump(vecCode, pTo);
+				}
+			}
+			else
+			{
+				return 0; // LOOPcc and JrCXZ have no rel32 form.
+			}
+		}
+		else
+		{
+			const std::size_t nOffset = vecCode.size();
+
+			vecCode.insert(vecCode.end(), pInstr, pInstr + nLength);
+
+			if (instr.IsRipRelative())
+			{
+				const std::uintptr_t pTo = instr.GetTarget(pInstr);
+
+				if (!FitsRel32(pNewIP + nLength, pTo))
+					return 0;
+
+				const auto nDisp = static_cast<std::int32_t>(pTo - (pNewIP + nLength));
+
+				std::memcpy(&vecCode[nOffset + instr.m_nDispOffset], &nDisp, sizeof(nDisp));
+			}
+
+			if (bPrimary)
+			{
+				const std::uint8_t nReg = (instr.m_nModRM >> 3) & 7;
+
+				// ret, retf, int3, and indirect jmp.
+				bTerminator = nOpcode == 0xC3 || nOpcode == 0xC2 || nOpcode == 0xCB || nOpcode == 0xCA || nOpcode == 0xCC || (nOpcode == 0xFF && (nReg == 4 || nReg == 5));
+			}
+		}
+
+		nStolen += nLength;
+
+		if (bTerminator && nStolen < nMinLength)
+		{
+			// The function is shorter than the patch; overwriting int3 padding after it is fine.
+			for (std::size_t n = nStolen; n < nMinLength; ++n)
+			{
+				if (pSource[n] != 0xCC)
+					return 0;
+			}
+
+			return nMinLength;
+		}
+	}
+
+	return nStolen;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Builds the trampoline and the patch
+// Input  : pTarget
+//          pDetour
+// Output : true on success
+//-----------------------------------------------------------------------------
+bool CDetour::Prepare(CMemory pTarget, void* pDetour)
+{
+	assert(!m_block.IsValid() && !m_bHooked);
+
+	if (!pTarget.IsValid() || !pDetour)
+		return false;
+
+	const auto pTargetAddr = static_cast<std::uintptr_t>(pTarget.GetAddr());
+	const auto pDetourAddr = reinterpret_cast<std::uintptr_t>(pDetour);
+
+	CCodeArena& arena = CCodeArena::Get();
+
+	// The arena places a near block within rel32 reach of the target.
+	CodeBlock_t block = arena.Allocate(s_nNearTrampolineSize, pTarget);
+
+	const bool bNear = block.IsValid();
+
+	if (!bNear)
+		block = arena.Allocate(s_nFarTrampolineSize);
+
+	if (!block.IsValid())
+		return false;
+
+	const auto pBlockAddr = static_cast<std::uintptr_t>(block.m_pCode.GetAddr());
+	const std::size_t nPatchSize = bNear ? sm_nNearJumpSize : sm_nFarJumpSize;
+
+	// A patch across an aligned word can only be published through an int3 (see WriteCodeBytes).
+	if ((pTargetAddr & 7) + nPatchSize > 8 && !IsBreakpointPatchingAvailable())
+	{
+		arena.Free(block);
+
+		return false;
+	}
+
+	std::vector<std::uint8_t> vecCode;
+
+	vecCode.reserve(block.m_nSize);
+
+	const std::size_t nStolen = RelocateCode(pTarget.RCast<const std::uint8_t*>(), nPatchSize, pBlockAddr, vecCode);
+
+	if (!nStolen)
+	{
+		arena.Free(block);
+
+		return false;
+	}
+
+	EmitJump(vecCode, pBlockAddr + vecCode.size(), pTargetAddr + nStolen);
+
+	std::vector<std::uint8_t> vecPatch;
+
+	if (!bNear)
+	{
+		EmitFarJump(vecPatch, pDetourAddr);
+	}
+	else if (FitsRel32(pTargetAddr + sm_nNearJumpSize, pDetourAddr))
+	{
+		EmitJump(vecPatch, pTargetAddr, pDetourAddr);
+	}
+	else
+	{
+		// The detour is out of reach: jump to a relay after the trampoline.
+		const std::uintptr_t pRelay = pBlockAddr + vecCode.size();
+
+		EmitFarJump(vecCode, pDetourAddr);
+		EmitJump(vecPatch, pTargetAddr, pRelay);
+	}
+
+	assert(vecCode.size() <= block.m_nSize && vecPatch.size() == nPatchSize);
+
+	arena.Write(block, vecCode.data(), vecCode.size());
+
+	m_pTarget = pTarget;
+	m_pTrampoline = block.m_pCode;
+	m_block = block;
+	m_nPatchSize = nPatchSize;
+
+	std::memcpy(m_aPatch.data(), vecPatch.data(), nPatchSize);
+	std::memcpy(m_aOriginal.data(), pTarget.RCast<const void*>(), nPatchSize);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Frees the trampoline
+// Input  : bWait - wait for a grace period (retire otherwise)
+//-----------------------------------------------------------------------------
+void CDetour::Release(bool bWait)
+{
+	if (!m_block.IsValid())
+		return;
+
+	const CodeBlock_t block = m_block;
+
+	if (!m_bKeepTrampoline) // Otherwise left to the threads which may still run it.
+	{
+		if (bWait && CEpoch::Synchronize())
+			CCodeArena::Get().Free(block);
+		else
+			CEpoch::Retire([block]() { CCodeArena::Get().Free(block); });
+	}
+
+	m_pTarget = nullptr;
+	m_pTrampoline = nullptr;
+	m_block = CodeBlock_t {};
+	m_nPatchSize = 0;
+}
+
+CDetour::~CDetour()
+{
+	if (m_bHooked)
+		Unhook();
+	else
+		Release(false);
+}
+
+bool CDetour::Hook(CMemory pTarget, void* pDetour)
+{
+	assert(!IsHooked());
+
+	if (!Prepare(pTarget, pDetour))
+		return false;
+
+	Apply();
+
+	return true;
+}
+
+void CDetour::Apply()
+{
+	std::vector<CodePatch_t> vecPatches {GetHookPatch()};
+
+	WriteCodeUnprotected(vecPatches);
+	m_bHooked = true;
+}
+
+bool CDetour::Unhook(bool bWait)
+{
+	if (!IsHooked())
+		return false;
+
+	std::vector<CodePatch_t> vecPatches {GetUnhookPatch()};
+
+	WriteCodeUnprotected(vecPatches);
+	m_bHooked = false;
+
+	Release(bWait);
+
+	return true;
+}
+
+bool CDetourTransaction::Hook(CDetour& detour, CMemory pTarget, void* pDetour)
+{
+	assert(!detour.IsHooked());
+
+	if (!detour.Prepare(pTarget, pDetour))
+		return false;
+
+	m_vecHooks.push_back(&detour);
+
+	return true;
+}
+
+void CDetourTransaction::Unhook(CDetour& detour)
+{
+	if (detour.IsHooked())
+		m_vecUnhooks.push_back(&detour);
+}
+
+std::size_t CDetourTransaction::Commit(bool bWait)
+{
+	std::vector<CodePatch_t> vecPatches;
+
+	vecPatches.reserve(m_vecHooks.size() + m_vecUnhooks.size());
+
+	for (const CDetour* pDetour : m_vecHooks)
+		vecPatches.push_back(pDetour->GetHookPatch());
+
+	for (const CDetour* pDetour : m_vecUnhooks)
+		vecPatches.push_back(pDetour->GetUnhookPatch());
+
+	WriteCodeUnprotected(vecPatches);
+
+	for (CDetour* pDetour : m_vecHooks)
+		pDetour->m_bHooked = true;
+
+	for (CDetour* pDetour : m_vecUnhooks)
+		pDetour->m_bHooked = false;
+
+	for (CDetour* pDetour : m_vecUnhooks)
+		pDetour->Release(false);
+
+	if (bWait && !m_vecUnhooks.empty())
+		CEpoch::Synchronize(); // One grace period for all of them, which also frees the retired trampolines.
+
+	const std::size_t nCount = vecPatches.size();
+
+	m_vecHooks.clear();
+	m_vecUnhooks.clear();
+
+	return nCount;
+}
+
+void CDetourTransaction::Abort()
+{
+	for (CDetour* pDetour : m_vecHooks)
+		pDetour->Release(false);
+
+	m_vecHooks.clear();
+	m_vecUnhooks.clear();
+}
+
+static_assert(offsetof(RegisterContext_t, m_nRax) == 256 && offsetof(RegisterContext_t, m_nRflags) == 384, "The stub relies on the context layout");
+
+//-----------------------------------------------------------------------------
+// Purpose: Emits the context save and restore around a callback call
+// Input  : vecCode
+//          pInvoke - void (RegisterContext_t*, void* pUser)
+//          pUser
+//          bSaveXmm
+//-----------------------------------------------------------------------------
+static void EmitContextCall(std::vector<std::uint8_t>& vecCode, std::uintptr_t pInvoke, std::uintptr_t pUser, bool bSaveXmm)
+{
+	// movdqu [rsp + n * 16], xmmN / movdqu xmmN, [rsp + n * 16]
+	auto funcXmm = [&vecCode](std::uint8_t nOpcode, std::uint8_t n)
+	{
+		const std::uint8_t nReg = n & 7;
+
+		vecCode.push_back(0xF3);
+
+		if (n >= 8)
+			vecCode.push_back(0x44); // REX.R
+
+		EmitBytes(vecCode, {0x0F, nOpcode, static_cast<std::uint8_t>(0x84 | (nReg << 3)), 0x24});
+		EmitValue(vecCode, static_cast<std::int32_t>(n * 16));
+	};
+
+	EmitBytes(vecCode, {0x48, 0x8D, 0x64, 0x24, 0x80}); // lea rsp, [rsp - 128] (the red zone)
+	EmitBytes(vecCode, {0x9C}); // pushfq
+	EmitBytes(vecCode, {0x41, 0x57, 0x41, 0x56, 0x41, 0x55, 0x41, 0x54, 0x41, 0x53, 0x41, 0x52, 0x41, 0x51, 0x41, 0x50}); // push r15 ... r8
+	EmitBytes(vecCode, {0x57, 0x56, 0x55}); // push rdi, rsi, rbp
+	EmitBytes(vecCode, {0x54, 0x48, 0x81, 0x04, 0x24, 0xE0, 0x00, 0x00, 0x00}); // push rsp; add qword [rsp], 224 (the RSP at the hook point)
+	EmitBytes(vecCode, {0x53, 0x52, 0x51, 0x50}); // push rbx, rdx, rcx, rax
+	EmitBytes(vecCode, {0x48, 0x81, 0xEC, 0x00, 0x01, 0x00, 0x00}); // sub rsp, 256
+
+	if (bSaveXmm)
+	{
+		for (std::uint8_t n = 0; n < 16; ++n)
+			funcXmm(0x7F, n);
+	}
+
+	EmitBytes(vecCode, {0x48, 0x89, 0xE3}); // mov rbx, rsp
+	EmitBytes(vecCode, {0x48, 0x83, 0xE4, 0xF0}); // and rsp, -16
+	EmitBytes(vecCode, {0x48, 0x83, 0xEC, 0x20}); // sub rsp, 32 (Win64 home space)
+#ifdef _WIN32
+	EmitBytes(vecCode, {0x48, 0x89, 0xD9, 0x48, 0xBA}); // mov rcx, rbx; mov rdx, imm64
+#else
+	EmitBytes(vecCode, {0x48, 0x89, 0xDF, 0x48, 0xBE}); // mov rdi, rbx; mov rsi, imm64
+#endif
+	EmitValue(vecCode, static_cast<std::uint64_t>(pUser));
+	EmitBytes(vecCode, {0x48, 0xB8}); // mov rax, imm64
+	EmitValue(vecCode, static_cast<std::uint64_t>(pInvoke));
+	EmitBytes(vecCode, {0xFF, 0xD0}); // call rax
+	EmitBytes(vecCode, {0x48, 0x89, 0xDC}); // mov rsp, rbx
+
+	if (bSaveXmm)
+	{
+		for (std::uint8_t n = 0; n < 16; ++n)
+			funcXmm(0x6F, n);
+	}
+
+	EmitBytes(vecCode, {0x48, 0x81, 0xC4, 0x00, 0x01, 0x00, 0x00}); // add rsp, 256
+	EmitBytes(vecCode, {0x58, 0x59, 0x5A, 0x5B}); // pop rax, rcx, rdx, rbx
+	EmitBytes(vecCode, {0x48, 0x83, 0xC4, 0x08}); // add rsp, 8 (skip RSP)
+	EmitBytes(vecCode, {0x5D, 0x5E, 0x5F}); // pop rbp, rsi, rdi
+	EmitBytes(vecCode, {0x41, 0x58, 0x41, 0x59, 0x41, 0x5A, 0x41, 0x5B, 0x41, 0x5C, 0x41, 0x5D, 0x41, 0x5E, 0x41, 0x5F}); // pop r8 ... r15
+	EmitBytes(vecCode, {0x9D}); // popfq
+	EmitBytes(vecCode, {0x48, 0x8D, 0xA4, 0x24, 0x80, 0x00, 0x00, 0x00}); // lea rsp, [rsp + 128]
+}
+
+void CMidHook::Invoke(RegisterContext_t* pContext, const Slot_t* pSlot)
+{
+	CEpoch::CGuard guard;
+
+	const Callback_t* pFunc = pSlot->load(std::memory_order_acquire);
+
+	if (pFunc) // Unhooked while in the stub otherwise.
+		(*pFunc)(*pContext);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Hooks an instruction boundary
+// Input  : pAddress
+//          func - the callback
+//          bSaveXmm - save and restore XMM0-15 around the callback
+// Output : true on success
+//-----------------------------------------------------------------------------
+bool CMidHook::Hook(CMemory pAddress, Callback_t func, bool bSaveXmm)
+{
+	assert(!IsHooked());
+
+	constexpr std::size_t nStubSize = 512;
+
+	CCodeArena& arena = CCodeArena::Get();
+
+	CodeBlock_t stub = arena.Allocate(nStubSize, pAddress);
+
+	if (!stub.IsValid())
+		stub = arena.Allocate(nStubSize);
+
+	if (!stub.IsValid())
+		return false;
+
+	if (!Prepare(pAddress, stub.m_pCode))
+	{
+		arena.Free(stub);
+
+		return false;
+	}
+
+	m_bKeepTrampoline = true;
+
+	Detach(true); // Of a hook removed by a transaction.
+
+	auto* pSlot = new Slot_t(new Callback_t(std::move(func)));
+
+	std::vector<std::uint8_t> vecCode;
+
+	vecCode.reserve(nStubSize);
+
+	EmitContextCall(vecCode, reinterpret_cast<std::uintptr_t>(&Invoke), reinterpret_cast<std::uintptr_t>(pSlot), bSaveXmm);
+
+	const auto pStub = static_cast<std::uintptr_t>(stub.m_pCode.GetAddr());
+
+	EmitJump(vecCode, pStub + vecCode.size(), static_cast<std::uintptr_t>(GetTrampoline().GetAddr()));
+
+	assert(vecCode.size() <= nStubSize);
+
+	arena.Write(stub, vecCode.data(), vecCode.size());
+
+	m_pSlot = pSlot;
+	m_stub = stub;
+
+	Apply();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Empties the slot of the stub and frees the callback after a grace
+//          period. The stub and the slot are left to the threads which may
+//          still run it
+// Input  : bWait - wait for the grace period (retire otherwise)
+//-----------------------------------------------------------------------------
+void CMidHook::Detach(bool bWait)
+{
+	if (!m_pSlot)
+		return;
+
+	const Callback_t* pFunc = m_pSlot->exchange(nullptr, std::memory_order_acq_rel);
+
+	if (bWait)
+		CEpoch::Reclaim(pFunc);
+	else
+		CEpoch::Retire([pFunc]() { delete pFunc; });
+
+	m_pSlot = nullptr;
+	m_stub = CodeBlock_t {};
+}
+
+bool CMidHook::Unhook(bool bWait)
+{
+	if (!CDetour::Unhook(bWait))
+		return false;
+
+	Detach(bWait);
+
+	return true;
+}
+
+CMidHook::~CMidHook()
+{
+	Unhook();
+	Detach(true);
+}
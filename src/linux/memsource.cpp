@@ -0,0 +1,299 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/memsource.hpp>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace DynLibUtils;
+
+static constexpr std::size_t s_nMaxIovecs = 1024; // UIO_MAXIOV.
+
+// Parses a hex number, p is moved past it.
+static std::uintptr_t ParseHex(const char*& p, const char* pEnd) noexcept
+{
+	std::uintptr_t nValue = 0;
+
+	for (; p < pEnd; ++p)
+	{
+		const char c = *p;
+
+		if ('0' <= c && c <= '9')
+			nValue = (nValue << 4) | static_cast<std::uintptr_t>(c - '0');
+		else if ('a' <= c && c <= 'f')
+			nValue = (nValue << 4) | static_cast<std::uintptr_t>(c - 'a' + 10);
+		else
+			break;
+	}
+
+	return nValue;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads the regions of /proc/<pid>/maps
+// Input  : nPid
+//          funcRegion - called with each region and the path it maps (may be empty)
+// Output : false if the file can't be read
+//-----------------------------------------------------------------------------
+template<typename F>
+static bool ReadMaps(ProcessId_t nPid, const F& funcRegion)
+{
+	char szPath[32];
+
+	std::snprintf(szPath, sizeof(szPath), "/proc/%d/maps", nPid);
+
+	const int fd = open(szPath, O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+		return false;
+
+	std::string sMaps(64 * 1024, '\0');
+	std::size_t nLength = 0;
+
+	for (;;)
+	{
+		if (nLength == sMaps.size())
+			sMaps.resize(sMaps.size() * 2);
+
+		const ssize_t nRead = read(fd, &sMaps[nLength], sMaps.size() - nLength);
+
+		if (nRead < 0 && errno == EINTR)
+			continue;
+
+		if (nRead <= 0)
+			break;
+
+		nLength += static_cast<std::size_t>(nRead);
+	}
+
+	close(fd);
+
+	// "begin-end perms offset dev inode [path]"
+	const char* p = sMaps.data();
+	const char* pEnd = p + nLength;
+
+	while (p < pEnd)
+	{
+		const char* pLineEnd = static_cast<const char*>(std::memchr(p, '\n', pEnd - p));
+
+		if (!pLineEnd)
+			pLineEnd = pEnd;
+
+		const std::uintptr_t pBegin = ParseHex(p, pLineEnd);
+
+		if (p < pLineEnd && *p == '-')
+		{
+			++p;
+
+			const std::uintptr_t pRegionEnd = ParseHex(p, pLineEnd);
+
+			if (pLineEnd - p > 4 && *p == ' ')
+			{
+				std::uint8_t nFlags = 0;
+
+				if (p[1] == 'r')
+					nFlags |= Region_t::Readable;
+
+				if (p[2] == 'w')
+					nFlags |= Region_t::Writable;
+
+				if (p[3] == 'x')
+					nFlags |= Region_t::Executable;
+
+				// The path follows the 5 fields (and their padding).
+				std::string_view svPath;
+
+				const char* pPath = static_cast<const char*>(std::memchr(p, '/', pLineEnd - p));
+
+				if (pPath)
+					svPath = std::string_view(pPath, pLineEnd - pPath);
+
+				funcRegion(Region_t{pBegin, pRegionEnd, nFlags}, svPath);
+			}
+		}
+
+		p = pLineEnd + 1;
+	}
+
+	return true;
+}
+
+// Returns the number of the page-aligned pieces of a range.
+static std::size_t CountPieces(std::uintptr_t p, std::size_t nSize) noexcept
+{
+	return nSize ? (p + nSize - 1) / CMemorySource::sm_nPieceSize - p / CMemorySource::sm_nPieceSize + 1 : 0;
+}
+
+// Cuts a range into its page-aligned pieces. Returns their number.
+static std::size_t AddPieces(iovec* pRemote, std::uintptr_t p, std::size_t nSize) noexcept
+{
+	std::size_t nPieces = 0;
+
+	for (const std::uintptr_t pEnd = p + nSize; p < pEnd; )
+	{
+		const std::uintptr_t pNext = std::min((p & ~(CMemorySource::sm_nPieceSize - 1)) + CMemorySource::sm_nPieceSize, pEnd);
+
+		pRemote[nPieces++] = {reinterpret_cast<void*>(p), pNext - p};
+		p = pNext;
+	}
+
+	return nPieces;
+}
+
+ProcessId_t CMemorySource::GetCurrentPid() noexcept
+{
+	return getpid();
+}
+
+bool CMemorySource::Open()
+{
+	return m_bLocal || kill(m_nPid, 0) == 0;
+}
+
+void CMemorySource::Close() noexcept
+{
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads memory of another process with process_vm_readv
+// Input  : pAddress
+//          pBuffer
+//          nSize
+// Output : std::size_t (the number of bytes read, up to the first unreadable piece)
+//-----------------------------------------------------------------------------
+std::size_t CMemorySource::ReadRemote(std::uintptr_t pAddress, void* pBuffer, std::size_t nSize) const
+{
+	iovec aRemote[s_nMaxIovecs];
+
+	std::size_t nDone = 0;
+
+	while (nDone < nSize)
+	{
+		// The pieces are the iovecs: a read stops at the first one which fails, never within one.
+		const std::size_t nBatch = std::min(nSize - nDone, s_nMaxIovecs * sm_nPieceSize - ((pAddress + nDone) & (sm_nPieceSize - 1)));
+		const std::size_t nPieces = AddPieces(aRemote, pAddress + nDone, nBatch);
+
+		iovec local {static_cast<std::uint8_t*>(pBuffer) + nDone, nBatch};
+
+		const ssize_t nRead = process_vm_readv(m_nPid, &local, 1, aRemote, nPieces, 0);
+
+		if (nRead < 0 && errno == EINTR)
+			continue;
+
+		if (nRead <= 0)
+			break;
+
+		nDone += static_cast<std::size_t>(nRead);
+
+		if (static_cast<std::size_t>(nRead) < nBatch)
+			break;
+	}
+
+	return nDone;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads many ranges of another process, batching their pieces in
+//          the iovecs of process_vm_readv
+// Input  : pRequests
+//          nCount
+// Output : std::size_t (the number of fully read ranges)
+//-----------------------------------------------------------------------------
+std::size_t CMemorySource::ReadBatchRemote(ReadRequest_t* pRequests, std::size_t nCount) const
+{
+	iovec aLocal[s_nMaxIovecs], aRemote[s_nMaxIovecs];
+
+	std::size_t nFull = 0;
+
+	for (std::size_t n = 0; n < nCount; )
+	{
+		if (CountPieces(pRequests[n].m_pAddress, pRequests[n].m_nSize) > s_nMaxIovecs)
+		{
+			ReadRequest_t& request = pRequests[n++];
+
+			request.m_nRead = ReadRemote(request.m_pAddress, request.m_pBuffer, request.m_nSize);
+			nFull += request.m_nRead == request.m_nSize;
+
+			continue;
+		}
+
+		std::size_t nLast = n, nLocal = 0, nRemote = 0;
+
+		for (; nLast < nCount && nLocal < s_nMaxIovecs; ++nLast)
+		{
+			const ReadRequest_t& request = pRequests[nLast];
+
+			if (nRemote + CountPieces(request.m_pAddress, request.m_nSize) > s_nMaxIovecs)
+				break;
+
+			aLocal[nLocal++] = {request.m_pBuffer, request.m_nSize};
+			nRemote += AddPieces(aRemote + nRemote, request.m_pAddress, request.m_nSize);
+		}
+
+		ssize_t nRead = process_vm_readv(m_nPid, aLocal, nLocal, aRemote, nRemote, 0);
+
+		if (nRead < 0 && errno == EINTR)
+			continue;
+
+		// The bytes read are the ones of the requests in order, up to the first unreadable piece.
+		auto nLeft = static_cast<std::size_t>(std::max<ssize_t>(nRead, 0));
+
+		for (; n < nLast; ++n)
+		{
+			ReadRequest_t& request = pRequests[n];
+
+			request.m_nRead = std::min(nLeft, request.m_nSize);
+			nLeft -= request.m_nRead;
+
+			if (request.m_nRead < request.m_nSize)
+			{
+				++n; // The next batch starts after it.
+
+				break;
+			}
+
+			++nFull;
+		}
+	}
+
+	return nFull;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the regions of /proc/<pid>/maps
+// Input  : vecRegions - receives them, sorted by address
+// Output : false if they can't be read
+//-----------------------------------------------------------------------------
+bool CMemorySource::GetRegions(std::vector<Region_t>& vecRegions) const
+{
+	return ReadMaps(m_nPid, [&](const Region_t& region, std::string_view) { vecRegions.push_back(region); });
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the regions of /proc/<pid>/maps which map a module
+// Input  : svModuleName - the file name or the path
+//          vecRegions - receives them, sorted by address
+// Output : false if the module is not mapped
+//-----------------------------------------------------------------------------
+bool CMemorySource::GetModuleRegions(const std::string_view svModuleName, std::vector<Region_t>& vecRegions) const
+{
+	const std::size_t nPrevious = vecRegions.size();
+
+	ReadMaps(m_nPid, [&](const Region_t& region, std::string_view svPath)
+	{
+		if (svPath.empty())
+			return;
+
+		if (svPath == svModuleName || svPath.substr(svPath.find_last_of('/') + 1) == svModuleName)
+			vecRegions.push_back(region);
+	});
+
+	return vecRegions.size() > nPrevious;
+}
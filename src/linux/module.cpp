@@ -5,7 +5,9 @@
 #include <dynlibutils/module.hpp>
 #include <dynlibutils/memaddr.hpp>
 
+#include <algorithm>
 #include <cstring>
+#include <dlfcn.h>
 #include <link.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -14,6 +16,268 @@
 
 using namespace DynLibUtils;
 
+// DWARF pointer encodings (DW_EH_PE_*) of the unwind tables.
+enum : std::uint8_t
+{
+	DW_EH_PE_absptr  = 0x00,
+	DW_EH_PE_uleb128 = 0x01,
+	DW_EH_PE_udata2  = 0x02,
+	DW_EH_PE_udata4  = 0x03,
+	DW_EH_PE_udata8  = 0x04,
+	DW_EH_PE_sleb128 = 0x09,
+	DW_EH_PE_sdata2  = 0x0A,
+	DW_EH_PE_sdata4  = 0x0B,
+	DW_EH_PE_sdata8  = 0x0C,
+
+	DW_EH_PE_pcrel   = 0x10,
+	DW_EH_PE_datarel = 0x30,
+	DW_EH_PE_omit    = 0xFF,
+};
+
+static std::uint64_t ReadULEB128(const std::uint8_t*& p)
+{
+	std::uint64_t nValue = 0;
+
+	for (unsigned int nShift = 0; ; nShift += 7)
+	{
+		const std::uint8_t nByte = *p++;
+
+		nValue |= static_cast<std::uint64_t>(nByte & 0x7F) << nShift;
+
+		if (!(nByte & 0x80))
+			return nValue;
+	}
+}
+
+static std::int64_t ReadSLEB128(const std::uint8_t*& p)
+{
+	std::uint64_t nValue = 0;
+	unsigned int nShift = 0;
+	std::uint8_t nByte;
+
+	do
+	{
+		nByte = *p++;
+		nValue |= static_cast<std::uint64_t>(nByte & 0x7F) << nShift;
+		nShift += 7;
+	}
+	while (nByte & 0x80);
+
+	if (nShift < 64 && (nByte & 0x40))
+		nValue |= ~std::uint64_t(0) << nShift;
+
+	return static_cast<std::int64_t>(nValue);
+}
+
+template<typename T>
+static T ReadValue(const std::uint8_t*& p)
+{
+	T value;
+
+	std::memcpy(&value, p, sizeof(T));
+	p += sizeof(T);
+
+	return value;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads a DWARF encoded pointer
+// Input  : p - the pointer, advanced past it
+//          nEncoding - DW_EH_PE_*
+//          pDataRel - base of DW_EH_PE_datarel
+// Output : std::uintptr_t
+//-----------------------------------------------------------------------------
+static std::uintptr_t ReadEncodedPointer(const std::uint8_t*& p, const std::uint8_t nEncoding, const std::uintptr_t pDataRel = 0)
+{
+	const auto pField = reinterpret_cast<std::uintptr_t>(p);
+
+	std::uintptr_t nValue;
+
+	switch (nEncoding & 0x0F)
+	{
+		case DW_EH_PE_absptr:  nValue = ReadValue<std::uintptr_t>(p); break;
+		case DW_EH_PE_uleb128: nValue = static_cast<std::uintptr_t>(ReadULEB128(p)); break;
+		case DW_EH_PE_udata2:  nValue = ReadValue<std::uint16_t>(p); break;
+		case DW_EH_PE_udata4:  nValue = ReadValue<std::uint32_t>(p); break;
+		case DW_EH_PE_udata8:  nValue = static_cast<std::uintptr_t>(ReadValue<std::uint64_t>(p)); break;
+		case DW_EH_PE_sleb128: nValue = static_cast<std::uintptr_t>(ReadSLEB128(p)); break;
+		case DW_EH_PE_sdata2:  nValue = static_cast<std::uintptr_t>(ReadValue<std::int16_t>(p)); break;
+		case DW_EH_PE_sdata4:  nValue = static_cast<std::uintptr_t>(ReadValue<std::int32_t>(p)); break;
+		case DW_EH_PE_sdata8:  nValue = static_cast<std::uintptr_t>(ReadValue<std::int64_t>(p)); break;
+		default:               return 0;
+	}
+
+	switch (nEncoding & 0x70)
+	{
+		case DW_EH_PE_pcrel:   nValue += pField; break;
+		case DW_EH_PE_datarel: nValue += pDataRel; break;
+	}
+
+	return nValue;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads the FDE pointer encoding of a CIE (the 'R' augmentation)
+// Input  : pCIE - the CIE (at its length field)
+// Output : std::uint8_t (DW_EH_PE_*)
+//-----------------------------------------------------------------------------
+static std::uint8_t ReadFDEEncoding(const std::uint8_t* pCIE)
+{
+	const std::uint8_t* p = pCIE + sizeof(std::uint32_t);
+
+	if (ReadValue<std::uint32_t>(pCIE) == 0xFFFFFFFF)
+		p += sizeof(std::uint64_t); // 64-bit DWARF.
+
+	p += sizeof(std::uint32_t); // CIE id.
+
+	const std::uint8_t nVersion = *p++;
+	const auto* pszAugmentation = reinterpret_cast<const char*>(p);
+
+	p += std::strlen(pszAugmentation) + 1;
+
+	if (*pszAugmentation != 'z')
+		return DW_EH_PE_absptr;
+
+	ReadULEB128(p); // Code alignment factor.
+	ReadSLEB128(p); // Data alignment factor.
+
+	if (nVersion == 1)
+		p++; // Return address register.
+	else
+		ReadULEB128(p);
+
+	ReadULEB128(p); // Augmentation data length.
+
+	for (const char* pszChar = pszAugmentation + 1; *pszChar; ++pszChar)
+	{
+		switch (*pszChar)
+		{
+			case 'R':
+				return *p;
+
+			case 'L':
+				p++;
+				break;
+
+			case 'P':
+			{
+				const std::uint8_t nEncoding = *p++;
+
+				ReadEncodedPointer(p, nEncoding & 0x0F); // The personality routine.
+				break;
+			}
+
+			default:
+				return DW_EH_PE_absptr; // 'S', 'B' and unknown ones carry no data up to 'R' in practice.
+		}
+	}
+
+	return DW_EH_PE_absptr;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads the range of a FDE
+// Input  : pFDE - the FDE (at its length field)
+//          range - receives [begin, end)
+// Output : bool (false for a CIE or a terminator)
+//-----------------------------------------------------------------------------
+static bool ReadFDERange(const std::uint8_t* pFDE, std::pair<std::uintptr_t, std::uintptr_t>& range)
+{
+	const std::uint8_t* p = pFDE;
+
+	std::uint64_t nLength = ReadValue<std::uint32_t>(p);
+
+	if (nLength == 0xFFFFFFFF)
+		nLength = ReadValue<std::uint64_t>(p);
+
+	if (!nLength)
+		return false;
+
+	const std::uint8_t* pCIEPointer = p;
+	const std::uint32_t nCIEOffset = ReadValue<std::uint32_t>(p);
+
+	if (!nCIEOffset)
+		return false; // A CIE.
+
+	const std::uint8_t nEncoding = ReadFDEEncoding(pCIEPointer - nCIEOffset);
+
+	range.first = ReadEncodedPointer(p, nEncoding);
+	range.second = range.first + ReadEncodedPointer(p, nEncoding & 0x0F); // The size is never relative.
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Collects the function ranges of the unwind tables: the sorted table
+//          of .eh_frame_hdr, or a walk of .eh_frame without one
+// Input  : pEhFrameHdr
+//          pEhFrame
+//          base - the module base
+//          vecFunctions
+//-----------------------------------------------------------------------------
+static void CollectFunctionRanges(const Section_t* pEhFrameHdr, const Section_t* pEhFrame, const std::uintptr_t base, std::vector<FunctionRange_t>& vecFunctions)
+{
+	std::pair<std::uintptr_t, std::uintptr_t> range;
+
+	auto funcAdd = [&]()
+	{
+		if (base <= range.first && range.first < range.second && range.second - base <= UINT32_MAX)
+			vecFunctions.push_back({static_cast<std::uint32_t>(range.first - base), static_cast<std::uint32_t>(range.second - base)});
+	};
+
+	constexpr std::uint8_t kTableEncoding = DW_EH_PE_datarel | DW_EH_PE_sdata4; // The only one linkers emit.
+
+	if (pEhFrameHdr && pEhFrameHdr->m_nSectionSize >= 4 && pEhFrameHdr->RCast<const std::uint8_t*>()[0] == 1 && pEhFrameHdr->RCast<const std::uint8_t*>()[3] == kTableEncoding)
+	{
+		const auto* pHeader = pEhFrameHdr->RCast<const std::uint8_t*>();
+		const auto pDataRel = reinterpret_cast<std::uintptr_t>(pHeader);
+		const std::uint8_t* p = pHeader + 4;
+
+		ReadEncodedPointer(p, pHeader[1], pDataRel); // .eh_frame
+
+		const std::uintptr_t nCount = ReadEncodedPointer(p, pHeader[2], pDataRel);
+
+		vecFunctions.reserve(nCount);
+
+		for (std::uintptr_t n = 0; n < nCount; ++n)
+		{
+			ReadValue<std::int32_t>(p); // Initial location (the FDE has it as well).
+
+			const std::uintptr_t pFDE = pDataRel + static_cast<std::intptr_t>(ReadValue<std::int32_t>(p));
+
+			if (ReadFDERange(reinterpret_cast<const std::uint8_t*>(pFDE), range))
+				funcAdd();
+		}
+	}
+	else if (pEhFrame)
+	{
+		const auto* p = pEhFrame->RCast<const std::uint8_t*>();
+		const auto* pEnd = p + pEhFrame->m_nSectionSize;
+
+		while (p + sizeof(std::uint32_t) <= pEnd)
+		{
+			std::uint64_t nLength = ReadValue<std::uint32_t>(p);
+			std::size_t nHeaderSize = sizeof(std::uint32_t);
+
+			if (!nLength)
+				break; // Terminator.
+
+			if (nLength == 0xFFFFFFFF)
+			{
+				nLength = ReadValue<std::uint64_t>(p);
+				nHeaderSize += sizeof(std::uint64_t);
+			}
+
+			if (ReadFDERange(p - nHeaderSize, range))
+				funcAdd();
+
+			p += nLength;
+		}
+
+		std::sort(vecFunctions.begin(), vecFunctions.end(), [](const FunctionRange_t& left, const FunctionRange_t& right) { return left.m_nBegin < right.m_nBegin; });
+	}
+}
+
 CModule::~CModule()
 {
 	if (IsValid())
@@ -132,7 +396,15 @@ bool CModule::LoadFromPath(const std::string_view svModelePath, int flags)
 				if (*(strTab + shdr->sh_name) == '\0')
 					continue;
 
-				m_vecSections.emplace_back(static_cast<std::uintptr_t>(lmap->l_addr + shdr->sh_addr), shdr->sh_size, strTab + shdr->sh_name);
+				std::uint8_t nFlags = (shdr->sh_flags & SHF_ALLOC) ? Section_t::Readable : 0; // Non-allocated sections (.symtab, .comment, ...) are not mapped.
+
+				if (shdr->sh_flags & SHF_WRITE)
+					nFlags |= Section_t::Writable;
+
+				if (shdr->sh_flags & SHF_EXECINSTR)
+					nFlags |= Section_t::Executable;
+
+				m_vecSections.emplace_back(static_cast<std::uintptr_t>(lmap->l_addr + shdr->sh_addr), shdr->sh_size, strTab + shdr->sh_name, nFlags);
 			}
 
 			munmap(map, st.st_size);
@@ -147,6 +419,8 @@ bool CModule::LoadFromPath(const std::string_view svModelePath, int flags)
 	m_pExecutableSection = GetSectionByName(".text");
 	assert(m_pExecutableSection != nullptr);
 
+	CollectFunctionRanges(GetSectionByName(".eh_frame_hdr"), GetSectionByName(".eh_frame"), lmap->l_addr, m_vecFunctions);
+
 	return true;
 }
 
@@ -213,6 +487,171 @@ CMemory CModule::GetFunctionByName(const std::string_view svFunctionName) const
 	return CMemory((IsValid() && !svFunctionName.empty()) ? dlsym(GetPtr(), svFunctionName.data()) : nullptr);
 }
 
+//-----------------------------------------------------------------------------
+// Purpose: Collects the GOT slots of a loaded object from its dynamic relocations
+//          (DT_JMPREL for PLT calls, DT_RELA for GOT loads of -fno-plt code)
+// Input  : pInfo - the object
+//          svSymbolName - symbol to filter by (all if empty)
+//          vecImports
+//-----------------------------------------------------------------------------
+static void CollectImports(const dl_phdr_info* pInfo, const std::string_view svSymbolName, std::vector<Import_t>& vecImports)
+{
+	const ElfW(Addr) base = pInfo->dlpi_addr;
+
+	const ElfW(Dyn)* pDynamic = nullptr;
+	ElfW(Addr) relroBegin = 0, relroEnd = 0;
+	ElfW(Addr) codeBegin = ~ElfW(Addr)(0), codeEnd = 0;
+
+	for (ElfW(Half) n = 0; n < pInfo->dlpi_phnum; ++n)
+	{
+		const ElfW(Phdr)& phdr = pInfo->dlpi_phdr[n];
+
+		if (phdr.p_type == PT_DYNAMIC)
+		{
+			pDynamic = reinterpret_cast<const ElfW(Dyn)*>(base + phdr.p_vaddr);
+		}
+		else if (phdr.p_type == PT_GNU_RELRO)
+		{
+			relroBegin = base + phdr.p_vaddr;
+			relroEnd = relroBegin + phdr.p_memsz;
+		}
+		else if (phdr.p_type == PT_LOAD && (phdr.p_flags & PF_X))
+		{
+			codeBegin = std::min(codeBegin, base + phdr.p_vaddr);
+			codeEnd = std::max(codeEnd, base + phdr.p_vaddr + phdr.p_memsz);
+		}
+	}
+
+	if (!pDynamic)
+		return;
+
+	// glibc relocates the pointers of the dynamic section in place, other loaders do not.
+	auto funcPtr = [base](ElfW(Addr) ptr) { return ptr < base ? ptr + base : ptr; };
+
+	const ElfW(Sym)* pSymbols = nullptr;
+	const char* pszStrings = nullptr;
+	const ElfW(Rela)* pPltRelocs = nullptr;
+	const ElfW(Rela)* pRelocs = nullptr;
+	std::size_t nPltRelocsSize = 0, nRelocsSize = 0;
+	ElfW(Sxword) nPltRelocType = DT_RELA;
+
+	for (const ElfW(Dyn)* pDyn = pDynamic; pDyn->d_tag != DT_NULL; ++pDyn)
+	{
+		switch (pDyn->d_tag)
+		{
+			case DT_SYMTAB:   pSymbols = reinterpret_cast<const ElfW(Sym)*>(funcPtr(pDyn->d_un.d_ptr)); break;
+			case DT_STRTAB:   pszStrings = reinterpret_cast<const char*>(funcPtr(pDyn->d_un.d_ptr)); break;
+			case DT_JMPREL:   pPltRelocs = reinterpret_cast<const ElfW(Rela)*>(funcPtr(pDyn->d_un.d_ptr)); break;
+			case DT_PLTRELSZ: nPltRelocsSize = pDyn->d_un.d_val; break;
+			case DT_PLTREL:   nPltRelocType = static_cast<ElfW(Sxword)>(pDyn->d_un.d_val); break;
+			case DT_RELA:     pRelocs = reinterpret_cast<const ElfW(Rela)*>(funcPtr(pDyn->d_un.d_ptr)); break;
+			case DT_RELASZ:   nRelocsSize = pDyn->d_un.d_val; break;
+		}
+	}
+
+	if (!pSymbols || !pszStrings || nPltRelocType != DT_RELA)
+		return;
+
+	for (const auto& [pTable, nSize] : {std::make_pair(pPltRelocs, nPltRelocsSize), std::make_pair(pRelocs, nRelocsSize)})
+	{
+		if (!pTable)
+			continue;
+
+		for (std::size_t n = 0; n < nSize / sizeof(ElfW(Rela)); ++n)
+		{
+			const ElfW(Rela)& rela = pTable[n];
+			const auto nType = ELF64_R_TYPE(rela.r_info);
+			const auto nSymbol = ELF64_R_SYM(rela.r_info);
+
+			if ((nType != R_X86_64_JUMP_SLOT && nType != R_X86_64_GLOB_DAT) || !nSymbol)
+				continue;
+
+			const std::string_view svName(pszStrings + pSymbols[nSymbol].st_name);
+
+			if (!svSymbolName.empty() && svName != svSymbolName)
+				continue;
+
+			const ElfW(Addr) slot = base + rela.r_offset;
+			const auto target = *reinterpret_cast<const ElfW(Addr)*>(slot);
+
+			Import_t& entry = vecImports.emplace_back();
+
+			entry.m_svName = svName;
+			entry.m_pSlot = slot;
+			entry.m_pTarget = target;
+			entry.m_bWritable = slot < relroBegin || slot >= relroEnd;
+
+			// A lazy slot still points back into the PLT of the object.
+			if (nType == R_X86_64_JUMP_SLOT && codeBegin <= target && target < codeEnd)
+				entry.m_pTarget = dlsym(RTLD_DEFAULT, entry.m_svName.data());
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the imports of the module
+// Input  : svSymbolName - symbol to filter by (all if empty)
+// Output : std::vector<Import_t>
+//-----------------------------------------------------------------------------
+std::vector<Import_t> CModule::GetImports(const std::string_view svSymbolName) const
+{
+	struct Data_t
+	{
+		const void* pDynamic;
+		std::string_view svSymbolName;
+		std::vector<Import_t> vecImports;
+	} data { IsValid() ? RCast<link_map*>()->l_ld : nullptr, svSymbolName, {} };
+
+	if (!data.pDynamic)
+		return {};
+
+	dl_iterate_phdr([](dl_phdr_info* info, std::size_t /* size */, void* pData)
+	{
+		auto* pData_ = static_cast<Data_t*>(pData);
+
+		for (ElfW(Half) n = 0; n < info->dlpi_phnum; ++n)
+		{
+			const ElfW(Phdr)& phdr = info->dlpi_phdr[n];
+
+			if (phdr.p_type == PT_DYNAMIC && reinterpret_cast<const void*>(info->dlpi_addr + phdr.p_vaddr) == pData_->pDynamic)
+			{
+				CollectImports(info, pData_->svSymbolName, pData_->vecImports);
+
+				return 1;
+			}
+		}
+
+		return 0;
+	}, &data);
+
+	return std::move(data.vecImports);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the imports of a symbol by every loaded module
+// Input  : svSymbolName
+// Output : std::vector<Import_t>
+//-----------------------------------------------------------------------------
+std::vector<Import_t> CModule::GetLoadedImports(const std::string_view svSymbolName)
+{
+	struct Data_t
+	{
+		std::string_view svSymbolName;
+		std::vector<Import_t> vecImports;
+	} data { svSymbolName, {} };
+
+	dl_iterate_phdr([](dl_phdr_info* info, std::size_t /* size */, void* pData)
+	{
+		auto* pData_ = static_cast<Data_t*>(pData);
+
+		CollectImports(info, pData_->svSymbolName, pData_->vecImports);
+
+		return 0;
+	}, &data);
+
+	return std::move(data.vecImports);
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: Returns the module base
 //-----------------------------------------------------------------------------
@@ -223,5 +662,6 @@ CMemory CModule::GetBase() const noexcept
 
 void CModule::SaveLastError()
 {
-	m_sLastError = dlerror();
+	const char* pszError = dlerror(); // May be null (e.g. RTLD_NOLOAD of a module that is not loaded).
+	m_sLastError = pszError ? pszError : "";
 }
\ No newline at end of file
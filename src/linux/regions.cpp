@@ -0,0 +1,192 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/regions.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <link.h>
+#include <string>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace DynLibUtils;
+
+// Parses a hex number, p is moved past it.
+static std::uintptr_t ParseHex(const char*& p, const char* pEnd) noexcept
+{
+	std::uintptr_t nValue = 0;
+
+	for (; p < pEnd; ++p)
+	{
+		const char c = *p;
+
+		if ('0' <= c && c <= '9')
+			nValue = (nValue << 4) | static_cast<std::uintptr_t>(c - '0');
+		else if ('a' <= c && c <= 'f')
+			nValue = (nValue << 4) | static_cast<std::uintptr_t>(c - 'a' + 10);
+		else
+			break;
+	}
+
+	return nValue;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads the regions of /proc/self/maps
+// Input  : vecRegions - receives them, sorted by address
+// Output : false if the file can't be read
+//-----------------------------------------------------------------------------
+bool CRegionMap::Collect(std::vector<Region_t>& vecRegions)
+{
+	const int fd = open("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+		return false;
+
+	// The file is generated while reading, so it has no size: read it whole, then parse.
+	std::string sMaps(64 * 1024, '\0');
+	std::size_t nLength = 0;
+
+	for (;;)
+	{
+		if (nLength == sMaps.size())
+			sMaps.resize(sMaps.size() * 2);
+
+		const ssize_t nRead = read(fd, &sMaps[nLength], sMaps.size() - nLength);
+
+		if (nRead < 0 && errno == EINTR)
+			continue;
+
+		if (nRead <= 0)
+			break;
+
+		nLength += static_cast<std::size_t>(nRead);
+	}
+
+	close(fd);
+
+	// "begin-end perms offset dev inode [path]"
+	const char* p = sMaps.data();
+	const char* pEnd = p + nLength;
+
+	while (p < pEnd)
+	{
+		const char* pLineEnd = static_cast<const char*>(std::memchr(p, '\n', pEnd - p));
+
+		if (!pLineEnd)
+			pLineEnd = pEnd;
+
+		const std::uintptr_t pBegin = ParseHex(p, pLineEnd);
+
+		if (p < pLineEnd && *p == '-')
+		{
+			++p;
+
+			const std::uintptr_t pRegionEnd = ParseHex(p, pLineEnd);
+
+			if (pLineEnd - p > 4 && *p == ' ')
+			{
+				std::uint8_t nFlags = 0;
+
+				if (p[1] == 'r')
+					nFlags |= Region_t::Readable;
+
+				if (p[2] == 'w')
+					nFlags |= Region_t::Writable;
+
+				if (p[3] == 'x')
+					nFlags |= Region_t::Executable;
+
+				vecRegions.push_back({pBegin, pRegionEnd, nFlags});
+			}
+		}
+
+		p = pLineEnd + 1;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the number of module loads and unloads
+// Output : std::uint64_t
+//-----------------------------------------------------------------------------
+std::uint64_t CRegionMap::GetModuleGeneration()
+{
+	std::uint64_t nGeneration = 0;
+
+	dl_iterate_phdr([](dl_phdr_info* info, std::size_t size, void* pData)
+	{
+		if (size >= offsetof(dl_phdr_info, dlpi_subs) + sizeof(info->dlpi_subs))
+			*static_cast<std::uint64_t*>(pData) = info->dlpi_adds + info->dlpi_subs;
+
+		return 1; // The counters are the same for every module.
+	}, &nGeneration);
+
+	return nGeneration;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks the readability of a range with process_vm_readv, which reads
+//          a byte of each page and stops at the first unreadable one (the other
+//          access is only known from /proc/self/maps)
+// Input  : pAddress
+//          nSize
+//          nFlags
+//          bAccess - receives the result
+// Output : false if it can't tell
+//-----------------------------------------------------------------------------
+bool CRegionMap::Probe(std::uintptr_t pAddress, std::size_t nSize, std::uint8_t nFlags, bool& bAccess)
+{
+	if (nFlags != Region_t::Readable)
+		return false;
+
+	static const pid_t s_nPid = getpid();
+	static const auto s_nPageSize = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+
+	const std::uintptr_t pEnd = pAddress + (nSize ? nSize : 1);
+
+	if (pEnd < pAddress)
+	{
+		bAccess = false;
+
+		return true;
+	}
+
+	constexpr std::size_t kMaxPages = 64; // Per call.
+
+	std::uint8_t aBytes[kMaxPages];
+	iovec aRemote[kMaxPages];
+
+	for (std::uintptr_t p = pAddress; p < pEnd; )
+	{
+		std::size_t nPages = 0;
+
+		for (; nPages < kMaxPages && p < pEnd; ++nPages)
+		{
+			aRemote[nPages] = {reinterpret_cast<void*>(p), 1};
+			p = (p & ~(s_nPageSize - 1)) + s_nPageSize;
+		}
+
+		iovec local = {aBytes, nPages};
+
+		const ssize_t nRead = process_vm_readv(s_nPid, &local, 1, aRemote, nPages, 0);
+
+		if (nRead < 0 && errno != EFAULT)
+			return false; // Not permitted (seccomp) or not implemented.
+
+		if (nRead != static_cast<ssize_t>(nPages))
+		{
+			bAccess = false;
+
+			return true;
+		}
+	}
+
+	bAccess = true;
+
+	return true;
+}
@@ -0,0 +1,153 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/snapshot.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace DynLibUtils;
+
+static constexpr std::uint64_t s_nSoftDirtyBit = static_cast<std::uint64_t>(1) << 55; // Of a pagemap entry.
+static constexpr std::size_t s_nPagemapBatch = 4096; // Entries read at a time.
+
+static std::uintptr_t GetPageSize() noexcept
+{
+	static const auto s_nPageSize = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+
+	return s_nPageSize;
+}
+
+// The pagemap of the process, kept open.
+static int GetPagemap() noexcept
+{
+	static const int s_fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+
+	return s_fd;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads the pagemap entries of some pages
+// Input  : nFirstPage
+//          nPages
+//          pEntries
+// Output : false on a read error
+//-----------------------------------------------------------------------------
+static bool ReadPagemap(std::uintptr_t nFirstPage, std::size_t nPages, std::uint64_t* pEntries) noexcept
+{
+	const std::size_t nSize = nPages * sizeof(std::uint64_t);
+
+	for (std::size_t nRead = 0; nRead < nSize; )
+	{
+		const ssize_t n = pread(GetPagemap(), reinterpret_cast<char*>(pEntries) + nRead, nSize - nRead, static_cast<off_t>(nFirstPage * sizeof(std::uint64_t) + nRead));
+
+		if (n < 0 && errno == EINTR)
+			continue;
+
+		if (n <= 0)
+			return false;
+
+		nRead += static_cast<std::size_t>(n);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Clears the soft-dirty bits of every page of the process
+// Output : false if /proc/self/clear_refs can't be written
+//-----------------------------------------------------------------------------
+bool CMemorySnapshot::ClearSoftDirty()
+{
+	const int fd = open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC);
+
+	if (fd < 0)
+		return false;
+
+	ssize_t n;
+
+	do
+	{
+		n = write(fd, "4", 1);
+	}
+	while (n < 0 && errno == EINTR);
+
+	close(fd);
+
+	return n == 1;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks that the kernel tracks the soft-dirty bits (CONFIG_MEM_SOFT_DIRTY):
+//          a page written after a clear must read dirty
+// Output : bool
+//-----------------------------------------------------------------------------
+bool CMemorySnapshot::IsSoftDirtySupported()
+{
+	static const bool s_bSupported = []()
+	{
+		if (GetPagemap() < 0 || !ClearSoftDirty())
+			return false;
+
+		const std::uintptr_t nPageSize = GetPageSize();
+
+		void* pPage = mmap(nullptr, nPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (pPage == MAP_FAILED)
+			return false;
+
+		*static_cast<volatile std::uint8_t*>(pPage) = 1;
+
+		std::uint64_t nEntry;
+
+		const bool bDirty = ReadPagemap(reinterpret_cast<std::uintptr_t>(pPage) / nPageSize, 1, &nEntry) && (nEntry & s_nSoftDirtyBit);
+
+		munmap(pPage, nPageSize);
+
+		return bDirty;
+	}();
+
+	return s_bSupported;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Collects the spans of the dirty pages of a range
+// Input  : pBegin
+//          pEnd
+//          vecSpans - receives them clipped to the range, merged, sorted
+// Output : false if the pagemap can't be read
+//-----------------------------------------------------------------------------
+bool CMemorySnapshot::CollectDirtySpans(std::uintptr_t pBegin, std::uintptr_t pEnd, std::vector<Span_t>& vecSpans)
+{
+	const std::uintptr_t nPageSize = GetPageSize();
+	const std::uintptr_t nFirstPage = pBegin / nPageSize, nEndPage = (pEnd + nPageSize - 1) / nPageSize;
+
+	std::uint64_t aEntries[s_nPagemapBatch];
+
+	for (std::uintptr_t nPage = nFirstPage; nPage < nEndPage; nPage += s_nPagemapBatch)
+	{
+		const std::size_t nPages = static_cast<std::size_t>(std::min<std::uintptr_t>(s_nPagemapBatch, nEndPage - nPage));
+
+		if (!ReadPagemap(nPage, nPages, aEntries))
+			return false;
+
+		for (std::size_t n = 0; n < nPages; ++n)
+		{
+			if (!(aEntries[n] & s_nSoftDirtyBit))
+				continue;
+
+			const std::uintptr_t pSpan = std::max(pBegin, (nPage + n) * nPageSize), pSpanEnd = std::min(pEnd, (nPage + n + 1) * nPageSize);
+
+			if (!vecSpans.empty() && vecSpans.back().m_pEnd == pSpan)
+				vecSpans.back().m_pEnd = pSpanEnd;
+			else
+				vecSpans.push_back({pSpan, pSpanEnd});
+		}
+	}
+
+	return true;
+}
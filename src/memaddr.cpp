@@ -0,0 +1,217 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/memaddr.hpp>
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+#ifdef _MSC_VER
+#	include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DynLibUtils;
+
+static constexpr std::size_t s_nBlockSize = sizeof(__m128i);
+static constexpr std::size_t s_nHexBlockSize = s_nBlockSize * 3; // "XX " per byte.
+
+//-----------------------------------------------------------------------------
+// Purpose: Hex-encodes 16 bytes as "XX XX ... XX " (48 chars)
+// Input  : pSrc
+//          pDst
+//-----------------------------------------------------------------------------
+static inline void HexEncodeBlock(const std::uint8_t* pSrc, char* pDst) noexcept
+{
+	const __m128i vDigits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+	const __m128i vNibble = _mm_set1_epi8(0x0F);
+
+	const __m128i vBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+	const __m128i vHigh = _mm_shuffle_epi8(vDigits, _mm_and_si128(_mm_srli_epi16(vBytes, 4), vNibble));
+	const __m128i vLow = _mm_shuffle_epi8(vDigits, _mm_and_si128(vBytes, vNibble));
+
+	// Output char j of the block is the high digit, the low digit or the space of byte j / 3 (-1 zeroes a lane).
+	const __m128i vHighIndices[3] =
+	{
+		_mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5),
+		_mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1),
+		_mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1),
+	};
+	const __m128i vLowIndices[3] =
+	{
+		_mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1),
+		_mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10),
+		_mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1),
+	};
+	const __m128i vSpaces[3] =
+	{
+		_mm_setr_epi8(0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0),
+		_mm_setr_epi8(0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0),
+		_mm_setr_epi8(' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' '),
+	};
+
+	for (std::size_t n = 0; n < 3; ++n)
+	{
+		const __m128i vChars = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vHigh, vHighIndices[n]), _mm_shuffle_epi8(vLow, vLowIndices[n])), vSpaces[n]);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + n * s_nBlockSize), vChars);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Converts 16 bytes to their ASCII column chars (see MemToHumanChar)
+// Input  : pSrc
+//          pDst
+//-----------------------------------------------------------------------------
+static inline void HumanEncodeBlock(const std::uint8_t* pSrc, char* pDst) noexcept
+{
+	const __m128i vLow = _mm_set1_epi8(' ' - 1), vHigh = _mm_set1_epi8('~' + 1), vDot = _mm_set1_epi8('.');
+
+	const __m128i vBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+
+	// Signed compares: the bytes from 0x80 are negative, so out of [' ', '~'].
+	const __m128i vHuman = _mm_and_si128(_mm_cmpgt_epi8(vBytes, vLow), _mm_cmplt_epi8(vBytes, vHigh));
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst), _mm_or_si128(_mm_and_si128(vHuman, vBytes), _mm_andnot_si128(vHuman, vDot)));
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Writes the dump lines of a memory range into a buffer
+// Input  : pBuffer
+//          nBufferSize
+//          pData
+//          nSize
+//          nBytesPerLine
+//          pDumpedSize - receives the number of dumped bytes (optional)
+// Output : std::size_t (the number of written chars)
+//-----------------------------------------------------------------------------
+std::size_t DynLibUtils::MemDumpToBuffer(char* pBuffer, std::size_t nBufferSize, const void* pData, std::size_t nSize, std::size_t nBytesPerLine, std::size_t* pDumpedSize) noexcept
+{
+	const auto* pBytes = static_cast<const std::uint8_t*>(pData);
+	const std::uint8_t* pBytesEnd = pBytes + nSize;
+
+	char* pOut = pBuffer;
+	char* const pOutEnd = pBuffer + nBufferSize;
+
+	std::size_t nDumped = 0;
+
+	// The blocks near an end are bounced through the stack: the loads must not cross the range
+	// (the next page may be unmapped) and the stores must not cross the buffer. Inside of them,
+	// a store which runs past its column is overwritten by the next columns.
+	alignas(16) std::uint8_t aSrc[s_nBlockSize];
+	alignas(16) char sDst[s_nHexBlockSize];
+
+	auto funcSource = [&](const std::uint8_t* pSrc, std::size_t nCount) -> const std::uint8_t*
+	{
+		if (static_cast<std::size_t>(pBytesEnd - pSrc) >= s_nBlockSize)
+			return pSrc;
+
+		std::memset(aSrc, 0, sizeof(aSrc));
+		std::memcpy(aSrc, pSrc, nCount);
+
+		return aSrc;
+	};
+
+	while (nDumped < nSize && nBytesPerLine)
+	{
+		const std::size_t nLine = std::min(nBytesPerLine, nSize - nDumped);
+		const std::size_t nLineSize = nBytesPerLine * 3 + nLine + 3;
+
+		if (static_cast<std::size_t>(pOutEnd - pOut) < nLineSize)
+			break;
+
+		const std::uint8_t* pLine = pBytes + nDumped;
+
+		char* pHex = pOut;
+		char* pHuman = pOut + nBytesPerLine * 3 + 1;
+
+		for (std::size_t n = 0; n < nLine; n += s_nBlockSize)
+		{
+			const std::size_t nCount = std::min(s_nBlockSize, nLine - n);
+			const std::uint8_t* pSrc = funcSource(pLine + n, nCount);
+
+			char* pDst = pHex + n * 3;
+
+			if (static_cast<std::size_t>(pOutEnd - pDst) >= s_nHexBlockSize)
+			{
+				HexEncodeBlock(pSrc, pDst);
+			}
+			else
+			{
+				HexEncodeBlock(pSrc, sDst);
+				std::memcpy(pDst, sDst, nCount * 3);
+			}
+		}
+
+		std::memset(pHex + nLine * 3, ' ', (nBytesPerLine - nLine) * 3); // Pads the partial line.
+		pHuman[-1] = '|';
+
+		for (std::size_t n = 0; n < nLine; n += s_nBlockSize)
+		{
+			const std::size_t nCount = std::min(s_nBlockSize, nLine - n);
+			const std::uint8_t* pSrc = funcSource(pLine + n, nCount);
+
+			char* pDst = pHuman + n;
+
+			if (static_cast<std::size_t>(pOutEnd - pDst) >= s_nBlockSize)
+			{
+				HumanEncodeBlock(pSrc, pDst);
+			}
+			else
+			{
+				HumanEncodeBlock(pSrc, sDst);
+				std::memcpy(pDst, sDst, nCount);
+			}
+		}
+
+		pHuman[nLine] = '|';
+		pHuman[nLine + 1] = '\n';
+
+		pOut += nLineSize;
+		nDumped += nLine;
+	}
+
+	if (pDumpedSize)
+		*pDumpedSize = nDumped;
+
+	return static_cast<std::size_t>(pOut - pBuffer);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks the AVX2 support of the CPU and of the OS (YMM state saving)
+// Output : bool
+//-----------------------------------------------------------------------------
+bool DynLibUtils::IsAVX2Supported() noexcept
+{
+	static const bool s_bSupported = []()
+	{
+#ifdef _MSC_VER
+		int aInfo[4];
+
+		__cpuid(aInfo, 0);
+
+		if (aInfo[0] < 7)
+			return false;
+
+		__cpuid(aInfo, 1);
+
+		constexpr int kOSXSave = 1 << 27, kAVX = 1 << 28;
+
+		if ((aInfo[2] & (kOSXSave | kAVX)) != (kOSXSave | kAVX) || (_xgetbv(0) & 6) != 6)
+			return false;
+
+		__cpuidex(aInfo, 7, 0);
+
+		return (aInfo[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}();
+
+	return s_bSupported;
+}
@@ -0,0 +1,93 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/memsource.hpp>
+
+using namespace DynLibUtils;
+
+CMemorySource::CMemorySource() : m_nPid(GetCurrentPid()), m_bLocal(true)
+{
+	m_bValid = Open();
+}
+
+CMemorySource::CMemorySource(ProcessId_t nPid) : m_nPid(nPid), m_bLocal(nPid == GetCurrentPid())
+{
+	m_bValid = Open();
+}
+
+CMemorySource::~CMemorySource()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads memory of the process
+// Input  : pAddress
+//          pBuffer
+//          nSize
+// Output : std::size_t (the number of bytes read)
+//-----------------------------------------------------------------------------
+std::size_t CMemorySource::Read(const CMemory pAddress, void* pBuffer, std::size_t nSize) const
+{
+	if (!m_bValid || !nSize)
+		return 0;
+
+	const auto p = static_cast<std::uintptr_t>(pAddress.GetAddr());
+
+	if (!m_bLocal)
+		return ReadRemote(p, pBuffer, nSize);
+
+	CRegionMap& regions = CRegionMap::Get();
+
+	if (regions.IsReadable(p, nSize))
+	{
+		std::memcpy(pBuffer, reinterpret_cast<const void*>(p), nSize);
+
+		return nSize;
+	}
+
+	// Up to the first unreadable byte.
+	Region_t region;
+
+	if (!regions.FindRegion(p, region) || !region.IsReadable())
+		return 0;
+
+	const std::size_t nRead = std::min<std::size_t>(nSize, region.m_pEnd - p);
+
+	std::memcpy(pBuffer, reinterpret_cast<const void*>(p), nRead);
+
+	return nRead;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads many ranges of the process
+// Input  : pRequests
+//          nCount
+// Output : std::size_t (the number of fully read ranges)
+//-----------------------------------------------------------------------------
+std::size_t CMemorySource::ReadBatch(ReadRequest_t* pRequests, std::size_t nCount) const
+{
+	if (!m_bValid)
+	{
+		for (std::size_t n = 0; n < nCount; ++n)
+			pRequests[n].m_nRead = 0;
+
+		return 0;
+	}
+
+	if (!m_bLocal)
+		return ReadBatchRemote(pRequests, nCount);
+
+	std::size_t nFull = 0;
+
+	for (std::size_t n = 0; n < nCount; ++n)
+	{
+		ReadRequest_t& request = pRequests[n];
+
+		request.m_nRead = Read(request.m_pAddress, request.m_pBuffer, request.m_nSize);
+		nFull += request.m_nRead == request.m_nSize;
+	}
+
+	return nFull;
+}
@@ -4,11 +4,17 @@
 
 #include <dynlibutils/module.hpp>
 #include <dynlibutils/memaddr.hpp>
+#include <dynlibutils/virtual.hpp>
 
 #include <cstring>
 #include <cmath>
+#include <climits>
 #include <emmintrin.h>
 
+#ifndef _WIN32
+#	include <dlfcn.h>
+#endif
+
 using namespace DynLibUtils;
 
 //-----------------------------------------------------------------------------
@@ -29,6 +35,290 @@ CModule::CModule(const CMemory pModuleMemory)
 	InitFromMemory(pModuleMemory);
 }
 
+//-----------------------------------------------------------------------------
+// Purpose: Checks 4 consecutive pointers for being in [base, base + size)
+//          (size < 2 GiB): the high dword of (ptr - base) must be zero and
+//          the low one below size, both compared with SSE2 only
+// Input  : pSlots
+//          vBase - base in both 64-bit lanes
+//          vSizeBiased - size ^ 0x80000000 in every 32-bit lane
+// Output : bit N is set if pSlots[N] is in range
+//-----------------------------------------------------------------------------
+[[maybe_unused]] static inline int GetInRangeMask4(void* const* pSlots, const __m128i vBase, const __m128i vSizeBiased)
+{
+	const __m128i vBias = _mm_set1_epi32(INT_MIN);
+	const __m128i vZero = _mm_setzero_si128();
+
+	int nResult = 0;
+
+	for (int i = 0; i < 2; ++i)
+	{
+		const __m128i vSlots = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSlots + i * 2));
+		const __m128i vDelta = _mm_sub_epi64(vSlots, vBase);
+		const __m128i vLowInRange = _mm_cmplt_epi32(_mm_xor_si128(vDelta, vBias), vSizeBiased);
+		const __m128i vHighZero = _mm_srli_epi64(_mm_cmpeq_epi32(vDelta, vZero), 32); // Move the high dword flag to the low one.
+		const int nMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(vLowInRange, vHighZero)));
+
+		nResult |= ((nMask & 1) | ((nMask >> 1) & 2)) << (i * 2);
+	}
+
+	return nResult;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Counts the slots of a vtable which point into the executable
+//          sections of a module
+// Input  : module
+//          nMaxLength
+// Output : std::size_t (0 if the vtable is not inside the module)
+//-----------------------------------------------------------------------------
+std::size_t CVirtualTable::GetLength(const CModule& module, std::size_t nMaxLength) const
+{
+	const Section_t* pSection = module.GetSectionByAddress(m_pVTFs);
+
+	if (!pSection)
+		return 0;
+
+	const auto [pCodeBegin, pCodeEnd] = module.GetExecutableRange();
+
+	if (!pCodeBegin.IsValid())
+		return 0;
+
+	// Pure and deleted virtual stubs are provided by the C++ runtime, outside of the module.
+#ifdef _WIN32
+	static const std::uintptr_t s_pPureVirtual = 0, s_pDeletedVirtual = 0;
+#else
+	static const std::uintptr_t s_pPureVirtual = reinterpret_cast<std::uintptr_t>(dlsym(RTLD_DEFAULT, "__cxa_pure_virtual"));
+	static const std::uintptr_t s_pDeletedVirtual = reinterpret_cast<std::uintptr_t>(dlsym(RTLD_DEFAULT, "__cxa_deleted_virtual"));
+#endif
+
+	const std::uintptr_t nCodeBase = pCodeBegin.GetAddr();
+	const std::uintptr_t nCodeSize = pCodeEnd.GetAddr() - nCodeBase;
+	const std::size_t nSectionSlots = (pSection->GetAddr() + pSection->m_nSectionSize - m_diff) / sizeof(void*);
+	const std::size_t nLimit = std::min(nMaxLength, nSectionSlots);
+
+	auto funcIsMethod = [&](const std::uintptr_t pSlot) -> bool
+	{
+		return pSlot - nCodeBase < nCodeSize || (pSlot && (pSlot == s_pPureVirtual || pSlot == s_pDeletedVirtual));
+	};
+
+	std::size_t n = 0;
+
+#if INTPTR_MAX == INT64_MAX
+	if (nCodeSize <= INT_MAX)
+	{
+		const __m128i vBase = _mm_set1_epi64x(static_cast<long long>(nCodeBase));
+		const __m128i vSizeBiased = _mm_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(nCodeSize) ^ 0x80000000u));
+
+		while (n + 4 <= nLimit)
+		{
+			const int nMask = GetInRangeMask4(m_pVTFs + n, vBase, vSizeBiased);
+
+			if (nMask == 0xF)
+			{
+				n += 4;
+				continue;
+			}
+
+			std::size_t nFirstMiss = 0; // Skip the leading in-range slots.
+
+			while (nMask & (1 << nFirstMiss))
+				++nFirstMiss;
+
+			n += nFirstMiss;
+
+			if (!funcIsMethod(reinterpret_cast<std::uintptr_t>(m_pVTFs[n])))
+				return n;
+
+			++n; // A pure virtual stub, keep going.
+		}
+	}
+#endif
+
+	while (n < nLimit && funcIsMethod(reinterpret_cast<std::uintptr_t>(m_pVTFs[n])))
+		++n;
+
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds pointer-aligned slots holding a value using SIMD instructions
+// Input  : pBegin
+//          pEnd
+//          pValue
+//          funcFound - void (void** pSlot)
+//-----------------------------------------------------------------------------
+template<typename FUNC>
+static void FindAlignedPointers(const std::uintptr_t pBegin, const std::uintptr_t pEnd, const std::uintptr_t pValue, const FUNC& funcFound)
+{
+	constexpr std::uintptr_t kAlign = sizeof(void*);
+
+	auto* pSlot = reinterpret_cast<void**>((pBegin + kAlign - 1) & ~(kAlign - 1));
+	auto* const pLast = reinterpret_cast<void**>(pEnd & ~(kAlign - 1));
+
+#if INTPTR_MAX == INT64_MAX
+	const __m128i vValue = _mm_set1_epi64x(static_cast<long long>(pValue));
+
+	// 4 slots per iteration: a qword matches if both of its dwords do.
+	for (; pSlot + 4 <= pLast; pSlot += 4)
+	{
+		const __m128i vLow = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSlot)), vValue);
+		const __m128i vHigh = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSlot + 2)), vValue);
+		const int nMask = _mm_movemask_ps(_mm_castsi128_ps(vLow)) | (_mm_movemask_ps(_mm_castsi128_ps(vHigh)) << 4);
+
+		if (!nMask)
+			continue;
+
+		for (int n = 0; n < 4; ++n)
+		{
+			if (((nMask >> (n * 2)) & 3) == 3)
+				funcFound(pSlot + n);
+		}
+	}
+#endif
+
+	for (; pSlot < pLast; ++pSlot)
+	{
+		if (reinterpret_cast<std::uintptr_t>(*pSlot) == pValue)
+			funcFound(pSlot);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds every vtable of the module whose slot nIndex holds a function
+//          (e.g. all derived classes which inherit a base implementation)
+// Input  : pFunction
+//          nIndex
+// Output : std::vector<CMemory> (vtables, sorted by address)
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CModule::GetVirtualTablesByMethod(const CMemory pFunction, const std::ptrdiff_t nIndex) const
+{
+	std::vector<CMemory> vecResult;
+
+	if (!pFunction.IsValid() || nIndex < 0)
+		return vecResult;
+
+	const auto [pCodeBegin, pCodeEnd] = GetExecutableRange();
+
+	auto funcIsCode = [&](const void* p) -> bool
+	{
+		const auto nAddr = reinterpret_cast<std::uintptr_t>(p);
+
+		return static_cast<std::uintptr_t>(pCodeBegin.GetAddr()) <= nAddr && nAddr < static_cast<std::uintptr_t>(pCodeEnd.GetAddr());
+	};
+
+	for (const auto& section : m_vecSections)
+	{
+		// Vtables live in read-only data (.data.rel.ro on ELF after relocation, .rdata on PE).
+		if (!(section.m_nFlags & Section_t::Readable) || section.IsExecutable() || !section.m_nSectionSize)
+			continue;
+
+		const std::uintptr_t pBegin = section.GetAddr();
+		const std::uintptr_t pEnd = pBegin + section.m_nSectionSize;
+		const std::uintptr_t nPrefixBytes = (nIndex + DYNLIB_VTABLE_PREFIX_SIZE) * sizeof(void*);
+
+		FindAlignedPointers(pBegin + nIndex * sizeof(void*), pEnd, pFunction.GetAddr(), [&](void** pSlot)
+		{
+			void** pVTable = pSlot - nIndex;
+
+			if (reinterpret_cast<std::uintptr_t>(pSlot) - pBegin < nPrefixBytes)
+				return;
+
+			// The RTTI prefix must not look like a method: it separates this vtable from the previous one.
+			const void* pRTTI = pVTable[-1];
+
+			if (!pRTTI || funcIsCode(pRTTI))
+				return;
+
+#if DYNLIB_VTABLE_PREFIX_SIZE > 1
+			const auto nOffsetToTop = reinterpret_cast<std::intptr_t>(pVTable[-2]);
+
+			if (nOffsetToTop > 0 || nOffsetToTop < -0x1000000)
+				return;
+#endif
+
+			// Every slot before nIndex must be a method as well (pure virtual stubs included).
+			if (nIndex && CVirtualTable(CMemory(pVTable)).GetLength(*this, nIndex) < static_cast<std::size_t>(nIndex))
+				return;
+
+			vecResult.emplace_back(pVTable);
+		});
+	}
+
+	std::sort(vecResult.begin(), vecResult.end());
+
+	return vecResult;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks for a typical x86-64 function prologue (GCC, Clang and MSVC)
+// Input  : p
+// Output : bool
+//-----------------------------------------------------------------------------
+static bool IsPrologue(const std::uint8_t* p) noexcept
+{
+	if (p[0] == 0xF3 && p[1] == 0x0F && p[2] == 0x1E && p[3] == 0xFA)
+		return true; // endbr64
+
+	if (p[0] == 0x55 || p[0] == 0x53 || p[0] == 0x56 || p[0] == 0x57)
+		return true; // push rbp/rbx/rsi/rdi
+
+	if ((p[0] == 0x41 || p[0] == 0x40) && 0x50 <= p[1] && p[1] <= 0x57)
+		return true; // push r8-r15 (or a REX-prefixed push)
+
+	if (p[0] == 0x48 && (p[1] == 0x83 || p[1] == 0x81) && p[2] == 0xEC)
+		return true; // sub rsp, imm
+
+	if ((p[0] == 0x48 || p[0] == 0x4C) && p[1] == 0x89 && (p[2] & 0xC7) == 0x44 && p[3] == 0x24)
+		return true; // mov [rsp+disp8], reg (MSVC home space)
+
+	if (p[0] == 0x48 && p[1] == 0x8B && p[2] == 0xC4)
+		return true; // mov rax, rsp
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the start of the function containing an address
+// Input  : pAddress
+//          nMaxDistance
+// Output : CMemory
+//-----------------------------------------------------------------------------
+CMemory CModule::FindFunctionStart(const CMemory pAddress, const std::size_t nMaxDistance) const
+{
+	const Section_t function = GetFunctionRange(pAddress);
+
+	if (function.IsValid())
+		return function;
+
+	const Section_t* pSection = GetSectionByAddress(pAddress);
+
+	if (!pSection || !pSection->IsExecutable())
+		return DYNLIB_INVALID_MEMORY;
+
+	const auto pBegin = static_cast<std::uintptr_t>(pSection->GetAddr());
+	const auto pAddr = static_cast<std::uintptr_t>(pAddress.GetAddr());
+	const std::uintptr_t pLimit = pAddr - std::min<std::uintptr_t>(pAddr - pBegin, nMaxDistance);
+
+	constexpr std::uintptr_t kAlign = 16;
+
+	for (std::uintptr_t p = pAddr & ~(kAlign - 1); p >= pLimit; p -= kAlign)
+	{
+		const auto* pCode = reinterpret_cast<const std::uint8_t*>(p);
+
+		// The first function of a section has nothing before it.
+		const bool bBoundary = p == pBegin || pCode[-1] == 0xCC || pCode[-1] == 0x90 || pCode[-1] == 0xC3 || pCode[-1] == 0x00;
+
+		if (bBoundary && IsPrologue(pCode))
+			return p;
+
+		if (p < kAlign)
+			break;
+	}
+
+	return DYNLIB_INVALID_MEMORY;
+}
+
 #ifndef DYNLIBUTILS_SEPARATE_SOURCE_FILES
 	#if defined _WIN32 && _M_X64
 		#include "module_windows.cpp"
@@ -0,0 +1,205 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/pointerpath.hpp>
+
+#include <xmmintrin.h>
+
+#include <algorithm>
+
+using namespace DynLibUtils;
+
+CPointerPath::CPointerPath(const CMemory pBase, const std::vector<std::ptrdiff_t>& vecOffsets, bool bChecked) : m_pBase(pBase), m_bChecked(bChecked)
+{
+	if (vecOffsets.empty())
+		return;
+
+	m_vecLinks.reserve(vecOffsets.size() - 1);
+
+	for (std::size_t n = 0; n + 1 < vecOffsets.size(); ++n)
+		m_vecLinks.push_back({vecOffsets[n], 0, 0});
+
+	m_nFinalOffset = vecOffsets.back();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads a link
+// Input  : pSlot
+//          pValue
+// Output : false if the slot is unmapped (checked paths only)
+//-----------------------------------------------------------------------------
+bool CPointerPath::Read(std::uintptr_t pSlot, std::uintptr_t& pValue) const
+{
+	if (m_bChecked && !IsMemoryReadable(pSlot, sizeof(std::uintptr_t)))
+		return false;
+
+	pValue = *reinterpret_cast<const std::uintptr_t*>(pSlot);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Compares the cached links with the memory
+// Output : std::size_t (the number of leading unchanged links)
+//-----------------------------------------------------------------------------
+std::size_t CPointerPath::Validate() const
+{
+	if (m_bChecked)
+	{
+		for (std::size_t n = 0; n < m_nCachedLinks; ++n)
+		{
+			std::uintptr_t pValue;
+
+			if (!Read(m_vecLinks[n].m_pSlot, pValue) || pValue != m_vecLinks[n].m_pValue)
+				return n;
+		}
+
+		return m_nCachedLinks;
+	}
+
+	// A slot is only read once the links before it are known to be unchanged (it may be unmapped
+	// otherwise); the callers prefetch all of them first, as a prefetch never faults.
+	for (std::size_t n = 0; n < m_nCachedLinks; ++n)
+	{
+		if (*reinterpret_cast<const std::uintptr_t*>(m_vecLinks[n].m_pSlot) != m_vecLinks[n].m_pValue)
+			return n;
+	}
+
+	return m_nCachedLinks;
+}
+
+void CPointerPath::Prefetch() const noexcept
+{
+	for (std::size_t n = 0; n < m_nCachedLinks; ++n)
+		_mm_prefetch(reinterpret_cast<const char*>(m_vecLinks[n].m_pSlot), _MM_HINT_T0);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads the first uncached link
+// Output : false if it can't be followed (a null base or value, an unmapped slot)
+//-----------------------------------------------------------------------------
+bool CPointerPath::Step()
+{
+	const std::uintptr_t pBase = GetLinkBase(m_nCachedLinks);
+
+	if (!pBase)
+		return false;
+
+	Link_t& link = m_vecLinks[m_nCachedLinks];
+
+	link.m_pSlot = pBase + link.m_nOffset;
+
+	if (!Read(link.m_pSlot, link.m_pValue))
+		return false;
+
+	++m_nCachedLinks;
+
+	return true;
+}
+
+CMemory CPointerPath::Finish() noexcept
+{
+	const std::uintptr_t pBase = GetLinkBase(m_vecLinks.size());
+
+	return m_pResult = pBase ? CMemory(pBase + m_nFinalOffset) : DYNLIB_INVALID_MEMORY;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Resolves the path through the cached links
+// Output : CMemory
+//-----------------------------------------------------------------------------
+CMemory CPointerPath::Resolve()
+{
+	Prefetch();
+
+	m_nCachedLinks = Validate();
+
+	while (m_nCachedLinks < m_vecLinks.size())
+	{
+		if (!Step())
+			return m_pResult = DYNLIB_INVALID_MEMORY;
+	}
+
+	return Finish();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Resolves the path walking every link
+// Output : CMemory
+//-----------------------------------------------------------------------------
+CMemory CPointerPath::ResolveUncached() const
+{
+	auto pAddress = static_cast<std::uintptr_t>(m_pBase.GetAddr());
+
+	for (const auto& link : m_vecLinks)
+	{
+		if (!pAddress || !Read(pAddress + link.m_nOffset, pAddress))
+			return DYNLIB_INVALID_MEMORY;
+	}
+
+	return pAddress ? CMemory(pAddress + m_nFinalOffset) : DYNLIB_INVALID_MEMORY;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Resolves many paths, overlapping their cache misses
+// Input  : pPaths
+//          nCount
+// Output : std::size_t (the number of valid paths)
+//-----------------------------------------------------------------------------
+std::size_t CPointerPath::ResolveBatch(CPointerPath* pPaths, std::size_t nCount)
+{
+	for (std::size_t n = 0; n < nCount; ++n)
+		pPaths[n].Prefetch();
+
+	std::vector<CPointerPath*> vecWalking;
+
+	for (std::size_t n = 0; n < nCount; ++n)
+	{
+		CPointerPath& path = pPaths[n];
+
+		path.m_nCachedLinks = path.Validate();
+
+		if (path.m_nCachedLinks < path.m_vecLinks.size())
+		{
+			_mm_prefetch(reinterpret_cast<const char*>(path.GetLinkBase(path.m_nCachedLinks) + path.m_vecLinks[path.m_nCachedLinks].m_nOffset), _MM_HINT_T0);
+			vecWalking.push_back(&path);
+		}
+		else
+		{
+			path.Finish();
+		}
+	}
+
+	// One level of every walking chain at a time, the next slot being prefetched while the others are read.
+	while (!vecWalking.empty())
+	{
+		std::size_t nWalking = 0;
+
+		for (CPointerPath* pPath : vecWalking)
+		{
+			CPointerPath& path = *pPath;
+
+			if (!path.Step())
+			{
+				path.m_pResult = DYNLIB_INVALID_MEMORY;
+
+				continue;
+			}
+
+			if (path.m_nCachedLinks == path.m_vecLinks.size())
+			{
+				path.Finish();
+
+				continue;
+			}
+
+			_mm_prefetch(reinterpret_cast<const char*>(path.GetLinkBase(path.m_nCachedLinks) + path.m_vecLinks[path.m_nCachedLinks].m_nOffset), _MM_HINT_T0);
+			vecWalking[nWalking++] = pPath;
+		}
+
+		vecWalking.resize(nWalking);
+	}
+
+	return static_cast<std::size_t>(std::count_if(pPaths, pPaths + nCount, [](const CPointerPath& path) { return path.m_pResult.IsValid(); }));
+}
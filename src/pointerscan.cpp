@@ -0,0 +1,335 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/pointerscan.hpp>
+#include <dynlibutils/module.hpp>
+#include <dynlibutils/regions.hpp>
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#	include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+using namespace DynLibUtils;
+
+static constexpr std::uintptr_t s_nChunkSize = 1 << 20; // Bytes a thread takes at a time.
+
+// Returns the index of the lowest set bit (nMask must not be 0).
+static inline int CountTrailingZeros(unsigned int nMask) noexcept
+{
+#ifdef _MSC_VER
+	unsigned long nIndex;
+
+	_BitScanForward(&nIndex, nMask);
+
+	return static_cast<int>(nIndex);
+#else
+	return __builtin_ctz(nMask);
+#endif
+}
+
+// _mm_cmpgt_epi64 with SSE2 (it is SSE4.2): the high dwords compared signed, the low ones unsigned on a tie.
+static inline __m128i CompareGreaterEpi64(__m128i vA, __m128i vB) noexcept
+{
+	const __m128i vLowSign = _mm_set_epi32(0, static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000));
+
+	vA = _mm_xor_si128(vA, vLowSign);
+	vB = _mm_xor_si128(vB, vLowSign);
+
+	const __m128i vGreater = _mm_cmpgt_epi32(vA, vB);
+	const __m128i vResult = _mm_or_si128(vGreater, _mm_and_si128(_mm_cmpeq_epi32(vA, vB), _mm_slli_epi64(vGreater, 32)));
+
+	return _mm_shuffle_epi32(vResult, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+// A value v is in [low, low + size) when v - low < size unsigned, that is (v - low) ^ sign < size ^ sign signed.
+static constexpr std::uint64_t s_nSignBit = 0x8000000000000000;
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the slots of an aligned range which point into [pLow, pLow + nSize)
+//          with SSE2 (8 slots a step)
+// Input  : p
+//          pEnd
+//          pLow
+//          nSize
+//          vecSlots
+// Output : std::uintptr_t (the address where it stopped)
+//-----------------------------------------------------------------------------
+static std::uintptr_t ScanSSE(std::uintptr_t p, const std::uintptr_t pEnd, const std::uintptr_t pLow, const std::uintptr_t nSize, std::vector<std::uintptr_t>& vecSlots)
+{
+	const __m128i vLow = _mm_set1_epi64x(static_cast<long long>(pLow));
+	const __m128i vSign = _mm_set1_epi64x(static_cast<long long>(s_nSignBit));
+	const __m128i vSize = _mm_set1_epi64x(static_cast<long long>(nSize ^ s_nSignBit));
+
+	auto funcCompare = [&](std::uintptr_t pAt)
+	{
+		const __m128i vValues = _mm_load_si128(reinterpret_cast<const __m128i*>(pAt));
+
+		return CompareGreaterEpi64(vSize, _mm_xor_si128(_mm_sub_epi64(vValues, vLow), vSign));
+	};
+
+	for (; p + 4 * sizeof(__m128i) <= pEnd; p += 4 * sizeof(__m128i))
+	{
+		const __m128i v0 = funcCompare(p), v1 = funcCompare(p + 16), v2 = funcCompare(p + 32), v3 = funcCompare(p + 48);
+
+		// Every 8 bytes of movemask_pd bits: 2 slots per vector.
+		const unsigned int nMask = static_cast<unsigned int>(_mm_movemask_pd(_mm_castsi128_pd(v0))) |
+		                           static_cast<unsigned int>(_mm_movemask_pd(_mm_castsi128_pd(v1))) << 2 |
+		                           static_cast<unsigned int>(_mm_movemask_pd(_mm_castsi128_pd(v2))) << 4 |
+		                           static_cast<unsigned int>(_mm_movemask_pd(_mm_castsi128_pd(v3))) << 6;
+
+		for (unsigned int nBits = nMask; nBits; nBits &= nBits - 1)
+			vecSlots.push_back(p + CountTrailingZeros(nBits) * sizeof(std::uintptr_t));
+	}
+
+	return p;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Same as ScanSSE with AVX2 (16 slots a step)
+//-----------------------------------------------------------------------------
+DYNLIB_TARGET_AVX2 static std::uintptr_t ScanAVX2(std::uintptr_t p, const std::uintptr_t pEnd, const std::uintptr_t pLow, const std::uintptr_t nSize, std::vector<std::uintptr_t>& vecSlots)
+{
+	const __m256i vLow = _mm256_set1_epi64x(static_cast<long long>(pLow));
+	const __m256i vSign = _mm256_set1_epi64x(static_cast<long long>(s_nSignBit));
+	const __m256i vSize = _mm256_set1_epi64x(static_cast<long long>(nSize ^ s_nSignBit));
+
+	for (; p + 4 * sizeof(__m256i) <= pEnd; p += 4 * sizeof(__m256i))
+	{
+		unsigned int nMask = 0;
+
+		for (unsigned int n = 0; n < 4; ++n)
+		{
+			const __m256i vValues = _mm256_load_si256(reinterpret_cast<const __m256i*>(p + n * sizeof(__m256i)));
+			const __m256i vInside = _mm256_cmpgt_epi64(vSize, _mm256_xor_si256(_mm256_sub_epi64(vValues, vLow), vSign));
+
+			nMask |= static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(vInside))) << (n * 4);
+		}
+
+		for (unsigned int nBits = nMask; nBits; nBits &= nBits - 1)
+			vecSlots.push_back(p + CountTrailingZeros(nBits) * sizeof(std::uintptr_t));
+	}
+
+	return p;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the slots of a range which point into [pLow, pLow + nSize)
+// Input  : pBegin
+//          pEnd
+//          pLow
+//          nSize
+//          vecSlots - receives them, in ascending order
+//-----------------------------------------------------------------------------
+static void ScanRange(std::uintptr_t pBegin, std::uintptr_t pEnd, const std::uintptr_t pLow, const std::uintptr_t nSize, std::vector<std::uintptr_t>& vecSlots)
+{
+	constexpr std::uintptr_t kSlotSize = sizeof(std::uintptr_t);
+
+	static const bool s_bAVX2 = IsAVX2Supported();
+
+	std::uintptr_t p = (pBegin + kSlotSize - 1) & ~(kSlotSize - 1);
+	const std::uintptr_t pAlignedEnd = pEnd & ~(kSlotSize - 1);
+
+	auto funcScalar = [&](std::uintptr_t pUntil)
+	{
+		for (; p < pUntil; p += kSlotSize)
+		{
+			if (*reinterpret_cast<const std::uintptr_t*>(p) - pLow < nSize)
+				vecSlots.push_back(p);
+		}
+	};
+
+	// Up to the vector alignment.
+	funcScalar(std::min(pAlignedEnd, (p + 31) & ~static_cast<std::uintptr_t>(31)));
+
+	p = s_bAVX2 ? ScanAVX2(p, pAlignedEnd, pLow, nSize, vecSlots) : ScanSSE(p, pAlignedEnd, pLow, nSize, vecSlots);
+
+	funcScalar(pAlignedEnd);
+}
+
+void CPointerScanner::AddModule(const CModule& module)
+{
+	for (const auto& section : module.GetSections())
+	{
+		if ((section.m_nFlags & Section_t::Readable) && section.IsWritable())
+			AddRange(section, section.m_nSectionSize);
+	}
+}
+
+void CPointerScanner::AddWritableRegions()
+{
+	CRegionMap& regions = CRegionMap::Get();
+
+	regions.Refresh(true);
+
+	for (const auto& region : regions.GetRegions())
+	{
+		if (region.IsReadable() && region.IsWritable())
+			AddRange(region.m_pBegin, region.m_pEnd - region.m_pBegin);
+	}
+}
+
+void CPointerScanner::AddRange(const CMemory pBegin, std::size_t nSize)
+{
+	if (nSize)
+		m_vecRanges.push_back({static_cast<std::uintptr_t>(pBegin.GetAddr()), static_cast<std::uintptr_t>(pBegin.GetAddr()) + nSize});
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Sweeps the ranges with the worker threads
+// Input  : pLow
+//          nSize
+//          funcFilter - accepts or drops the slots whose value is in
+//                       [pLow, pLow + nSize) (all are accepted if empty)
+// Output : std::vector<CMemory> (sorted by address)
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CPointerScanner::Scan(std::uintptr_t pLow, std::uintptr_t nSize, const std::function<bool (std::uintptr_t pSlot)>& funcFilter) const
+{
+	std::vector<CMemory> vecResult;
+
+	if (!nSize || m_vecRanges.empty())
+		return vecResult;
+
+	// Sorted, merged ranges, cut into chunks.
+	std::vector<Range_t> vecRanges = m_vecRanges;
+
+	std::sort(vecRanges.begin(), vecRanges.end(), [](const Range_t& left, const Range_t& right) { return left.m_pBegin < right.m_pBegin; });
+
+	std::vector<Range_t> vecChunks;
+
+	for (std::size_t n = 0; n < vecRanges.size(); )
+	{
+		Range_t range = vecRanges[n++];
+
+		while (n < vecRanges.size() && vecRanges[n].m_pBegin <= range.m_pEnd)
+			range.m_pEnd = std::max(range.m_pEnd, vecRanges[n++].m_pEnd);
+
+		// The chunks end at multiples of their size, so no aligned slot straddles two of them.
+		for (std::uintptr_t p = range.m_pBegin, pNext; p < range.m_pEnd; p = pNext)
+		{
+			pNext = std::min((p & ~(s_nChunkSize - 1)) + s_nChunkSize, range.m_pEnd);
+			vecChunks.push_back({p, pNext});
+		}
+	}
+
+	std::vector<std::vector<std::uintptr_t>> vecChunkSlots(vecChunks.size());
+	std::atomic<std::size_t> nNextChunk {0};
+
+	auto funcWorker = [&]()
+	{
+		for (std::size_t n; (n = nNextChunk.fetch_add(1, std::memory_order_relaxed)) < vecChunks.size(); )
+		{
+			auto& vecSlots = vecChunkSlots[n];
+
+			ScanRange(vecChunks[n].m_pBegin, vecChunks[n].m_pEnd, pLow, nSize, vecSlots);
+
+			if (funcFilter)
+				vecSlots.erase(std::remove_if(vecSlots.begin(), vecSlots.end(), [&](std::uintptr_t pSlot) { return !funcFilter(pSlot); }), vecSlots.end());
+		}
+	};
+
+	std::size_t nThreads = m_nThreads ? m_nThreads : std::max(1u, std::thread::hardware_concurrency());
+
+	nThreads = std::min(nThreads, vecChunks.size());
+
+	std::vector<std::thread> vecThreads;
+
+	vecThreads.reserve(nThreads - 1);
+
+	for (std::size_t n = 1; n < nThreads; ++n)
+		vecThreads.emplace_back(funcWorker);
+
+	funcWorker();
+
+	for (auto& thread : vecThreads)
+		thread.join();
+
+	std::size_t nCount = 0;
+
+	for (const auto& vecSlots : vecChunkSlots)
+		nCount += vecSlots.size();
+
+	vecResult.reserve(nCount);
+
+	for (const auto& vecSlots : vecChunkSlots)
+	{
+		for (const auto pSlot : vecSlots)
+			vecResult.emplace_back(pSlot);
+	}
+
+	return vecResult;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the slots which point into an address range
+// Input  : pBegin
+//          pEnd
+// Output : std::vector<CMemory> (sorted by address)
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CPointerScanner::Find(const CMemory pBegin, const CMemory pEnd) const
+{
+	const auto pLow = static_cast<std::uintptr_t>(pBegin.GetAddr()), pHigh = static_cast<std::uintptr_t>(pEnd.GetAddr());
+
+	return Scan(pLow, pHigh > pLow ? pHigh - pLow : 0, nullptr);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the slots which hold one of some values
+// Input  : vecValues
+// Output : std::vector<CMemory> (sorted by address)
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CPointerScanner::FindValues(const std::vector<CMemory>& vecValues) const
+{
+	if (vecValues.empty())
+		return {};
+
+	std::vector<std::uintptr_t> vecSorted;
+
+	vecSorted.reserve(vecValues.size());
+
+	for (const auto& value : vecValues)
+		vecSorted.push_back(static_cast<std::uintptr_t>(value.GetAddr()));
+
+	std::sort(vecSorted.begin(), vecSorted.end());
+	vecSorted.erase(std::unique(vecSorted.begin(), vecSorted.end()), vecSorted.end());
+
+	// The sweep keeps [min, max]; a single value (or a run of them) needs no other check.
+	const std::uintptr_t pLow = vecSorted.front(), nSize = vecSorted.back() - pLow + 1;
+
+	if (nSize == vecSorted.size())
+		return Scan(pLow, nSize, nullptr);
+
+	return Scan(pLow, nSize, [&vecSorted](std::uintptr_t pSlot)
+	{
+		return std::binary_search(vecSorted.cbegin(), vecSorted.cend(), *reinterpret_cast<const std::uintptr_t*>(pSlot));
+	});
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the objects whose vptr is one of some vtables
+// Input  : vecVTables - address points (as GetVirtualTableByName returns them)
+//          nValidateSize - if not 0, the objects must have as many bytes
+//                          writable in the region map (which drops the
+//                          vtable references of read-only data)
+// Output : std::vector<CMemory> (sorted by address)
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CPointerScanner::FindInstances(const std::vector<CMemory>& vecVTables, std::size_t nValidateSize) const
+{
+	std::vector<CMemory> vecResult = FindValues(vecVTables);
+
+	if (nValidateSize)
+	{
+		CRegionMap& regions = CRegionMap::Get();
+
+		vecResult.erase(std::remove_if(vecResult.begin(), vecResult.end(), [&](const CMemory pObject) { return !regions.IsWritable(pObject, nValidateSize); }), vecResult.end());
+	}
+
+	return vecResult;
+}
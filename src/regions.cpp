@@ -0,0 +1,265 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/regions.hpp>
+#include <dynlibutils/epoch.hpp>
+
+#include <algorithm>
+
+using namespace DynLibUtils;
+
+static std::atomic<std::uint64_t> s_nNextSerial {1};
+
+// The region of the last hit of the thread (in the snapshot of that serial).
+static thread_local struct
+{
+	std::uint64_t m_nSerial;
+	std::size_t m_nIndex;
+} s_lastHit {};
+
+static std::int64_t GetTicks() noexcept
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CRegionMap::CRegionMap() : m_pSnapshot(nullptr), m_nGeneration(0), m_nLastRefresh(0), m_nMissRefreshInterval(100)
+{
+	Refresh(true);
+}
+
+CRegionMap::~CRegionMap()
+{
+	// No readers are expected at destruction.
+	delete m_pSnapshot.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Rebuilds the map if the loaded modules changed
+// Input  : bForce - rebuilds it anyway
+// Output : true if it was rebuilt
+//-----------------------------------------------------------------------------
+bool CRegionMap::Refresh(bool bForce)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const std::uint64_t nGeneration = GetModuleGeneration();
+	const Snapshot_t* pOld = m_pSnapshot.load(std::memory_order_relaxed);
+
+	if (!bForce && pOld && pOld->m_nGeneration == nGeneration)
+		return false;
+
+	auto* pNew = new Snapshot_t {{}, s_nNextSerial.fetch_add(1, std::memory_order_relaxed), nGeneration};
+
+	if (pOld)
+		pNew->m_vecRegions.reserve(pOld->m_vecRegions.size());
+
+	Collect(pNew->m_vecRegions);
+
+	// Merges the adjacent regions with the same access.
+	auto& vecRegions = pNew->m_vecRegions;
+	std::size_t nCount = 0;
+
+	for (const auto& region : vecRegions)
+	{
+		if (!region.m_nFlags)
+			continue;
+
+		if (nCount && vecRegions[nCount - 1].m_pEnd == region.m_pBegin && vecRegions[nCount - 1].m_nFlags == region.m_nFlags)
+			vecRegions[nCount - 1].m_pEnd = region.m_pEnd;
+		else
+			vecRegions[nCount++] = region;
+	}
+
+	vecRegions.resize(nCount);
+	vecRegions.shrink_to_fit();
+
+	m_pSnapshot.store(pNew, std::memory_order_release);
+	m_nGeneration.store(nGeneration, std::memory_order_relaxed);
+	m_nLastRefresh.store(GetTicks(), std::memory_order_relaxed);
+
+	CEpoch::Reclaim(pOld);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the region which contains an address
+// Input  : pSnapshot
+//          pAddress
+// Output : const Region_t* (nullptr if it is not mapped)
+//-----------------------------------------------------------------------------
+const Region_t* CRegionMap::Lookup(const Snapshot_t* pSnapshot, std::uintptr_t pAddress) const noexcept
+{
+	const auto& vecRegions = pSnapshot->m_vecRegions;
+
+	if (s_lastHit.m_nSerial == pSnapshot->m_nSerial)
+	{
+		const Region_t& region = vecRegions[s_lastHit.m_nIndex];
+
+		if (region.m_pBegin <= pAddress && pAddress < region.m_pEnd)
+			return &region;
+	}
+
+	auto it = std::upper_bound(vecRegions.cbegin(), vecRegions.cend(), pAddress, [](std::uintptr_t pValue, const Region_t& region) { return pValue < region.m_pEnd; });
+
+	if (it == vecRegions.cend() || pAddress < it->m_pBegin)
+		return nullptr;
+
+	s_lastHit = {pSnapshot->m_nSerial, static_cast<std::size_t>(it - vecRegions.cbegin())};
+
+	return &*it;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks the access of a range in a snapshot
+// Input  : pSnapshot
+//          pAddress
+//          nSize
+//          nFlags
+// Output : true if every byte has it
+//-----------------------------------------------------------------------------
+bool CRegionMap::CheckAccess(const Snapshot_t* pSnapshot, std::uintptr_t pAddress, std::size_t nSize, std::uint8_t nFlags) const noexcept
+{
+	const std::uintptr_t pEnd = pAddress + std::max<std::size_t>(nSize, 1);
+
+	if (pEnd < pAddress)
+		return false;
+
+	const Region_t* pRegion = Lookup(pSnapshot, pAddress);
+
+	if (!pRegion || (pRegion->m_nFlags & nFlags) != nFlags)
+		return false;
+
+	// A range may span several regions (with different access, since the same ones are merged).
+	const Region_t* pLast = pSnapshot->m_vecRegions.data() + pSnapshot->m_vecRegions.size();
+
+	for (; pRegion->m_pEnd < pEnd; ++pRegion)
+	{
+		if (pRegion + 1 == pLast || pRegion[1].m_pBegin != pRegion->m_pEnd || (pRegion[1].m_nFlags & nFlags) != nFlags)
+			return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Refreshes the map if a module was loaded or unloaded since the last build
+//-----------------------------------------------------------------------------
+void CRegionMap::RefreshOnModuleChange()
+{
+	if (m_nGeneration.load(std::memory_order_relaxed) != GetModuleGeneration())
+		Refresh();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Refreshes the map after a lookup miss, once per interval
+// Output : true if it was rebuilt
+//-----------------------------------------------------------------------------
+bool CRegionMap::RefreshOnMiss()
+{
+	const std::int64_t nInterval = m_nMissRefreshInterval.load(std::memory_order_relaxed);
+
+	if (nInterval <= 0 || GetTicks() - m_nLastRefresh.load(std::memory_order_relaxed) < nInterval)
+		return false;
+
+	return Refresh(true);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks the access of a memory range
+// Input  : pAddress
+//          nSize
+//          nFlags - Region_t::Flags_t
+// Output : true if every byte of the range has it
+//-----------------------------------------------------------------------------
+bool CRegionMap::HasAccess(const CMemory pAddress, std::size_t nSize, std::uint8_t nFlags)
+{
+	const auto pBegin = static_cast<std::uintptr_t>(pAddress.GetAddr());
+
+	if (!pBegin)
+		return false;
+
+	RefreshOnModuleChange();
+
+	{
+		CEpoch::CGuard guard;
+
+		if (CheckAccess(m_pSnapshot.load(std::memory_order_acquire), pBegin, nSize, nFlags))
+			return true;
+	}
+
+	if (!RefreshOnMiss())
+	{
+		// Within the interval: the range may have been mapped since the last build.
+		bool bAccess;
+
+		if (Probe(pBegin, nSize, nFlags, bAccess))
+			return bAccess;
+
+		Refresh(true);
+	}
+
+	CEpoch::CGuard guard;
+
+	return CheckAccess(m_pSnapshot.load(std::memory_order_acquire), pBegin, nSize, nFlags);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the region which contains an address
+// Input  : pAddress
+//          region
+// Output : false if it is not mapped
+//-----------------------------------------------------------------------------
+bool CRegionMap::FindRegion(const CMemory pAddress, Region_t& region)
+{
+	const auto p = static_cast<std::uintptr_t>(pAddress.GetAddr());
+
+	RefreshOnModuleChange();
+
+	for (int nAttempt = 0; nAttempt < 2; ++nAttempt)
+	{
+		{
+			CEpoch::CGuard guard;
+
+			if (const Region_t* pRegion = Lookup(m_pSnapshot.load(std::memory_order_acquire), p))
+			{
+				region = *pRegion;
+
+				return true;
+			}
+		}
+
+		if (nAttempt)
+			break;
+
+		if (!RefreshOnMiss())
+		{
+			// Within the interval: rebuild anyway if the address has been mapped since the last build.
+			bool bAccess;
+
+			if (Probe(p, 1, Region_t::Readable, bAccess) && !bAccess)
+				break;
+
+			Refresh(true);
+		}
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets a copy of the regions
+// Output : std::vector<Region_t>
+//-----------------------------------------------------------------------------
+std::vector<Region_t> CRegionMap::GetRegions()
+{
+	CEpoch::CGuard guard;
+
+	return m_pSnapshot.load(std::memory_order_acquire)->m_vecRegions;
+}
+
+bool DynLibUtils::IsMemoryReadable(std::uintptr_t pAddress, std::size_t nSize)
+{
+	return CRegionMap::Get().IsReadable(pAddress, nSize);
+}
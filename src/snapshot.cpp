@@ -0,0 +1,352 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/snapshot.hpp>
+#include <dynlibutils/regions.hpp>
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#	include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+using namespace DynLibUtils;
+
+static constexpr std::size_t s_nStepSize = 64; // Bytes compared at a time (a bit of a mask each).
+static constexpr std::size_t s_nCopyAlign = 64;
+
+static std::atomic<std::uint64_t> s_nDirtyGeneration {0}; // Of the last soft-dirty clear.
+
+// Returns the index of the lowest set bit (nMask must not be 0).
+static inline int CountTrailingZeros(std::uint64_t nMask) noexcept
+{
+#ifdef _MSC_VER
+	unsigned long nIndex;
+
+	_BitScanForward64(&nIndex, nMask);
+
+	return static_cast<int>(nIndex);
+#else
+	return __builtin_ctzll(nMask);
+#endif
+}
+
+// The changes found, merged while they are added in order.
+class CChangeCollector
+{
+public:
+	CChangeCollector(std::vector<DiffRange_t>& vecChanges, std::size_t nMergeGap) : m_vecChanges(vecChanges), m_nMergeGap(nMergeGap) {}
+
+	void Add(std::uintptr_t p, std::size_t nSize)
+	{
+		if (!m_vecChanges.empty())
+		{
+			DiffRange_t& last = m_vecChanges.back();
+
+			const auto pLast = static_cast<std::uintptr_t>(last.m_pBegin.GetAddr());
+
+			if (p - (pLast + last.m_nSize) <= m_nMergeGap)
+			{
+				last.m_nSize = p + nSize - pLast;
+
+				return;
+			}
+		}
+
+		m_vecChanges.push_back({p, nSize});
+	}
+
+	// Adds the runs of set bits of a mask of the 64 bytes at p.
+	void AddMask(std::uintptr_t p, std::uint64_t nChanged)
+	{
+		while (nChanged)
+		{
+			const int nBegin = CountTrailingZeros(nChanged);
+			const std::uint64_t nRest = ~(nChanged >> nBegin);
+			const int nEnd = nRest ? nBegin + CountTrailingZeros(nRest) : 64;
+
+			Add(p + nBegin, static_cast<std::size_t>(nEnd - nBegin));
+
+			nChanged = nEnd < 64 ? nChanged & (~static_cast<std::uint64_t>(0) << nEnd) : 0;
+		}
+	}
+
+private:
+	std::vector<DiffRange_t>& m_vecChanges;
+	std::size_t m_nMergeGap;
+}; // class CChangeCollector
+
+//-----------------------------------------------------------------------------
+// Purpose: Compares the live bytes with their copy with SSE2, 64 at a time
+// Input  : p - live
+//          pCopy
+//          nSteps
+//          collector
+//-----------------------------------------------------------------------------
+static void CompareSSE(std::uintptr_t p, const std::uint8_t* pCopy, std::size_t nSteps, CChangeCollector& collector)
+{
+	for (std::size_t n = 0; n < nSteps; ++n, p += s_nStepSize, pCopy += s_nStepSize)
+	{
+		std::uint64_t nEqual = 0;
+
+		for (std::size_t i = 0; i < 4; ++i)
+		{
+			const __m128i vLive = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * sizeof(__m128i)));
+			const __m128i vCopy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCopy + i * sizeof(__m128i)));
+
+			nEqual |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(vLive, vCopy)))) << (i * 16);
+		}
+
+		if (~nEqual)
+			collector.AddMask(p, ~nEqual);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Same as CompareSSE with AVX2
+//-----------------------------------------------------------------------------
+DYNLIB_TARGET_AVX2 static void CompareAVX2(std::uintptr_t p, const std::uint8_t* pCopy, std::size_t nSteps, CChangeCollector& collector)
+{
+	for (std::size_t n = 0; n < nSteps; ++n, p += s_nStepSize, pCopy += s_nStepSize)
+	{
+		const __m256i vEqual0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pCopy)));
+		const __m256i vEqual1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + sizeof(__m256i))), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pCopy + sizeof(__m256i))));
+
+		// The unchanged steps are told apart with one test.
+		if (_mm256_testc_si256(_mm256_and_si256(vEqual0, vEqual1), _mm256_set1_epi8(-1)))
+			continue;
+
+		const std::uint64_t nEqual = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(vEqual0))) |
+		                             static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(vEqual1))) << 32;
+
+		collector.AddMask(p, ~nEqual);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Compares a live span with its copy
+// Input  : p
+//          pEnd
+//          pCopy
+//          collector
+//-----------------------------------------------------------------------------
+static void CompareSpan(std::uintptr_t p, std::uintptr_t pEnd, const std::uint8_t* pCopy, CChangeCollector& collector)
+{
+	static const bool s_bAVX2 = IsAVX2Supported();
+
+	const std::size_t nSteps = (pEnd - p) / s_nStepSize;
+
+	if (s_bAVX2)
+		CompareAVX2(p, pCopy, nSteps, collector);
+	else
+		CompareSSE(p, pCopy, nSteps, collector);
+
+	p += nSteps * s_nStepSize;
+	pCopy += nSteps * s_nStepSize;
+
+	std::uint64_t nChanged = 0;
+
+	for (std::size_t n = 0; p + n < pEnd; ++n)
+	{
+		if (reinterpret_cast<const std::uint8_t*>(p)[n] != pCopy[n])
+			nChanged |= static_cast<std::uint64_t>(1) << n;
+	}
+
+	collector.AddMask(p, nChanged);
+}
+
+void CMemorySnapshot::AddRange(const CMemory pBegin, std::size_t nSize)
+{
+	if (nSize)
+		m_vecRanges.push_back({static_cast<std::uintptr_t>(pBegin.GetAddr()), static_cast<std::uintptr_t>(pBegin.GetAddr()) + nSize, 0, false});
+}
+
+void CMemorySnapshot::AddWritableRegions()
+{
+	CRegionMap& regions = CRegionMap::Get();
+
+	regions.Refresh(true);
+
+	for (const auto& region : regions.GetRegions())
+	{
+		if (region.IsReadable() && region.IsWritable())
+			AddRange(region.m_pBegin, region.m_pEnd - region.m_pBegin);
+	}
+}
+
+void CMemorySnapshot::Clear() noexcept
+{
+	m_vecRanges.clear();
+	m_pArena.reset();
+	m_nArenaSize = 0;
+	m_nCopiedSize = 0;
+	m_nDirtyGeneration = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Copies the ranges into the arena (clearing the soft-dirty bits
+//          first when tracking)
+// Output : std::size_t (the number of bytes copied)
+//-----------------------------------------------------------------------------
+std::size_t CMemorySnapshot::Take()
+{
+	// Sorted, merged ranges.
+	std::sort(m_vecRanges.begin(), m_vecRanges.end(), [](const Range_t& left, const Range_t& right) { return left.m_pBegin < right.m_pBegin; });
+
+	std::size_t nMerged = 0;
+
+	for (std::size_t n = 0; n < m_vecRanges.size(); )
+	{
+		Range_t range = m_vecRanges[n++];
+
+		while (n < m_vecRanges.size() && m_vecRanges[n].m_pBegin <= range.m_pEnd)
+			range.m_pEnd = std::max(range.m_pEnd, m_vecRanges[n++].m_pEnd);
+
+		m_vecRanges[nMerged++] = range;
+	}
+
+	m_vecRanges.resize(nMerged);
+
+	auto funcLayout = [this]()
+	{
+		std::size_t nSize = 0;
+
+		for (auto& range : m_vecRanges)
+		{
+			range.m_nOffset = nSize;
+			nSize += (range.m_pEnd - range.m_pBegin + s_nCopyAlign - 1) & ~(s_nCopyAlign - 1);
+		}
+
+		return nSize;
+	};
+
+	const std::size_t nArenaSize = funcLayout();
+
+	if (nArenaSize > m_nArenaSize)
+	{
+		m_pArena.reset();
+		m_pArena.reset(new std::uint8_t[nArenaSize]);
+		m_nArenaSize = nArenaSize;
+	}
+
+	// The arena is not copied into itself (the regions added after it was allocated contain it).
+	const auto pArena = reinterpret_cast<std::uintptr_t>(m_pArena.get()), pArenaEnd = pArena + m_nArenaSize;
+
+	auto it = std::find_if(m_vecRanges.begin(), m_vecRanges.end(), [&](const Range_t& range) { return range.m_pBegin < pArenaEnd && pArena < range.m_pEnd; });
+
+	if (it != m_vecRanges.end())
+	{
+		const Range_t range = *it;
+
+		it = m_vecRanges.erase(it);
+
+		if (pArenaEnd < range.m_pEnd)
+			it = m_vecRanges.insert(it, {pArenaEnd, range.m_pEnd, 0, false});
+
+		if (range.m_pBegin < pArena)
+			m_vecRanges.insert(it, {range.m_pBegin, pArena, 0, false});
+
+		funcLayout(); // Smaller than the arena, which was a part of the ranges.
+	}
+
+	m_nDirtyGeneration = 0;
+
+	// Cleared before copying, so the writes made meanwhile are seen dirty.
+	if (m_bTrackDirty && IsSoftDirtySupported() && ClearSoftDirty())
+		m_nDirtyGeneration = s_nDirtyGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	CRegionMap& regions = CRegionMap::Get();
+
+	regions.Refresh(true);
+
+	m_nCopiedSize = 0;
+
+	for (auto& range : m_vecRanges)
+	{
+		const std::size_t nSize = range.m_pEnd - range.m_pBegin;
+
+		range.m_bCopied = regions.IsReadable(range.m_pBegin, nSize);
+
+		if (!range.m_bCopied)
+			continue;
+
+		std::memcpy(m_pArena.get() + range.m_nOffset, reinterpret_cast<const void*>(range.m_pBegin), nSize);
+		m_nCopiedSize += nSize;
+	}
+
+	return m_nCopiedSize;
+}
+
+bool CMemorySnapshot::IsTrackingDirty() const noexcept
+{
+	return m_nDirtyGeneration && m_nDirtyGeneration == s_nDirtyGeneration.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Compares the ranges with their copies
+// Input  : nMergeGap
+// Output : std::vector<DiffRange_t> (sorted by address)
+//-----------------------------------------------------------------------------
+std::vector<DiffRange_t> CMemorySnapshot::Diff(std::size_t nMergeGap) const
+{
+	std::vector<DiffRange_t> vecChanges;
+
+	CChangeCollector collector(vecChanges, nMergeGap);
+
+	CRegionMap& regions = CRegionMap::Get();
+
+	regions.Refresh(true);
+
+	const bool bDirtyOnly = IsTrackingDirty();
+
+	std::vector<Span_t> vecSpans;
+
+	for (const auto& range : m_vecRanges)
+	{
+		if (!range.m_bCopied || !regions.IsReadable(range.m_pBegin, range.m_pEnd - range.m_pBegin))
+			continue;
+
+		const std::uint8_t* pCopy = m_pArena.get() + range.m_nOffset;
+
+		vecSpans.clear();
+
+		if (!bDirtyOnly || !CollectDirtySpans(range.m_pBegin, range.m_pEnd, vecSpans))
+		{
+			CompareSpan(range.m_pBegin, range.m_pEnd, pCopy, collector);
+
+			continue;
+		}
+
+		for (const auto& span : vecSpans)
+			CompareSpan(span.m_pBegin, span.m_pEnd, pCopy + (span.m_pBegin - range.m_pBegin), collector);
+	}
+
+	return vecChanges;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the copy of an address
+// Input  : pAddress
+// Output : CMemory
+//-----------------------------------------------------------------------------
+CMemory CMemorySnapshot::GetCopy(const CMemory pAddress) const
+{
+	const auto p = static_cast<std::uintptr_t>(pAddress.GetAddr());
+
+	auto it = std::upper_bound(m_vecRanges.cbegin(), m_vecRanges.cend(), p, [](std::uintptr_t pValue, const Range_t& range) { return pValue < range.m_pBegin; });
+
+	if (it == m_vecRanges.cbegin())
+		return DYNLIB_INVALID_MEMORY;
+
+	--it;
+
+	if (!it->m_bCopied || p >= it->m_pEnd)
+		return DYNLIB_INVALID_MEMORY;
+
+	return m_pArena.get() + it->m_nOffset + (p - it->m_pBegin);
+}
@@ -0,0 +1,184 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/strings.hpp>
+#include <dynlibutils/module.hpp>
+
+#include <emmintrin.h>
+
+#include <algorithm>
+
+using namespace DynLibUtils;
+
+static inline bool IsPrintable(std::uint8_t nByte) noexcept
+{
+	return (0x20 <= nByte && nByte < 0x7F) || nByte == '\t' || nByte == '\n' || nByte == '\r';
+}
+
+// Read-only data sections which hold literals (not the symbol names of .dynstr and the like).
+static bool IsStringSection(const std::string_view svName) noexcept
+{
+	for (const std::string_view svPrefix : {".rodata", ".rdata", "__cstring", "__const"})
+	{
+		if (svName.substr(0, svPrefix.size()) == svPrefix)
+			return true;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Collects the NUL-terminated printable runs of a memory range
+// Input  : pBegin
+//          pEnd
+//          nMinLength
+//          vecStrings
+//-----------------------------------------------------------------------------
+static void FindStrings(const char* pBegin, const char* pEnd, const std::size_t nMinLength, std::vector<std::string_view>& vecStrings)
+{
+	const char* pRun = pBegin; // Start of the current printable run.
+
+	// A run ends at the first non-printable byte; it is a string if that byte is a NUL.
+	auto funcBreak = [&](const char* pStop)
+	{
+		if (!*pStop && static_cast<std::size_t>(pStop - pRun) >= nMinLength)
+			vecStrings.emplace_back(pRun, pStop - pRun);
+
+		pRun = pStop + 1;
+	};
+
+	const char* p = pBegin;
+
+	const __m128i vLow = _mm_set1_epi8(0x1F), vHigh = _mm_set1_epi8(0x7F);
+	const __m128i vTab = _mm_set1_epi8('\t'), vLF = _mm_set1_epi8('\n'), vCR = _mm_set1_epi8('\r');
+
+	for (; p + sizeof(__m128i) <= pEnd; p += sizeof(__m128i))
+	{
+		const __m128i vBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		// Signed compares: the bytes from 0x80 are negative, so out of [0x20, 0x7E].
+		const __m128i vPrintable = _mm_or_si128(_mm_and_si128(_mm_cmpgt_epi8(vBytes, vLow), _mm_cmplt_epi8(vBytes, vHigh)),
+		                                        _mm_or_si128(_mm_cmpeq_epi8(vBytes, vTab), _mm_or_si128(_mm_cmpeq_epi8(vBytes, vLF), _mm_cmpeq_epi8(vBytes, vCR))));
+
+		auto nBreaks = static_cast<unsigned int>(~_mm_movemask_epi8(vPrintable)) & 0xFFFF;
+
+		for (int nBit = 0; nBreaks; ++nBit, nBreaks >>= 1)
+		{
+			if (nBreaks & 1)
+				funcBreak(p + nBit);
+		}
+	}
+
+	for (; p < pEnd; ++p)
+	{
+		if (!IsPrintable(static_cast<std::uint8_t>(*p)))
+			funcBreak(p);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Builds the index once
+//-----------------------------------------------------------------------------
+void CStringIndex::Build() const
+{
+	std::call_once(m_built, [this]()
+	{
+		for (const auto& section : m_pModule->GetSections())
+		{
+			if (!(section.m_nFlags & Section_t::Readable) || section.IsWritable() || section.IsExecutable() || !IsStringSection(section.m_svSectionName))
+				continue;
+
+			const auto* pBegin = section.RCast<const char*>();
+
+			FindStrings(pBegin, pBegin + section.m_nSectionSize, m_nMinLength, m_vecStrings);
+		}
+
+		std::sort(m_vecStrings.begin(), m_vecStrings.end(), [](const std::string_view& left, const std::string_view& right) { return left.data() < right.data(); });
+
+		m_vecSorted.resize(m_vecStrings.size());
+		m_mapExact.reserve(m_vecStrings.size());
+
+		for (std::uint32_t n = 0; n < m_vecStrings.size(); ++n)
+		{
+			m_vecSorted[n] = n;
+			m_mapExact.emplace(m_vecStrings[n], n); // Keeps the lowest index.
+		}
+
+		std::stable_sort(m_vecSorted.begin(), m_vecSorted.end(), [this](std::uint32_t left, std::uint32_t right) { return m_vecStrings[left] < m_vecStrings[right]; });
+	});
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds a string
+// Input  : svString
+// Output : CMemory
+//-----------------------------------------------------------------------------
+CMemory CStringIndex::Find(const std::string_view svString) const
+{
+	Build();
+
+	auto it = m_mapExact.find(svString);
+
+	return it != m_mapExact.cend() ? CMemory(const_cast<char*>(m_vecStrings[it->second].data())) : DYNLIB_INVALID_MEMORY;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds every copy of a string
+// Input  : svString
+// Output : std::vector<CMemory>
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CStringIndex::FindAll(const std::string_view svString) const
+{
+	Build();
+
+	std::vector<CMemory> vecResult;
+
+	auto it = std::lower_bound(m_vecSorted.cbegin(), m_vecSorted.cend(), svString, [this](std::uint32_t n, const std::string_view& svValue) { return m_vecStrings[n] < svValue; });
+
+	for (; it != m_vecSorted.cend() && m_vecStrings[*it] == svString; ++it)
+		vecResult.emplace_back(const_cast<char*>(m_vecStrings[*it].data())); // Equal strings keep the address order.
+
+	return vecResult;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the strings which start with a prefix
+// Input  : svPrefix
+// Output : std::vector<CMemory>
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CStringIndex::FindByPrefix(const std::string_view svPrefix) const
+{
+	Build();
+
+	std::vector<CMemory> vecResult;
+
+	auto it = std::lower_bound(m_vecSorted.cbegin(), m_vecSorted.cend(), svPrefix, [this](std::uint32_t n, const std::string_view& svValue) { return m_vecStrings[n] < svValue; });
+
+	for (; it != m_vecSorted.cend() && m_vecStrings[*it].substr(0, svPrefix.size()) == svPrefix; ++it)
+		vecResult.emplace_back(const_cast<char*>(m_vecStrings[*it].data()));
+
+	std::sort(vecResult.begin(), vecResult.end());
+
+	return vecResult;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the strings which contain a substring
+// Input  : svSubstring
+// Output : std::vector<CMemory>
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CStringIndex::FindBySubstring(const std::string_view svSubstring) const
+{
+	Build();
+
+	std::vector<CMemory> vecResult;
+
+	for (const auto& svString : m_vecStrings)
+	{
+		if (svString.find(svSubstring) != std::string_view::npos)
+			vecResult.emplace_back(const_cast<char*>(svString.data()));
+	}
+
+	return vecResult;
+}
@@ -0,0 +1,706 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/valuescan.hpp>
+#include <dynlibutils/module.hpp>
+#include <dynlibutils/regions.hpp>
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#	include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace DynLibUtils;
+
+static constexpr std::uintptr_t s_nBlockSize = 1 << 20; // Bytes of memory a block covers at most.
+static constexpr std::uint32_t s_nWordBits = 64;
+
+// Returns the index of the lowest set bit (nMask must not be 0).
+static inline int CountTrailingZeros(std::uint64_t nMask) noexcept
+{
+#ifdef _MSC_VER
+	unsigned long nIndex;
+
+	_BitScanForward64(&nIndex, nMask);
+
+	return static_cast<int>(nIndex);
+#else
+	return __builtin_ctzll(nMask);
+#endif
+}
+
+static inline std::uint32_t PopCount(std::uint64_t nMask) noexcept
+{
+#ifdef _MSC_VER
+	return static_cast<std::uint32_t>(__popcnt64(nMask));
+#else
+	return static_cast<std::uint32_t>(__builtin_popcountll(nMask));
+#endif
+}
+
+// _mm_cmpgt_epi64 with SSE2 (it is SSE4.2): the high dwords compared signed, the low ones unsigned on a tie.
+static inline __m128i CompareGreaterEpi64(__m128i vA, __m128i vB) noexcept
+{
+	const __m128i vLowSign = _mm_set_epi32(0, static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000));
+
+	vA = _mm_xor_si128(vA, vLowSign);
+	vB = _mm_xor_si128(vB, vLowSign);
+
+	const __m128i vGreater = _mm_cmpgt_epi32(vA, vB);
+	const __m128i vResult = _mm_or_si128(vGreater, _mm_and_si128(_mm_cmpeq_epi32(vA, vB), _mm_slli_epi64(vGreater, 32)));
+
+	return _mm_shuffle_epi32(vResult, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+// The SIMD compares of the values at p with [low, high], which return a bit per lane (kLanes values).
+template<typename T> struct CompareSSE_t;
+template<typename T> struct CompareAVX2_t;
+
+template<>
+struct CompareSSE_t<std::int32_t>
+{
+	static constexpr std::uint32_t kLanes = 4;
+
+	CompareSSE_t(std::int32_t nLow, std::int32_t nHigh) : m_vLow(_mm_set1_epi32(nLow)), m_vHigh(_mm_set1_epi32(nHigh)) {}
+
+	std::uint32_t operator()(const std::uint8_t* p) const
+	{
+		const __m128i vValues = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_cmpgt_epi32(m_vLow, vValues), _mm_cmpgt_epi32(vValues, m_vHigh))))) ^ 0xF;
+	}
+
+	__m128i m_vLow, m_vHigh;
+};
+
+template<>
+struct CompareSSE_t<std::int64_t>
+{
+	static constexpr std::uint32_t kLanes = 2;
+
+	CompareSSE_t(std::int64_t nLow, std::int64_t nHigh) : m_vLow(_mm_set1_epi64x(nLow)), m_vHigh(_mm_set1_epi64x(nHigh)) {}
+
+	std::uint32_t operator()(const std::uint8_t* p) const
+	{
+		const __m128i vValues = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		return static_cast<std::uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(CompareGreaterEpi64(m_vLow, vValues), CompareGreaterEpi64(vValues, m_vHigh))))) ^ 0x3;
+	}
+
+	__m128i m_vLow, m_vHigh;
+};
+
+template<>
+struct CompareSSE_t<float>
+{
+	static constexpr std::uint32_t kLanes = 4;
+
+	CompareSSE_t(float flLow, float flHigh) : m_vLow(_mm_set1_ps(flLow)), m_vHigh(_mm_set1_ps(flHigh)) {}
+
+	std::uint32_t operator()(const std::uint8_t* p) const
+	{
+		const __m128 vValues = _mm_loadu_ps(reinterpret_cast<const float*>(p));
+
+		return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(vValues, m_vLow), _mm_cmple_ps(vValues, m_vHigh))));
+	}
+
+	__m128 m_vLow, m_vHigh;
+};
+
+template<>
+struct CompareSSE_t<double>
+{
+	static constexpr std::uint32_t kLanes = 2;
+
+	CompareSSE_t(double flLow, double flHigh) : m_vLow(_mm_set1_pd(flLow)), m_vHigh(_mm_set1_pd(flHigh)) {}
+
+	std::uint32_t operator()(const std::uint8_t* p) const
+	{
+		const __m128d vValues = _mm_loadu_pd(reinterpret_cast<const double*>(p));
+
+		return static_cast<std::uint32_t>(_mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(vValues, m_vLow), _mm_cmple_pd(vValues, m_vHigh))));
+	}
+
+	__m128d m_vLow, m_vHigh;
+};
+
+template<>
+struct CompareAVX2_t<std::int32_t>
+{
+	static constexpr std::uint32_t kLanes = 8;
+
+	DYNLIB_TARGET_AVX2 CompareAVX2_t(std::int32_t nLow, std::int32_t nHigh) : m_vLow(_mm256_set1_epi32(nLow)), m_vHigh(_mm256_set1_epi32(nHigh)) {}
+
+	DYNLIB_TARGET_AVX2 std::uint32_t operator()(const std::uint8_t* p) const
+	{
+		const __m256i vValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+
+		return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpgt_epi32(m_vLow, vValues), _mm256_cmpgt_epi32(vValues, m_vHigh))))) ^ 0xFF;
+	}
+
+	__m256i m_vLow, m_vHigh;
+};
+
+template<>
+struct CompareAVX2_t<std::int64_t>
+{
+	static constexpr std::uint32_t kLanes = 4;
+
+	DYNLIB_TARGET_AVX2 CompareAVX2_t(std::int64_t nLow, std::int64_t nHigh) : m_vLow(_mm256_set1_epi64x(nLow)), m_vHigh(_mm256_set1_epi64x(nHigh)) {}
+
+	DYNLIB_TARGET_AVX2 std::uint32_t operator()(const std::uint8_t* p) const
+	{
+		const __m256i vValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+
+		return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_cmpgt_epi64(m_vLow, vValues), _mm256_cmpgt_epi64(vValues, m_vHigh))))) ^ 0xF;
+	}
+
+	__m256i m_vLow, m_vHigh;
+};
+
+template<>
+struct CompareAVX2_t<float>
+{
+	static constexpr std::uint32_t kLanes = 8;
+
+	DYNLIB_TARGET_AVX2 CompareAVX2_t(float flLow, float flHigh) : m_vLow(_mm256_set1_ps(flLow)), m_vHigh(_mm256_set1_ps(flHigh)) {}
+
+	DYNLIB_TARGET_AVX2 std::uint32_t operator()(const std::uint8_t* p) const
+	{
+		const __m256 vValues = _mm256_loadu_ps(reinterpret_cast<const float*>(p));
+
+		return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(vValues, m_vLow, _CMP_GE_OQ), _mm256_cmp_ps(vValues, m_vHigh, _CMP_LE_OQ))));
+	}
+
+	__m256 m_vLow, m_vHigh;
+};
+
+template<>
+struct CompareAVX2_t<double>
+{
+	static constexpr std::uint32_t kLanes = 4;
+
+	DYNLIB_TARGET_AVX2 CompareAVX2_t(double flLow, double flHigh) : m_vLow(_mm256_set1_pd(flLow)), m_vHigh(_mm256_set1_pd(flHigh)) {}
+
+	DYNLIB_TARGET_AVX2 std::uint32_t operator()(const std::uint8_t* p) const
+	{
+		const __m256d vValues = _mm256_loadu_pd(reinterpret_cast<const double*>(p));
+
+		return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(vValues, m_vLow, _CMP_GE_OQ), _mm256_cmp_pd(vValues, m_vHigh, _CMP_LE_OQ))));
+	}
+
+	__m256d m_vLow, m_vHigh;
+};
+
+//-----------------------------------------------------------------------------
+// Purpose: Masks the words of a bitmap with the compare of their 64 values
+//          with SSE2 (the null words are skipped)
+// Input  : p - the values of the first word
+//          pWords
+//          nWords
+//          low
+//          high
+//-----------------------------------------------------------------------------
+template<typename T>
+static void CompareWordsSSE(const std::uint8_t* p, std::uint64_t* pWords, std::size_t nWords, T low, T high)
+{
+	using Compare_t = CompareSSE_t<T>;
+
+	const Compare_t compare(low, high);
+
+	for (std::size_t n = 0; n < nWords; ++n, p += s_nWordBits * sizeof(T))
+	{
+		if (!pWords[n])
+			continue;
+
+		std::uint64_t nMask = 0;
+
+		for (std::uint32_t i = 0; i < s_nWordBits; i += Compare_t::kLanes)
+			nMask |= static_cast<std::uint64_t>(compare(p + i * sizeof(T))) << i;
+
+		pWords[n] &= nMask;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Same as CompareWordsSSE with AVX2
+//-----------------------------------------------------------------------------
+template<typename T>
+DYNLIB_TARGET_AVX2 static void CompareWordsAVX2(const std::uint8_t* p, std::uint64_t* pWords, std::size_t nWords, T low, T high)
+{
+	using Compare_t = CompareAVX2_t<T>;
+
+	const Compare_t compare(low, high);
+
+	for (std::size_t n = 0; n < nWords; ++n, p += s_nWordBits * sizeof(T))
+	{
+		if (!pWords[n])
+			continue;
+
+		std::uint64_t nMask = 0;
+
+		for (std::uint32_t i = 0; i < s_nWordBits; i += Compare_t::kLanes)
+			nMask |= static_cast<std::uint64_t>(compare(p + i * sizeof(T))) << i;
+
+		pWords[n] &= nMask;
+	}
+}
+
+template<typename T>
+static inline T LoadValue(std::uintptr_t p) noexcept
+{
+	return *reinterpret_cast<const T*>(p);
+}
+
+template<typename T>
+static inline bool IsBetween(T value, T low, T high) noexcept
+{
+	return low <= value && value <= high; // False for a NaN, as the SIMD compares.
+}
+
+template<typename T>
+static inline bool IsMatching(T value, T previous, CValueScanner::Compare_t eCompare) noexcept
+{
+	switch (eCompare)
+	{
+		case CValueScanner::Changed:
+			return std::memcmp(&value, &previous, sizeof(T)) != 0; // Bitwise, so a NaN does not change by itself.
+
+		case CValueScanner::Unchanged:
+			return std::memcmp(&value, &previous, sizeof(T)) == 0;
+
+		case CValueScanner::Increased:
+			return value > previous;
+
+		case CValueScanner::Decreased:
+			return value < previous;
+	}
+
+	return false;
+}
+
+template<typename T>
+static inline T GetValue(const CValueScanner::Value_t& value) noexcept
+{
+	if constexpr (std::is_same_v<T, std::int32_t>)
+		return value.m_nInt32;
+	else if constexpr (std::is_same_v<T, std::int64_t>)
+		return value.m_nInt64;
+	else if constexpr (std::is_same_v<T, float>)
+		return value.m_flFloat;
+	else
+		return value.m_flDouble;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Runs tasks on the worker threads
+// Input  : nThreads - 0 is the hardware concurrency
+//          nTasks
+//          funcTask - called with the indices of the tasks, in any order
+//-----------------------------------------------------------------------------
+template<typename F>
+static void RunTasks(std::size_t nThreads, std::size_t nTasks, const F& funcTask)
+{
+	std::atomic<std::size_t> nNextTask {0};
+
+	auto funcWorker = [&]()
+	{
+		for (std::size_t n; (n = nNextTask.fetch_add(1, std::memory_order_relaxed)) < nTasks; )
+			funcTask(n);
+	};
+
+	nThreads = std::min(nThreads ? nThreads : std::max(1u, std::thread::hardware_concurrency()), nTasks);
+
+	std::vector<std::thread> vecThreads;
+
+	if (nThreads > 1)
+		vecThreads.reserve(nThreads - 1);
+
+	for (std::size_t n = 1; n < nThreads; ++n)
+		vecThreads.emplace_back(funcWorker);
+
+	funcWorker();
+
+	for (auto& thread : vecThreads)
+		thread.join();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Counts the candidates of a bitmap block and reads their values
+// Input  : block
+//-----------------------------------------------------------------------------
+template<typename T>
+void CValueScanner::StoreBitmap(Block_t& block)
+{
+	std::uint32_t nCount = 0;
+
+	for (const auto nWord : block.m_vecBitmap)
+		nCount += PopCount(nWord);
+
+	block.m_nCount = nCount;
+	block.m_vecValues.resize((nCount * sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+
+	T* pValues = reinterpret_cast<T*>(block.m_vecValues.data());
+
+	for (std::size_t n = 0; n < block.m_vecBitmap.size(); ++n)
+	{
+		const std::uintptr_t p = block.m_pBase + n * s_nWordBits * sizeof(T);
+		const std::uint64_t nWord = block.m_vecBitmap[n];
+
+		if (nWord == ~static_cast<std::uint64_t>(0))
+		{
+			std::memcpy(pValues, reinterpret_cast<const void*>(p), s_nWordBits * sizeof(T));
+			pValues += s_nWordBits;
+
+			continue;
+		}
+
+		for (std::uint64_t nBits = nWord; nBits; nBits &= nBits - 1)
+			*pValues++ = LoadValue<T>(p + CountTrailingZeros(nBits) * sizeof(T));
+	}
+
+	Repack<T>(block);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Keeps the candidates of a block as a bitmap while they are dense
+//          (at least one in 32 elements), else as an array of their indices
+// Input  : block - with its candidates and values up to date
+//-----------------------------------------------------------------------------
+template<typename T>
+void CValueScanner::Repack(Block_t& block)
+{
+	if (!block.m_nCount)
+	{
+		block.m_vecBitmap = {};
+		block.m_vecIndices = {};
+		block.m_vecValues = {};
+
+		return;
+	}
+
+	const bool bDense = static_cast<std::uint64_t>(block.m_nCount) * 32 >= block.m_nElements;
+
+	if (bDense && block.m_vecBitmap.empty())
+	{
+		block.m_vecBitmap.assign((block.m_nElements + s_nWordBits - 1) / s_nWordBits, 0);
+
+		for (const auto nIndex : block.m_vecIndices)
+			block.m_vecBitmap[nIndex / s_nWordBits] |= static_cast<std::uint64_t>(1) << (nIndex % s_nWordBits);
+
+		block.m_vecIndices = {};
+	}
+	else if (!bDense && !block.m_vecBitmap.empty())
+	{
+		block.m_vecIndices.clear();
+		block.m_vecIndices.reserve(block.m_nCount);
+
+		for (std::size_t n = 0; n < block.m_vecBitmap.size(); ++n)
+		{
+			for (std::uint64_t nBits = block.m_vecBitmap[n]; nBits; nBits &= nBits - 1)
+				block.m_vecIndices.push_back(static_cast<std::uint32_t>(n * s_nWordBits + CountTrailingZeros(nBits)));
+		}
+
+		block.m_vecBitmap = {};
+	}
+	else if (!bDense)
+	{
+		block.m_vecIndices.shrink_to_fit();
+	}
+
+	block.m_vecValues.resize((block.m_nCount * sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+	block.m_vecValues.shrink_to_fit();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Passes a block
+// Input  : block
+//          ePass
+//          low
+//          high
+//          eCompare
+//-----------------------------------------------------------------------------
+template<typename T>
+void CValueScanner::ScanBlock(Block_t& block, Pass_t ePass, T low, T high, Compare_t eCompare)
+{
+	static const bool s_bAVX2 = IsAVX2Supported();
+
+	const std::uintptr_t pBase = block.m_pBase;
+
+	if (!CRegionMap::Get().IsReadable(pBase, block.m_nElements * sizeof(T)))
+	{
+		block.m_nCount = 0;
+		Repack<T>(block);
+
+		return;
+	}
+
+	if (ePass == FirstBetween || ePass == FirstAny)
+	{
+		block.m_vecBitmap.assign((block.m_nElements + s_nWordBits - 1) / s_nWordBits, ~static_cast<std::uint64_t>(0));
+
+		if (const std::uint32_t nRest = block.m_nElements % s_nWordBits)
+			block.m_vecBitmap.back() = (static_cast<std::uint64_t>(1) << nRest) - 1;
+
+		if (ePass == FirstAny)
+		{
+			StoreBitmap<T>(block);
+
+			return;
+		}
+	}
+
+	// The dense blocks compared with a range: SIMD over the words which have candidates.
+	if (ePass != NextCompare && !block.m_vecBitmap.empty())
+	{
+		const std::size_t nFullWords = block.m_nElements / s_nWordBits;
+		const auto* p = reinterpret_cast<const std::uint8_t*>(pBase);
+
+		if (s_bAVX2)
+			CompareWordsAVX2<T>(p, block.m_vecBitmap.data(), nFullWords, low, high);
+		else
+			CompareWordsSSE<T>(p, block.m_vecBitmap.data(), nFullWords, low, high);
+
+		if (nFullWords < block.m_vecBitmap.size())
+		{
+			std::uint64_t& nWord = block.m_vecBitmap.back();
+
+			for (std::uint64_t nBits = nWord; nBits; nBits &= nBits - 1)
+			{
+				const int nBit = CountTrailingZeros(nBits);
+
+				if (!IsBetween(LoadValue<T>(pBase + (nFullWords * s_nWordBits + nBit) * sizeof(T)), low, high))
+					nWord &= ~(static_cast<std::uint64_t>(1) << nBit);
+			}
+		}
+
+		StoreBitmap<T>(block);
+
+		return;
+	}
+
+	// One candidate at a time, compacting the values in place.
+	T* pValues = reinterpret_cast<T*>(block.m_vecValues.data());
+	std::uint32_t nKept = 0, nNth = 0;
+
+	auto funcKeep = [&](std::uint32_t nIndex)
+	{
+		const T value = LoadValue<T>(pBase + nIndex * sizeof(T));
+		const bool bKeep = ePass == NextBetween ? IsBetween(value, low, high) : IsMatching(value, pValues[nNth], eCompare);
+
+		nNth++;
+
+		if (bKeep)
+			pValues[nKept++] = value;
+
+		return bKeep;
+	};
+
+	if (block.m_vecBitmap.empty())
+	{
+		std::uint32_t nIndices = 0;
+
+		for (const auto nIndex : block.m_vecIndices)
+		{
+			if (funcKeep(nIndex))
+				block.m_vecIndices[nIndices++] = nIndex;
+		}
+
+		block.m_vecIndices.resize(nIndices);
+	}
+	else
+	{
+		for (std::size_t n = 0; n < block.m_vecBitmap.size(); ++n)
+		{
+			std::uint64_t& nWord = block.m_vecBitmap[n];
+
+			for (std::uint64_t nBits = nWord; nBits; nBits &= nBits - 1)
+			{
+				const int nBit = CountTrailingZeros(nBits);
+
+				if (!funcKeep(static_cast<std::uint32_t>(n * s_nWordBits + nBit)))
+					nWord &= ~(static_cast<std::uint64_t>(1) << nBit);
+			}
+		}
+	}
+
+	block.m_nCount = nKept;
+	Repack<T>(block);
+}
+
+void CValueScanner::AddModule(const CModule& module)
+{
+	for (const auto& section : module.GetSections())
+	{
+		if ((section.m_nFlags & Section_t::Readable) && section.IsWritable())
+			AddRange(section, section.m_nSectionSize);
+	}
+}
+
+void CValueScanner::AddWritableRegions()
+{
+	CRegionMap& regions = CRegionMap::Get();
+
+	regions.Refresh(true);
+
+	for (const auto& region : regions.GetRegions())
+	{
+		if (region.IsReadable() && region.IsWritable())
+			AddRange(region.m_pBegin, region.m_pEnd - region.m_pBegin);
+	}
+}
+
+void CValueScanner::AddRange(const CMemory pBegin, std::size_t nSize)
+{
+	if (nSize)
+		m_vecRanges.push_back({static_cast<std::uintptr_t>(pBegin.GetAddr()), static_cast<std::uintptr_t>(pBegin.GetAddr()) + nSize});
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Cuts the ranges into blocks and passes them first
+// Input  : eType
+//          low
+//          high
+//          bAny - takes every value (an unknown initial value)
+// Output : std::size_t (the number of candidates)
+//-----------------------------------------------------------------------------
+std::size_t CValueScanner::First(Type_t eType, Value_t low, Value_t high, bool bAny)
+{
+	static constexpr std::uintptr_t s_aSizes[] = {sizeof(std::int32_t), sizeof(std::int64_t), sizeof(float), sizeof(double)};
+
+	const std::uintptr_t nSize = s_aSizes[eType];
+
+	m_eType = eType;
+	m_vecBlocks.clear();
+	m_nCount = 0;
+
+	std::vector<Range_t> vecRanges = m_vecRanges;
+
+	std::sort(vecRanges.begin(), vecRanges.end(), [](const Range_t& left, const Range_t& right) { return left.m_pBegin < right.m_pBegin; });
+
+	for (std::size_t n = 0; n < vecRanges.size(); )
+	{
+		Range_t range = vecRanges[n++];
+
+		while (n < vecRanges.size() && vecRanges[n].m_pBegin <= range.m_pEnd)
+			range.m_pEnd = std::max(range.m_pEnd, vecRanges[n++].m_pEnd);
+
+		// The blocks end at multiples of their size, so no aligned value straddles two of them.
+		for (std::uintptr_t p = range.m_pBegin, pNext; p < range.m_pEnd; p = pNext)
+		{
+			pNext = std::min((p & ~(s_nBlockSize - 1)) + s_nBlockSize, range.m_pEnd);
+
+			const std::uintptr_t pBase = (p + nSize - 1) & ~(nSize - 1);
+
+			if (pBase < pNext && (pNext - pBase) / nSize)
+			{
+				Block_t block {};
+
+				block.m_pBase = pBase;
+				block.m_nElements = static_cast<std::uint32_t>((pNext - pBase) / nSize);
+				m_vecBlocks.push_back(std::move(block));
+			}
+		}
+	}
+
+	return Run(bAny ? FirstAny : FirstBetween, low, high, Changed);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Passes every block with the worker threads
+// Input  : ePass
+//          low
+//          high
+//          eCompare
+// Output : std::size_t (the number of candidates)
+//-----------------------------------------------------------------------------
+std::size_t CValueScanner::Run(Pass_t ePass, Value_t low, Value_t high, Compare_t eCompare)
+{
+	if (m_vecBlocks.empty())
+		return m_nCount = 0;
+
+	CRegionMap::Get().Refresh(true); // The memory changed since the last pass.
+
+	RunTasks(m_nThreads, m_vecBlocks.size(), [&](std::size_t n)
+	{
+		Block_t& block = m_vecBlocks[n];
+
+		switch (m_eType)
+		{
+			case Int32:
+				ScanBlock<std::int32_t>(block, ePass, GetValue<std::int32_t>(low), GetValue<std::int32_t>(high), eCompare);
+				break;
+
+			case Int64:
+				ScanBlock<std::int64_t>(block, ePass, GetValue<std::int64_t>(low), GetValue<std::int64_t>(high), eCompare);
+				break;
+
+			case Float:
+				ScanBlock<float>(block, ePass, GetValue<float>(low), GetValue<float>(high), eCompare);
+				break;
+
+			case Double:
+				ScanBlock<double>(block, ePass, GetValue<double>(low), GetValue<double>(high), eCompare);
+				break;
+		}
+	});
+
+	m_vecBlocks.erase(std::remove_if(m_vecBlocks.begin(), m_vecBlocks.end(), [](const Block_t& block) { return !block.m_nCount; }), m_vecBlocks.end());
+
+	m_nCount = 0;
+
+	for (const auto& block : m_vecBlocks)
+		m_nCount += block.m_nCount;
+
+	return m_nCount;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the addresses of the candidates
+// Input  : nMax
+// Output : std::vector<CMemory> (sorted)
+//-----------------------------------------------------------------------------
+std::vector<CMemory> CValueScanner::GetCandidates(std::size_t nMax) const
+{
+	const std::uintptr_t nSize = (m_eType == Int32 || m_eType == Float) ? 4 : 8;
+
+	std::vector<CMemory> vecResult;
+
+	vecResult.reserve(std::min(nMax, m_nCount));
+
+	for (const auto& block : m_vecBlocks)
+	{
+		if (block.m_vecBitmap.empty())
+		{
+			for (const auto nIndex : block.m_vecIndices)
+			{
+				if (vecResult.size() == nMax)
+					return vecResult;
+
+				vecResult.emplace_back(block.m_pBase + nIndex * nSize);
+			}
+
+			continue;
+		}
+
+		for (std::size_t n = 0; n < block.m_vecBitmap.size(); ++n)
+		{
+			for (std::uint64_t nBits = block.m_vecBitmap[n]; nBits; nBits &= nBits - 1)
+			{
+				if (vecResult.size() == nMax)
+					return vecResult;
+
+				vecResult.emplace_back(block.m_pBase + (n * s_nWordBits + CountTrailingZeros(nBits)) * nSize);
+			}
+		}
+	}
+
+	return vecResult;
+}
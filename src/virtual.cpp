@@ -0,0 +1,190 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/virtual.hpp>
+#include <dynlibutils/epoch.hpp>
+#include <dynlibutils/flatmap.hpp>
+
+#ifndef _MSC_VER
+#	include <cxxabi.h>
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+using namespace DynLibUtils;
+
+// The cache and its records are never destroyed: callers keep the pointers.
+static CAtomicFlatMap<ClassInfo_t>& GetClassInfoCache()
+{
+	static auto* s_pCache = new CAtomicFlatMap<ClassInfo_t>();
+
+	return *s_pCache;
+}
+
+// Reads a NUL-terminated name of the RTTI, at most nMaxLength chars.
+static bool ReadName(const char* pName, std::string& sName, std::size_t nMaxLength = 4096)
+{
+	for (std::size_t n = 0; n < nMaxLength; ++n)
+	{
+		// A check per page the name enters.
+		if ((!n || !(reinterpret_cast<std::uintptr_t>(pName + n) & 0xFFF)) && !IsMemoryReadable(reinterpret_cast<std::uintptr_t>(pName + n), 1))
+			return false;
+
+		if (!pName[n])
+		{
+			sName.assign(pName, n);
+
+			return n != 0;
+		}
+	}
+
+	return false;
+}
+
+#ifdef _MSC_VER
+// ".?AVName@Inner@Outer@@" -> "Outer::Inner::Name" (templates and other special names are kept decorated).
+static std::string Undecorate(const std::string& sDecorated)
+{
+	if (sDecorated.size() < 6 || sDecorated.compare(0, 3, ".?A") || sDecorated.compare(sDecorated.size() - 2, 2, "@@") || sDecorated.find_first_of("?$", 4) != std::string::npos)
+		return sDecorated;
+
+	std::string sName;
+
+	for (std::size_t nEnd = sDecorated.size() - 2, nBegin; nEnd > 4; nEnd = nBegin - 1)
+	{
+		nBegin = sDecorated.rfind('@', nEnd - 1);
+		nBegin = (nBegin == std::string::npos || nBegin < 4) ? 4 : nBegin + 1;
+
+		if (!sName.empty())
+			sName += "::";
+
+		sName.append(sDecorated, nBegin, nEnd - nBegin);
+
+		if (nBegin == 4)
+			break;
+	}
+
+	return sName;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads the RTTI of a vtable
+// Input  : ppVTable
+//          info
+// Output : false if it has no readable RTTI
+//-----------------------------------------------------------------------------
+static bool ReadClassInfo(void* const* ppVTable, ClassInfo_t& info)
+{
+	if (!IsMemoryReadable(reinterpret_cast<std::uintptr_t>(ppVTable) - DYNLIB_VTABLE_PREFIX_SIZE * sizeof(void*), DYNLIB_VTABLE_PREFIX_SIZE * sizeof(void*)))
+		return false;
+
+#ifdef _MSC_VER
+	// The Complete Object Locator: signature (1 on x64), offset of the vptr, constructor displacement offset, then the RVAs of the type descriptor, class hierarchy and itself.
+	struct CompleteObjectLocator_t
+	{
+		std::uint32_t m_nSignature;
+		std::uint32_t m_nOffset;
+		std::uint32_t m_nCDOffset;
+		std::int32_t m_nTypeDescriptor;
+		std::int32_t m_nClassDescriptor;
+		std::int32_t m_nSelf;
+	};
+
+	const auto* pLocator = static_cast<const CompleteObjectLocator_t*>(ppVTable[-1]);
+
+	if (!IsMemoryReadable(reinterpret_cast<std::uintptr_t>(pLocator), sizeof(CompleteObjectLocator_t)) || pLocator->m_nSignature != 1)
+		return false;
+
+	const std::uintptr_t pImageBase = reinterpret_cast<std::uintptr_t>(pLocator) - pLocator->m_nSelf;
+	const std::uintptr_t pTypeDescriptor = pImageBase + pLocator->m_nTypeDescriptor;
+
+	// The type descriptor: the type_info vptr, a spare pointer, then the decorated name.
+	if (!ReadName(reinterpret_cast<const char*>(pTypeDescriptor + 2 * sizeof(void*)), info.m_sDecoratedName))
+		return false;
+
+	info.m_pTypeInfo = reinterpret_cast<const void*>(pTypeDescriptor);
+	info.m_nOffsetToTop = -static_cast<std::ptrdiff_t>(pLocator->m_nOffset);
+	info.m_sName = Undecorate(info.m_sDecoratedName);
+#else
+	// std::type_info: its own vptr, then the mangled name (starting with '*' when it is compared by address).
+	const auto* pTypeInfo = static_cast<void* const*>(ppVTable[-1]);
+
+	if (!IsMemoryReadable(reinterpret_cast<std::uintptr_t>(pTypeInfo), 2 * sizeof(void*)))
+		return false;
+
+	const auto* pName = static_cast<const char*>(pTypeInfo[1]);
+
+	if (!ReadName(pName, info.m_sDecoratedName))
+		return false;
+
+	if (info.m_sDecoratedName[0] == '*')
+		info.m_sDecoratedName.erase(0, 1);
+
+	info.m_pTypeInfo = pTypeInfo;
+	info.m_nOffsetToTop = reinterpret_cast<std::ptrdiff_t>(ppVTable[-2]);
+
+	int nStatus = 0;
+	char* pDemangled = abi::__cxa_demangle(info.m_sDecoratedName.c_str(), nullptr, nullptr, &nStatus);
+
+	info.m_sName = (pDemangled && !nStatus) ? pDemangled : info.m_sDecoratedName;
+
+	std::free(pDemangled);
+#endif
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the class of the vtable
+// Output : const ClassInfo_t* (nullptr if it has no readable RTTI)
+//-----------------------------------------------------------------------------
+const ClassInfo_t* CVirtualTable::GetClassInfo() const
+{
+	if (!m_pVTFs)
+		return nullptr;
+
+	// The records are never freed, so the last hit of the thread needs no guard.
+	thread_local std::uintptr_t s_pLastVTable = 0;
+	thread_local const ClassInfo_t* s_pLastInfo = nullptr;
+
+	const auto pVTable = static_cast<std::uintptr_t>(m_diff);
+
+	if (pVTable == s_pLastVTable)
+		return s_pLastInfo;
+
+	auto& cache = GetClassInfoCache();
+
+	// A vtable without readable RTTI is cached as a record with no type info.
+	auto funcResult = [](const ClassInfo_t* pInfo) { return pInfo->m_pTypeInfo ? pInfo : nullptr; };
+
+	{
+		CEpoch::CGuard guard; // The table may be outgrown meanwhile.
+
+		if (const ClassInfo_t* pInfo = cache.Find(pVTable))
+		{
+			s_pLastVTable = pVTable;
+
+			return s_pLastInfo = funcResult(pInfo);
+		}
+	}
+
+	// The misses are serialized, so a published record is never replaced (and freed).
+	static std::mutex s_mutex;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (const ClassInfo_t* pInfo = cache.Find(pVTable))
+		return funcResult(pInfo);
+
+	auto pInfo = std::make_unique<ClassInfo_t>();
+
+	if (!ReadClassInfo(m_pVTFs, *pInfo))
+		*pInfo = ClassInfo_t {};
+
+	return funcResult(cache.Update(pVTable, [&pInfo](const ClassInfo_t*) { return std::move(pInfo); }));
+}
@@ -0,0 +1,223 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/vthook.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <emmintrin.h>
+#include <mutex>
+#include <type_traits>
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#	undef WIN32_LEAN_AND_MEAN
+#else
+#	include <csignal>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#	ifdef __APPLE__
+#		include <sys/ucontext.h>
+#	else
+#		include <sys/syscall.h>
+#		include <ucontext.h>
+#	endif
+#endif
+
+using namespace DynLibUtils;
+
+static constexpr std::uint8_t s_nBreakpoint = 0xCC; // int3
+static constexpr std::size_t s_nMaxSites = 4096;
+
+// The sites ever patched through a breakpoint (append-only, the first ones): a thread which hit the
+// breakpoint of one may only get to its trap handler once the patch is complete.
+static std::atomic<std::uintptr_t> s_aSites[s_nMaxSites];
+static std::atomic<std::size_t> s_nSites {0};
+
+static std::atomic<std::uintptr_t> s_pPublishing {0}; // The site whose patch is being written.
+static std::mutex s_mutex; // Serializes the publications.
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks that a trap comes from the breakpoint of a patch, waiting for
+//          the patch to be complete (async-signal-safe)
+// Input  : pSite - address of the int3
+// Output : bool (the thread must resume at pSite)
+//-----------------------------------------------------------------------------
+static bool ShouldResumeAt(std::uintptr_t pSite) noexcept
+{
+	const std::size_t nSites = s_nSites.load(std::memory_order_acquire);
+
+	if (s_pPublishing.load(std::memory_order_acquire) != pSite && std::none_of(s_aSites, s_aSites + nSites, [pSite](const std::atomic<std::uintptr_t>& site) { return site.load(std::memory_order_relaxed) == pSite; }))
+		return false;
+
+	while (s_pPublishing.load(std::memory_order_acquire) == pSite)
+		_mm_pause();
+
+	// A breakpoint which is still there is not one of a patch.
+	return *reinterpret_cast<const volatile std::uint8_t*>(pSite) != s_nBreakpoint;
+}
+
+#ifdef _WIN32
+static LONG CALLBACK OnBreakpoint(EXCEPTION_POINTERS* pInfo)
+{
+	if (pInfo->ExceptionRecord->ExceptionCode != EXCEPTION_BREAKPOINT)
+		return EXCEPTION_CONTINUE_SEARCH;
+
+	const auto pSite = reinterpret_cast<std::uintptr_t>(pInfo->ExceptionRecord->ExceptionAddress);
+
+	if (!ShouldResumeAt(pSite))
+		return EXCEPTION_CONTINUE_SEARCH;
+
+	pInfo->ContextRecord->Rip = pSite;
+
+	return EXCEPTION_CONTINUE_EXECUTION;
+}
+
+static bool InstallBreakpointHandler()
+{
+	return AddVectoredExceptionHandler(1, &OnBreakpoint) != nullptr;
+}
+
+// Makes every thread of the process see the code written before (interrupts the cores which run them).
+static void SynchronizeCores()
+{
+	FlushProcessWriteBuffers();
+}
+#else
+static struct sigaction s_previousAction;
+
+static void OnBreakpoint(int nSignal, siginfo_t* pInfo, void* pContext)
+{
+	auto* pUserContext = static_cast<ucontext_t*>(pContext);
+
+#	ifdef __APPLE__
+	auto& rip = pUserContext->uc_mcontext->__ss.__rip;
+#	else
+	auto& rip = pUserContext->uc_mcontext.gregs[REG_RIP];
+#	endif
+
+	const auto pSite = static_cast<std::uintptr_t>(rip) - 1; // RIP is past the int3.
+
+	if (ShouldResumeAt(pSite))
+	{
+		rip = static_cast<std::remove_reference_t<decltype(rip)>>(pSite);
+
+		return;
+	}
+
+	// Not ours.
+	if (s_previousAction.sa_flags & SA_SIGINFO)
+	{
+		s_previousAction.sa_sigaction(nSignal, pInfo, pContext);
+	}
+	else if (s_previousAction.sa_handler == SIG_DFL)
+	{
+		signal(nSignal, SIG_DFL);
+		raise(nSignal); // Delivered on return.
+	}
+	else if (s_previousAction.sa_handler != SIG_IGN)
+	{
+		s_previousAction.sa_handler(nSignal);
+	}
+}
+
+static bool InstallBreakpointHandler()
+{
+	struct sigaction action {};
+
+	action.sa_sigaction = &OnBreakpoint;
+	action.sa_flags = SA_SIGINFO | SA_RESTART | SA_ONSTACK;
+	sigemptyset(&action.sa_mask);
+
+	return !sigaction(SIGTRAP, &action, &s_previousAction);
+}
+
+// Makes every thread of the process see the code written before (interrupts the cores which run them).
+static void SynchronizeCores()
+{
+#	ifdef __linux__
+	constexpr int nSyncCore = 1 << 5, nRegisterSyncCore = 1 << 6; // MEMBARRIER_CMD_[REGISTER_]PRIVATE_EXPEDITED_SYNC_CORE (Linux 4.16).
+
+	static const bool s_bMembarrier = !syscall(__NR_membarrier, nRegisterSyncCore, 0, 0);
+
+	if (s_bMembarrier && !syscall(__NR_membarrier, nSyncCore, 0, 0))
+		return;
+#	endif
+
+	// Otherwise, revoking the access to a touched page shoots down its TLB entry on every core which
+	// runs the process, with an interrupt which serializes them.
+	const std::size_t nPageSize = GetPageSize();
+
+	static void* s_pPage = mmap(nullptr, nPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (s_pPage == MAP_FAILED)
+		return;
+
+	mprotect(s_pPage, nPageSize, PROT_READ | PROT_WRITE);
+	*static_cast<volatile std::uint8_t*>(s_pPage) = 0;
+	mprotect(s_pPage, nPageSize, PROT_NONE);
+}
+#endif
+
+bool DynLibUtils::IsBreakpointPatchingAvailable()
+{
+	static const bool s_bHandler = InstallBreakpointHandler();
+
+	return s_bHandler;
+}
+
+static void RegisterSite(std::uintptr_t pSite) noexcept
+{
+	const std::size_t nSites = s_nSites.load(std::memory_order_relaxed);
+
+	if (nSites >= s_nMaxSites || std::any_of(s_aSites, s_aSites + nSites, [pSite](const std::atomic<std::uintptr_t>& site) { return site.load(std::memory_order_relaxed) == pSite; }))
+		return;
+
+	s_aSites[nSites].store(pSite, std::memory_order_relaxed);
+	s_nSites.store(nSites + 1, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Writes a patch which does not fit into an aligned word into running
+//          code: its first byte becomes an int3 while the others are written
+// Input  : pTarget
+//          pBytes
+//          nLength
+//-----------------------------------------------------------------------------
+void DynLibUtils::WriteCodeBytesThroughBreakpoint(void* pTarget, const std::uint8_t* pBytes, std::size_t nLength)
+{
+	auto* pCode = static_cast<volatile std::uint8_t*>(pTarget);
+	const auto pSite = reinterpret_cast<std::uintptr_t>(pTarget);
+
+	const bool bHandler = IsBreakpointPatchingAvailable();
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (!bHandler)
+	{
+		std::memcpy(pTarget, pBytes, nLength);
+
+		return;
+	}
+
+	RegisterSite(pSite);
+	s_pPublishing.store(pSite, std::memory_order_seq_cst);
+
+	*pCode = s_nBreakpoint;
+	SynchronizeCores();
+
+	for (std::size_t n = 1; n < nLength; ++n)
+		pCode[n] = pBytes[n];
+
+	SynchronizeCores();
+
+	*pCode = pBytes[0];
+
+	SynchronizeCores();
+	s_pPublishing.store(0, std::memory_order_release);
+}
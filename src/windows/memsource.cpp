@@ -0,0 +1,184 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/memsource.hpp>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <tlhelp32.h>
+#undef WIN32_LEAN_AND_MEAN
+
+using namespace DynLibUtils;
+
+static std::uint8_t GetProtectionFlags(DWORD nProtect) noexcept
+{
+	if (nProtect & (PAGE_GUARD | PAGE_NOACCESS))
+		return 0;
+
+	switch (nProtect & 0xFF)
+	{
+		case PAGE_READONLY:          return Region_t::Readable;
+		case PAGE_READWRITE:
+		case PAGE_WRITECOPY:         return Region_t::Readable | Region_t::Writable;
+		case PAGE_EXECUTE:           return Region_t::Executable;
+		case PAGE_EXECUTE_READ:      return Region_t::Readable | Region_t::Executable;
+		case PAGE_EXECUTE_READWRITE:
+		case PAGE_EXECUTE_WRITECOPY: return Region_t::Readable | Region_t::Writable | Region_t::Executable;
+		default:                     return 0;
+	}
+}
+
+ProcessId_t CMemorySource::GetCurrentPid() noexcept
+{
+	return GetCurrentProcessId();
+}
+
+bool CMemorySource::Open()
+{
+	HANDLE hProcess = m_bLocal ? GetCurrentProcess() : OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, m_nPid);
+
+	m_hProcess = reinterpret_cast<std::uintptr_t>(hProcess);
+
+	return hProcess != nullptr;
+}
+
+void CMemorySource::Close() noexcept
+{
+	if (!m_bLocal && m_hProcess)
+		CloseHandle(reinterpret_cast<HANDLE>(m_hProcess));
+
+	m_hProcess = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Reads memory of another process with ReadProcessMemory
+// Input  : pAddress
+//          pBuffer
+//          nSize
+// Output : std::size_t (the number of bytes read, up to the first unreadable piece)
+//-----------------------------------------------------------------------------
+std::size_t CMemorySource::ReadRemote(std::uintptr_t pAddress, void* pBuffer, std::size_t nSize) const
+{
+	const auto hProcess = reinterpret_cast<HANDLE>(m_hProcess);
+
+	SIZE_T nRead = 0;
+
+	if (ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(pAddress), pBuffer, nSize, &nRead))
+		return nRead;
+
+	// A partial copy reports no count: the pieces are read up to the first one which fails.
+	std::size_t nDone = 0;
+
+	for (std::uintptr_t p = pAddress, pEnd = pAddress + nSize; p < pEnd; )
+	{
+		const std::uintptr_t pNext = std::min((p & ~(sm_nPieceSize - 1)) + sm_nPieceSize, pEnd);
+
+		if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(p), static_cast<std::uint8_t*>(pBuffer) + nDone, pNext - p, &nRead) || nRead != pNext - p)
+			break;
+
+		nDone += pNext - p;
+		p = pNext;
+	}
+
+	return nDone;
+}
+
+std::size_t CMemorySource::ReadBatchRemote(ReadRequest_t* pRequests, std::size_t nCount) const
+{
+	std::size_t nFull = 0;
+
+	for (std::size_t n = 0; n < nCount; ++n)
+	{
+		ReadRequest_t& request = pRequests[n];
+
+		request.m_nRead = request.m_nSize ? ReadRemote(request.m_pAddress, request.m_pBuffer, request.m_nSize) : 0;
+		nFull += request.m_nRead == request.m_nSize;
+	}
+
+	return nFull;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Walks the committed regions of the process with VirtualQueryEx
+// Input  : vecRegions - receives them, sorted by address
+// Output : false if the process can't be queried
+//-----------------------------------------------------------------------------
+bool CMemorySource::GetRegions(std::vector<Region_t>& vecRegions) const
+{
+	if (!m_bValid)
+		return false;
+
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+
+	auto pAddress = reinterpret_cast<std::uintptr_t>(info.lpMinimumApplicationAddress);
+	const auto pMaxAddress = reinterpret_cast<std::uintptr_t>(info.lpMaximumApplicationAddress);
+
+	MEMORY_BASIC_INFORMATION mbi;
+
+	while (pAddress < pMaxAddress && VirtualQueryEx(reinterpret_cast<HANDLE>(m_hProcess), reinterpret_cast<LPCVOID>(pAddress), &mbi, sizeof(mbi)))
+	{
+		const auto pBegin = reinterpret_cast<std::uintptr_t>(mbi.BaseAddress);
+		const std::uintptr_t pEnd = pBegin + mbi.RegionSize;
+
+		if (mbi.State == MEM_COMMIT)
+			vecRegions.push_back({pBegin, pEnd, GetProtectionFlags(mbi.Protect)});
+
+		if (pEnd <= pAddress)
+			break;
+
+		pAddress = pEnd;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the regions of the process within the image of a module
+// Input  : svModuleName - the file name or the path
+//          vecRegions - receives them, sorted by address
+// Output : false if the module is not loaded
+//-----------------------------------------------------------------------------
+bool CMemorySource::GetModuleRegions(const std::string_view svModuleName, std::vector<Region_t>& vecRegions) const
+{
+	HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, m_nPid);
+
+	if (hSnapshot == INVALID_HANDLE_VALUE)
+		return false;
+
+	MODULEENTRY32 entry;
+
+	entry.dwSize = sizeof(entry);
+
+	std::uintptr_t pImage = 0, pImageEnd = 0;
+
+	for (BOOL bEntry = Module32First(hSnapshot, &entry); bEntry; bEntry = Module32Next(hSnapshot, &entry))
+	{
+		if (svModuleName == entry.szModule || svModuleName == entry.szExePath)
+		{
+			pImage = reinterpret_cast<std::uintptr_t>(entry.modBaseAddr);
+			pImageEnd = pImage + entry.modBaseSize;
+
+			break;
+		}
+	}
+
+	CloseHandle(hSnapshot);
+
+	std::vector<Region_t> vecAll;
+
+	if (!pImage || !GetRegions(vecAll))
+		return false;
+
+	const std::size_t nPrevious = vecRegions.size();
+
+	for (const auto& region : vecAll)
+	{
+		if (pImage <= region.m_pBegin && region.m_pEnd <= pImageEnd)
+			vecRegions.push_back(region);
+	}
+
+	return vecRegions.size() > nPrevious;
+}
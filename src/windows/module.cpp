@@ -10,6 +10,7 @@
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <tlhelp32.h>
 #undef WIN32_LEAN_AND_MEAN
 
 namespace DynLibUtils {
@@ -123,7 +124,19 @@ bool CModule::LoadFromPath(const std::string_view svModelePath, int flags)
 	for (WORD i = 0; i < pNTHeaders->FileHeader.NumberOfSections; ++i) // Loop through the sections.
 	{
 		const IMAGE_SECTION_HEADER& hCurrentSection = hSection[i]; // Get current section.
-		m_vecSections.emplace_back(static_cast<std::uintptr_t>(reinterpret_cast<std::uintptr_t>(handle) + hCurrentSection.VirtualAddress), hCurrentSection.SizeOfRawData, reinterpret_cast<const char*>(hCurrentSection.Name)); // Push back a struct with the section data.
+
+		std::uint8_t nFlags = 0;
+
+		if (hCurrentSection.Characteristics & IMAGE_SCN_MEM_READ)
+			nFlags |= Section_t::Readable;
+
+		if (hCurrentSection.Characteristics & IMAGE_SCN_MEM_WRITE)
+			nFlags |= Section_t::Writable;
+
+		if (hCurrentSection.Characteristics & IMAGE_SCN_MEM_EXECUTE)
+			nFlags |= Section_t::Executable;
+
+		m_vecSections.emplace_back(static_cast<std::uintptr_t>(reinterpret_cast<std::uintptr_t>(handle) + hCurrentSection.VirtualAddress), hCurrentSection.SizeOfRawData, reinterpret_cast<const char*>(hCurrentSection.Name), nFlags); // Push back a struct with the section data.
 	}
 
 	SetPtr(static_cast<void *>(handle));
@@ -132,6 +145,20 @@ bool CModule::LoadFromPath(const std::string_view svModelePath, int flags)
 	m_pExecutableSection = GetSectionByName(".text");
 	assert(m_pExecutableSection != nullptr);
 
+	// Function ranges of the exception directory (.pdata), sorted by the linker.
+	const IMAGE_DATA_DIRECTORY& exceptionDirectory = pNTHeaders->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXCEPTION];
+
+	if (exceptionDirectory.VirtualAddress && exceptionDirectory.Size)
+	{
+		const auto* pFunctions = reinterpret_cast<const IMAGE_RUNTIME_FUNCTION_ENTRY*>(reinterpret_cast<std::uintptr_t>(handle) + exceptionDirectory.VirtualAddress);
+		const std::size_t nCount = exceptionDirectory.Size / sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY);
+
+		m_vecFunctions.reserve(nCount);
+
+		for (std::size_t n = 0; n < nCount; ++n)
+			m_vecFunctions.push_back({pFunctions[n].BeginAddress, pFunctions[n].EndAddress});
+	}
+
 	return true;
 }
 
@@ -190,6 +217,93 @@ CMemory CModule::GetFunctionByName(const std::string_view svFunctionName) const
 	return CMemory((IsValid() && !svFunctionName.empty()) ? GetProcAddress(static_cast<HMODULE>(GetPtr()), svFunctionName.data()) : nullptr);
 }
 
+//-----------------------------------------------------------------------------
+// Purpose: Collects the IAT slots of a loaded image imported by name
+// Input  : hModule
+//          svSymbolName - symbol to filter by (all if empty)
+//          vecImports
+//-----------------------------------------------------------------------------
+static void CollectImports(HMODULE hModule, const std::string_view svSymbolName, std::vector<Import_t>& vecImports)
+{
+	auto* pBase = reinterpret_cast<std::uint8_t*>(hModule);
+	auto* pDOSHeader = reinterpret_cast<IMAGE_DOS_HEADER*>(pBase);
+	auto* pNTHeaders = reinterpret_cast<IMAGE_NT_HEADERS*>(pBase + pDOSHeader->e_lfanew);
+
+	const IMAGE_DATA_DIRECTORY& directory = pNTHeaders->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+
+	if (!directory.VirtualAddress || !directory.Size)
+		return;
+
+	for (auto* pDescriptor = reinterpret_cast<IMAGE_IMPORT_DESCRIPTOR*>(pBase + directory.VirtualAddress); pDescriptor->Name; ++pDescriptor)
+	{
+		// Without the lookup table (bound old-style imports) the names are lost.
+		if (!pDescriptor->OriginalFirstThunk)
+			continue;
+
+		auto* pLookup = reinterpret_cast<IMAGE_THUNK_DATA*>(pBase + pDescriptor->OriginalFirstThunk);
+		auto* pAddress = reinterpret_cast<IMAGE_THUNK_DATA*>(pBase + pDescriptor->FirstThunk);
+
+		for (; pLookup->u1.AddressOfData; ++pLookup, ++pAddress)
+		{
+			if (IMAGE_SNAP_BY_ORDINAL(pLookup->u1.Ordinal))
+				continue;
+
+			auto* pImportByName = reinterpret_cast<IMAGE_IMPORT_BY_NAME*>(pBase + pLookup->u1.AddressOfData);
+			const std::string_view svName(reinterpret_cast<const char*>(pImportByName->Name));
+
+			if (!svSymbolName.empty() && svName != svSymbolName)
+				continue;
+
+			Import_t& entry = vecImports.emplace_back();
+
+			entry.m_svName = svName;
+			entry.m_pSlot = &pAddress->u1.Function;
+			entry.m_pTarget = pAddress->u1.Function;
+			entry.m_bWritable = false; // The loader makes the IAT read-only once bound.
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the imports of the module
+// Input  : svSymbolName - symbol to filter by (all if empty)
+// Output : std::vector<Import_t>
+//-----------------------------------------------------------------------------
+std::vector<Import_t> CModule::GetImports(const std::string_view svSymbolName) const
+{
+	std::vector<Import_t> vecImports;
+
+	if (IsValid())
+		CollectImports(RCast<HMODULE>(), svSymbolName, vecImports);
+
+	return vecImports;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the imports of a symbol by every loaded module
+// Input  : svSymbolName
+// Output : std::vector<Import_t>
+//-----------------------------------------------------------------------------
+std::vector<Import_t> CModule::GetLoadedImports(const std::string_view svSymbolName)
+{
+	std::vector<Import_t> vecImports;
+
+	HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, GetCurrentProcessId());
+
+	if (hSnapshot == INVALID_HANDLE_VALUE)
+		return vecImports;
+
+	MODULEENTRY32 entry {};
+	entry.dwSize = sizeof(entry);
+
+	for (BOOL bFound = Module32First(hSnapshot, &entry); bFound; bFound = Module32Next(hSnapshot, &entry))
+		CollectImports(entry.hModule, svSymbolName, vecImports);
+
+	CloseHandle(hSnapshot);
+
+	return vecImports;
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: Returns the module base
 //-----------------------------------------------------------------------------
@@ -0,0 +1,109 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/regions.hpp>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#undef WIN32_LEAN_AND_MEAN
+
+using namespace DynLibUtils;
+
+static std::uint8_t GetProtectionFlags(DWORD nProtect) noexcept
+{
+	if (nProtect & (PAGE_GUARD | PAGE_NOACCESS))
+		return 0;
+
+	switch (nProtect & 0xFF)
+	{
+		case PAGE_READONLY:          return Region_t::Readable;
+		case PAGE_READWRITE:
+		case PAGE_WRITECOPY:         return Region_t::Readable | Region_t::Writable;
+		case PAGE_EXECUTE:           return Region_t::Executable;
+		case PAGE_EXECUTE_READ:      return Region_t::Readable | Region_t::Executable;
+		case PAGE_EXECUTE_READWRITE:
+		case PAGE_EXECUTE_WRITECOPY: return Region_t::Readable | Region_t::Writable | Region_t::Executable;
+		default:                     return 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Walks the committed regions with VirtualQuery
+// Input  : vecRegions - receives them, sorted by address
+// Output : true
+//-----------------------------------------------------------------------------
+bool CRegionMap::Collect(std::vector<Region_t>& vecRegions)
+{
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+
+	auto pAddress = reinterpret_cast<std::uintptr_t>(info.lpMinimumApplicationAddress);
+	const auto pMaxAddress = reinterpret_cast<std::uintptr_t>(info.lpMaximumApplicationAddress);
+
+	MEMORY_BASIC_INFORMATION mbi;
+
+	while (pAddress < pMaxAddress && VirtualQuery(reinterpret_cast<LPCVOID>(pAddress), &mbi, sizeof(mbi)))
+	{
+		const auto pBegin = reinterpret_cast<std::uintptr_t>(mbi.BaseAddress);
+		const std::uintptr_t pEnd = pBegin + mbi.RegionSize;
+
+		if (mbi.State == MEM_COMMIT)
+			vecRegions.push_back({pBegin, pEnd, GetProtectionFlags(mbi.Protect)});
+
+		if (pEnd <= pAddress)
+			break;
+
+		pAddress = pEnd;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Checks the access of a range with VirtualQuery
+// Input  : pAddress
+//          nSize
+//          nFlags
+//          bAccess - receives the result
+// Output : true
+//-----------------------------------------------------------------------------
+bool CRegionMap::Probe(std::uintptr_t pAddress, std::size_t nSize, std::uint8_t nFlags, bool& bAccess)
+{
+	const std::uintptr_t pEnd = pAddress + (nSize ? nSize : 1);
+
+	bAccess = pAddress < pEnd;
+
+	MEMORY_BASIC_INFORMATION mbi;
+
+	for (std::uintptr_t p = pAddress; bAccess && p < pEnd; p = reinterpret_cast<std::uintptr_t>(mbi.BaseAddress) + mbi.RegionSize)
+	{
+		bAccess = VirtualQuery(reinterpret_cast<LPCVOID>(p), &mbi, sizeof(mbi)) && mbi.State == MEM_COMMIT && (GetProtectionFlags(mbi.Protect) & nFlags) == nFlags;
+	}
+
+	return true;
+}
+
+// LdrRegisterDllNotification (ntdll).
+typedef VOID (CALLBACK *LdrDllNotificationFunc_t)(ULONG nReason, const void* pData, PVOID pContext);
+typedef LONG (NTAPI *LdrRegisterDllNotificationFunc_t)(ULONG nFlags, LdrDllNotificationFunc_t pfnNotification, PVOID pContext, PVOID* ppCookie);
+
+static std::atomic<std::uint64_t> s_nModuleGeneration {0};
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the number of module loads and unloads (since the first call)
+// Output : std::uint64_t
+//-----------------------------------------------------------------------------
+std::uint64_t CRegionMap::GetModuleGeneration()
+{
+	[[maybe_unused]] static const bool s_bRegistered = []()
+	{
+		auto pfnRegister = reinterpret_cast<LdrRegisterDllNotificationFunc_t>(GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "LdrRegisterDllNotification"));
+		PVOID pCookie;
+
+		return pfnRegister && pfnRegister(0, [](ULONG, const void*, PVOID) { s_nModuleGeneration.fetch_add(1, std::memory_order_relaxed); }, nullptr, &pCookie) >= 0;
+	}();
+
+	return s_nModuleGeneration.load(std::memory_order_relaxed); // Unknown without the notification: only the misses refresh the map.
+}
@@ -0,0 +1,284 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/xref.hpp>
+#include <dynlibutils/decoder.hpp>
+#include <dynlibutils/module.hpp>
+
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#	include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DynLibUtils;
+
+// Returns the index of the lowest set bit (nMask must not be 0).
+static inline int CountTrailingZeros(unsigned int nMask) noexcept
+{
+#ifdef _MSC_VER
+	unsigned long nIndex;
+
+	_BitScanForward(&nIndex, nMask);
+
+	return static_cast<int>(nIndex);
+#else
+	return __builtin_ctz(nMask);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Finds the `call/jmp rel32` candidates of a code range, whose rel32
+//          lands in [pLow, pHigh)
+// Input  : pBegin
+//          pEnd
+//          pLow
+//          pHigh
+//          vecCandidates - receives the opcode addresses, in ascending order
+//-----------------------------------------------------------------------------
+static void FindBranchCandidates(const std::uintptr_t pBegin, const std::uintptr_t pEnd, const std::uintptr_t pLow, const std::uintptr_t pHigh, std::vector<std::uintptr_t>& vecCandidates)
+{
+	constexpr std::size_t kOpcodeSize = 1 + sizeof(std::int32_t);
+
+	if (pEnd - pBegin < kOpcodeSize)
+		return;
+
+	const std::uintptr_t pLast = pEnd - kOpcodeSize; // The last opcode with a whole rel32.
+
+	auto funcCheck = [&](std::uintptr_t pOpcode)
+	{
+		std::int32_t nRel;
+
+		std::memcpy(&nRel, reinterpret_cast<const void*>(pOpcode + 1), sizeof(nRel));
+
+		const std::uintptr_t pTo = pOpcode + kOpcodeSize + static_cast<std::intptr_t>(nRel);
+
+		if (pLow <= pTo && pTo < pHigh)
+			vecCandidates.push_back(pOpcode);
+	};
+
+	std::uintptr_t p = pBegin;
+
+	// E8 and E9 differ in the lowest bit only.
+	const __m128i vMask = _mm_set1_epi8(static_cast<char>(0xFE));
+	const __m128i vOpcode = _mm_set1_epi8(static_cast<char>(0xE8));
+
+	for (; p + sizeof(__m128i) <= pLast; p += sizeof(__m128i))
+	{
+		const __m128i vBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		for (unsigned int nMask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(vBytes, vMask), vOpcode))); nMask; nMask &= nMask - 1)
+			funcCheck(p + CountTrailingZeros(nMask));
+	}
+
+	for (; p <= pLast; ++p)
+	{
+		if ((*reinterpret_cast<const std::uint8_t*>(p) & 0xFE) == 0xE8)
+			funcCheck(p);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Walks the instruction boundaries of a code range with the decoder
+//          (bytes which can't be decoded are stepped over one by one)
+// Input  : pBegin
+//          pEnd
+//          funcInstruction - called with (address, Instruction_t)
+//-----------------------------------------------------------------------------
+template<typename FUNC>
+static void SweepInstructions(const std::uintptr_t pBegin, const std::uintptr_t pEnd, const FUNC& funcInstruction)
+{
+	constexpr std::size_t kMaxLength = 15;
+
+	Instruction_t instr;
+
+	std::uintptr_t p = pBegin;
+
+	// The decoder may read 15 bytes past an instruction start.
+	for (; p + kMaxLength <= pEnd; )
+	{
+		const std::size_t nLength = DecodeInstruction(reinterpret_cast<const void*>(p), instr);
+
+		if (nLength)
+			funcInstruction(p, instr);
+
+		p += nLength ? nLength : 1;
+	}
+
+	// The tail is decoded from a zero padded copy.
+	std::uint8_t aTail[kMaxLength * 2] {};
+
+	std::memcpy(aTail, reinterpret_cast<const void*>(p), pEnd - p);
+
+	for (std::size_t n = 0, nSize = pEnd - p; n < nSize; )
+	{
+		const std::size_t nLength = DecodeInstruction(&aTail[n], instr);
+
+		if (nLength && n + nLength <= nSize)
+			funcInstruction(p + n, instr);
+
+		n += nLength ? nLength : 1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Builds the index
+// Input  : module
+// Output : std::size_t (the number of cross-references)
+//-----------------------------------------------------------------------------
+std::size_t CXRefIndex::Build(const CModule& module)
+{
+	m_pBase = 0;
+	m_vecBySource.clear();
+	m_vecByTarget.clear();
+
+	std::uintptr_t pLow = UINTPTR_MAX, pHigh = 0, pBase = UINTPTR_MAX, pImageEnd = 0;
+
+	for (const auto& section : module.GetSections())
+	{
+		const auto pSection = static_cast<std::uintptr_t>(section.GetAddr());
+
+		pBase = std::min(pBase, pSection);
+
+		if (section.m_nFlags)
+			pImageEnd = std::max(pImageEnd, pSection + section.m_nSectionSize); // Mapped ones.
+
+		if (!section.IsExecutable())
+			continue;
+
+		pLow = std::min(pLow, pSection);
+		pHigh = std::max(pHigh, pSection + section.m_nSectionSize);
+	}
+
+	if (pLow >= pHigh)
+		return 0;
+
+	m_pBase = pBase;
+
+	std::vector<std::uintptr_t> vecCandidates;
+
+	for (const auto& section : module.GetSections())
+	{
+		if (!section.IsExecutable())
+			continue;
+
+		const auto pBegin = static_cast<std::uintptr_t>(section.GetAddr());
+		const std::uintptr_t pEnd = pBegin + section.m_nSectionSize;
+
+		vecCandidates.clear();
+		FindBranchCandidates(pBegin, pEnd, pLow, pHigh, vecCandidates);
+
+		auto it = vecCandidates.cbegin();
+
+		SweepInstructions(pBegin, pEnd, [&](std::uintptr_t pInstruction, const Instruction_t& instr)
+		{
+			if (instr.IsRipRelative())
+			{
+				const std::uintptr_t pTo = instr.GetTarget(reinterpret_cast<const void*>(pInstruction));
+
+				if (pBase <= pTo && pTo < pImageEnd)
+					m_vecBySource.push_back({static_cast<std::uint32_t>(pInstruction - pBase), static_cast<std::uint32_t>(pTo - pBase), XREF_DATA});
+
+				return;
+			}
+
+			while (it != vecCandidates.cend() && *it < pInstruction)
+				++it; // Inside of a previous instruction.
+
+			if (it == vecCandidates.cend() || *it != pInstruction)
+				return;
+
+			// A prefixed branch does not start at its opcode, so it has no candidate.
+			if (instr.m_nMap != OPCODE_MAP_PRIMARY || instr.m_nLength != 5)
+				return;
+
+			m_vecBySource.push_back({static_cast<std::uint32_t>(pInstruction - pBase), static_cast<std::uint32_t>(instr.GetTarget(reinterpret_cast<const void*>(pInstruction)) - pBase), instr.m_nOpcode == 0xE8 ? XREF_CALL : XREF_JUMP});
+		});
+	}
+
+	// The sections and the sweeps are in ascending order.
+	if (!std::is_sorted(m_vecBySource.cbegin(), m_vecBySource.cend(), [](const Entry_t& left, const Entry_t& right) { return left.m_nFrom < right.m_nFrom; }))
+		std::sort(m_vecBySource.begin(), m_vecBySource.end(), [](const Entry_t& left, const Entry_t& right) { return left.m_nFrom < right.m_nFrom; });
+
+	m_vecByTarget = m_vecBySource;
+	std::stable_sort(m_vecByTarget.begin(), m_vecByTarget.end(), [](const Entry_t& left, const Entry_t& right) { return left.m_nTo < right.m_nTo; });
+
+	return m_vecBySource.size();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the references to an address
+// Input  : pTarget
+// Output : std::vector<XRef_t>
+//-----------------------------------------------------------------------------
+std::vector<XRef_t> CXRefIndex::GetReferencesTo(const CMemory pTarget) const
+{
+	std::vector<XRef_t> vecResult;
+
+	const auto pTo = static_cast<std::uintptr_t>(pTarget.GetAddr());
+
+	if (!IsBuilt() || pTo < m_pBase || pTo - m_pBase > UINT32_MAX)
+		return vecResult;
+
+	const auto nTo = static_cast<std::uint32_t>(pTo - m_pBase);
+
+	auto it = std::lower_bound(m_vecByTarget.cbegin(), m_vecByTarget.cend(), nTo, [](const Entry_t& entry, std::uint32_t nValue) { return entry.m_nTo < nValue; });
+
+	for (; it != m_vecByTarget.cend() && it->m_nTo == nTo; ++it)
+		vecResult.push_back(ToXRef(*it));
+
+	return vecResult;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the references made from an address range
+// Input  : pBegin
+//          pEnd
+// Output : std::vector<XRef_t>
+//-----------------------------------------------------------------------------
+std::vector<XRef_t> CXRefIndex::GetReferencesFrom(const CMemory pBegin, const CMemory pEnd) const
+{
+	std::vector<XRef_t> vecResult;
+
+	if (!IsBuilt())
+		return vecResult;
+
+	const auto pFrom = static_cast<std::uintptr_t>(pBegin.GetAddr()), pTo = static_cast<std::uintptr_t>(pEnd.GetAddr());
+	const auto nFrom = static_cast<std::uint32_t>(std::min<std::uintptr_t>(pFrom - std::min(pFrom, m_pBase), UINT32_MAX));
+	const auto nTo = static_cast<std::uint32_t>(std::min<std::uintptr_t>(pTo - std::min(pTo, m_pBase), UINT32_MAX));
+
+	auto it = std::lower_bound(m_vecBySource.cbegin(), m_vecBySource.cend(), nFrom, [](const Entry_t& entry, std::uint32_t nValue) { return entry.m_nFrom < nValue; });
+
+	for (; it != m_vecBySource.cend() && it->m_nFrom < nTo; ++it)
+		vecResult.push_back(ToXRef(*it));
+
+	return vecResult;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets the source of the only reference of a kind to an address
+// Input  : pTarget
+//          eType
+// Output : CMemory
+//-----------------------------------------------------------------------------
+CMemory CXRefIndex::GetUniqueReference(const CMemory pTarget, XRefType_t eType) const
+{
+	CMemory pResult = DYNLIB_INVALID_MEMORY;
+
+	for (const auto& xref : GetReferencesTo(pTarget))
+	{
+		if (xref.m_eType != eType)
+			continue;
+
+		if (pResult)
+			return DYNLIB_INVALID_MEMORY;
+
+		pResult = xref.m_pFrom;
+	}
+
+	return pResult;
+}
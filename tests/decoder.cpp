@@ -0,0 +1,58 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+#include <dynlibutils/decoder.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+using namespace DynLibUtils;
+
+struct Case_t
+{
+	const char* m_pszName;
+	std::uint8_t m_aBytes[16]; // Followed by zeros, as the immediates.
+	std::size_t m_nLength;
+};
+
+static const Case_t s_aCases[] =
+{
+	{"add eax, imm32",                   {0x05},                     5},
+	{"add ax, imm16",                    {0x66, 0x05},               4},
+	{"add rax, imm32",                   {0x48, 0x05},               6},
+	{"66 REX.W add rax, imm32",          {0x66, 0x48, 0x05},         7},
+	{"add ax, imm16 (81 /0)",            {0x66, 0x81, 0xC0},         5},
+	{"66 REX.W add rax, imm32 (81 /0)",  {0x66, 0x48, 0x81, 0xC0},   8},
+	{"66 REX.W mov rax, imm32 (C7)",     {0x66, 0x48, 0xC7, 0xC0},   8},
+	{"66 REX.W imul rax, rax, imm32",    {0x66, 0x48, 0x69, 0xC0},   8},
+	{"test eax, imm32 (F7 /0)",          {0xF7, 0xC0},               6},
+	{"test ax, imm16 (F7 /0)",           {0x66, 0xF7, 0xC0},         5},
+	{"66 REX.W test rax, imm32",         {0x66, 0x48, 0xF7, 0xC0},   8},
+	{"not rax (F7 /2)",                  {0x48, 0xF7, 0xD0},         3},
+	{"mov rax, imm64",                   {0x48, 0xB8},               10},
+	{"mov ax, imm16",                    {0x66, 0xB8},               4},
+	{"66 REX.W mov rax, imm64",          {0x66, 0x48, 0xB8},         11},
+};
+
+int main()
+{
+	int nFailures = 0;
+
+	for (const auto& test : s_aCases)
+	{
+		Instruction_t instr;
+
+		const std::size_t nLength = DecodeInstruction(test.m_aBytes, instr);
+
+		if (nLength != test.m_nLength)
+		{
+			std::printf("%s: decoded %zu bytes, expected %zu\n", test.m_pszName, nLength, test.m_nLength);
+
+			++nFailures;
+		}
+	}
+
+	return nFailures ? 1 : 0;
+}
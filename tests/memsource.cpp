@@ -0,0 +1,194 @@
+// DynLibUtils
+// Copyright (C) 2023-2025 Vladimir Ezhikov (Wend4r) & Borys Komashchenko (Phoenix)
+// Licensed under the MIT license. See LICENSE file in the project root for details.
+
+// Reads a forked child with CMemorySource: the child keeps the memory of the fork while this
+// process overwrites its own copy, so only the remote reads see the expected bytes.
+
+#include <dynlibutils/memsource.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace DynLibUtils;
+
+static constexpr std::size_t s_nPieceSize = CMemorySource::sm_nPieceSize;
+static constexpr std::size_t s_nDataSize = 1 << 20;      // Followed by an unmapped piece, then another one.
+static constexpr std::size_t s_nScanSize = 32 << 20;     // Scanned to compare the speeds.
+static constexpr std::size_t s_nSignatureOffset = CMemorySource::sm_nWindowSize - 5; // Across the first window boundary.
+
+static const std::uint8_t s_aSignature[] = {0xDE, 0xAD, 0xBE, 0xEF, 0x13, 0x37, 0xC0, 0xDE, 0x42, 0x24, 0x5A, 0xA5};
+
+static int s_nFailures = 0;
+
+#define CHECK(condition) \
+	do { if (!(condition)) { std::printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); ++s_nFailures; } } while (0)
+
+static std::uint8_t GetExpected(std::size_t nOffset) noexcept
+{
+	return static_cast<std::uint8_t>((nOffset * 131) >> 3);
+}
+
+// Returns the best time of a few scans, in milliseconds.
+static double MeasureScan(CMemorySource& source, std::uintptr_t pBegin, std::size_t nSize)
+{
+	double flBest = 0.0;
+
+	for (int nRun = 0; nRun < 3; ++nRun)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		CHECK(!source.FindPattern<sizeof(s_aSignature)>(s_aSignature, "xxxxxxxxxxxx", pBegin, pBegin + nSize).IsValid());
+
+		const double flTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (!nRun || flTime < flBest)
+			flBest = flTime;
+	}
+
+	return flBest;
+}
+
+int main()
+{
+	// A piece-aligned layout: the data, an unmapped piece, a piece of data.
+	const std::size_t nMapSize = s_nDataSize + 3 * s_nPieceSize;
+
+	auto* pMap = static_cast<std::uint8_t*>(mmap(nullptr, nMapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+	if (pMap == MAP_FAILED)
+		return 1;
+
+	auto* pData = reinterpret_cast<std::uint8_t*>((reinterpret_cast<std::uintptr_t>(pMap) + s_nPieceSize - 1) & ~(s_nPieceSize - 1));
+	const auto pBase = reinterpret_cast<std::uintptr_t>(pData);
+	const std::uintptr_t pHole = pBase + s_nDataSize, pAfter = pHole + s_nPieceSize;
+
+	for (std::size_t n = 0; n < s_nDataSize + 2 * s_nPieceSize; ++n)
+	{
+		if (n < s_nDataSize || s_nDataSize + s_nPieceSize <= n)
+			pData[n] = GetExpected(n);
+	}
+
+	std::memcpy(pData + s_nSignatureOffset, s_aSignature, sizeof(s_aSignature));
+	munmap(reinterpret_cast<void*>(pHole), s_nPieceSize);
+
+	auto* pScan = static_cast<std::uint8_t*>(mmap(nullptr, s_nScanSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+	if (pScan == MAP_FAILED)
+		return 1;
+
+	for (std::size_t n = 0; n < s_nScanSize; ++n)
+		pScan[n] = GetExpected(n);
+
+	int aPipe[2];
+
+	if (pipe(aPipe))
+		return 1;
+
+	const pid_t nChild = fork();
+
+	if (nChild < 0)
+		return 1;
+
+	if (!nChild)
+	{
+		// Waits for the parent to close the pipe (or to exit).
+		char c;
+
+		close(aPipe[1]);
+		(void)!read(aPipe[0], &c, 1);
+		_exit(0);
+	}
+
+	close(aPipe[0]);
+
+	// The copy of this process no longer has the expected bytes.
+	std::memset(pData, 0, s_nDataSize);
+	std::memset(reinterpret_cast<void*>(pAfter), 0, s_nPieceSize);
+
+	CMemorySource remote(nChild);
+
+	CHECK(remote.IsValid());
+	CHECK(!remote.IsLocal());
+
+	// Read.
+	{
+		std::uint8_t aBuffer[4096];
+
+		CHECK(remote.Read(pBase + 100, aBuffer, sizeof(aBuffer)) == sizeof(aBuffer));
+
+		bool bSame = true;
+
+		for (std::size_t n = 0; n < sizeof(aBuffer); ++n)
+			bSame &= aBuffer[n] == GetExpected(100 + n);
+
+		CHECK(bSame);
+
+		std::uint32_t nValue = 0;
+
+		CHECK(remote.Read(pBase + s_nSignatureOffset, nValue));
+		CHECK(!std::memcmp(&nValue, s_aSignature, sizeof(nValue)));
+	}
+
+	// A read across the unmapped piece stops at it.
+	{
+		std::uint8_t aBuffer[8192];
+
+		CHECK(remote.Read(pHole - 4096, aBuffer, sizeof(aBuffer)) == 4096);
+		CHECK(aBuffer[4095] == GetExpected(s_nDataSize - 1));
+		CHECK(remote.Read(pHole, aBuffer, 16) == 0);
+	}
+
+	// ReadBatch: the range across the unmapped piece is read up to it, the next ones still are.
+	{
+		std::uint8_t aFirst[64], aCrossing[32], aLast[128];
+
+		CMemorySource::ReadRequest_t aRequests[] =
+		{
+			{pBase, aFirst, sizeof(aFirst), 0},
+			{pHole - 16, aCrossing, sizeof(aCrossing), 0},
+			{pAfter, aLast, sizeof(aLast), 0},
+		};
+
+		CHECK(remote.ReadBatch(aRequests, 3) == 2);
+		CHECK(aRequests[0].m_nRead == sizeof(aFirst) && aFirst[63] == GetExpected(63));
+		CHECK(aRequests[1].m_nRead == 16 && aCrossing[15] == GetExpected(s_nDataSize - 1));
+		CHECK(aRequests[2].m_nRead == sizeof(aLast) && aLast[0] == GetExpected(s_nDataSize + s_nPieceSize));
+	}
+
+	// FindPattern: a match across the boundary of two windows.
+	{
+		const CMemory pFound = remote.FindPattern<sizeof(s_aSignature)>(s_aSignature, "xxxxxxxxxxxx", pBase, pBase + s_nDataSize);
+
+		CHECK(static_cast<std::uintptr_t>(pFound.GetAddr()) == pBase + s_nSignatureOffset);
+
+		std::uint8_t aMasked[sizeof(s_aSignature)];
+
+		std::memcpy(aMasked, s_aSignature, sizeof(aMasked));
+		aMasked[4] = 0;
+
+		CHECK(static_cast<std::uintptr_t>(remote.FindPattern<sizeof(s_aSignature)>(aMasked, "xxxx?xxxxxxx", pBase, pBase + s_nDataSize).GetAddr()) == pBase + s_nSignatureOffset);
+	}
+
+	// The speed of a remote scan against the same scan in process.
+	{
+		CMemorySource local;
+
+		const auto pScanBase = reinterpret_cast<std::uintptr_t>(pScan);
+		const double flLocal = MeasureScan(local, pScanBase, s_nScanSize);
+		const double flRemote = MeasureScan(remote, pScanBase, s_nScanSize);
+
+		std::printf("Scan of %zu MiB: local %.2f ms, remote %.2f ms (%.2fx)\n", s_nScanSize >> 20, flLocal, flRemote, flRemote / flLocal);
+	}
+
+	close(aPipe[1]);
+	waitpid(nChild, nullptr, 0);
+
+	return s_nFailures ? 1 : 0;
+}